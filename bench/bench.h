@@ -0,0 +1,174 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Host Benchmark Utilities
+ *
+ * Shared timing and test-signal helpers for the programs in bench/.
+ * Host-only: not included by deploy.cpp or any pedal.
+ */
+
+#ifndef HOTHOUSE_BENCH_H
+#define HOTHOUSE_BENCH_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+#endif
+
+#define BENCH_SAMPLE_RATE 48000
+#define BENCH_REPEATS 5
+
+// Monotonic wall clock in nanoseconds
+inline double benchNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * CPU timestamp counter (rdtsc). It ticks at the processor's nominal
+ * clock, so it equals core cycles only when the clock is not boosted or
+ * throttled. Without one (BENCH_HAS_CYCLES unset) this returns 0.
+ */
+inline unsigned long long benchCycles() {
+#if defined(BENCH_HAS_CYCLES)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Fill a buffer with a guitar-like test signal: plucked notes with a few
+ * decaying harmonics, re-triggered every half second
+ */
+inline void benchFillGuitar(float* buffer, int numSamples, float sampleRate) {
+    const float notes[4] = {82.41f, 110.0f, 146.83f, 196.0f};
+    int noteLength = (int)(sampleRate * 0.5f);
+    for (int i = 0; i < numSamples; i++) {
+        int note = (i / noteLength) % 4;
+        float t = (float)(i % noteLength) / sampleRate;
+        float f = notes[note];
+        float env = 0.8f * expf(-4.0f * t);
+        float w = 2.0f * 3.14159265f * f * t;
+        buffer[i] = env * (sinf(w) + 0.5f * sinf(2.0f * w) + 0.25f * sinf(3.0f * w)) / 1.75f;
+    }
+}
+
+// Keep the optimizer from discarding benchmark output
+static volatile float benchSink = 0.0f;
+
+inline void benchConsume(const float* buffer, int numSamples) {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; i++) acc += buffer[i];
+    benchSink = acc;
+}
+
+// Aliasing test tone: bin 1031 of 16384 is 3020 Hz at 48 kHz and shares
+// no factor with the frame, so aliases land between the harmonics
+#define BENCH_ALIAS_FFT_SIZE 16384
+#define BENCH_ALIAS_TONE_BIN 1031
+#define BENCH_ALIAS_MASK_BINS 8
+
+inline void benchFillAliasTone(float* buffer, float amplitude) {
+    for (int i = 0; i < BENCH_ALIAS_FFT_SIZE; i++) {
+        buffer[i] = amplitude * (float)sin(6.283185307179586 * BENCH_ALIAS_TONE_BIN * i
+                                           / BENCH_ALIAS_FFT_SIZE);
+    }
+}
+
+// In-place radix-2 FFT
+inline void benchFft(double* re, double* im, int n) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        double angle = -6.283185307179586 / length;
+        for (int i = 0; i < n; i += length) {
+            for (int k = 0; k < length / 2; k++) {
+                double wr = cos(angle * k);
+                double wi = sin(angle * k);
+                int a = i + k;
+                int b = a + length / 2;
+                double xr = re[b] * wr - im[b] * wi;
+                double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+/**
+ * Aliasing in a BENCH_ALIAS_FFT_SIZE frame of a nonlinearity's response
+ * to the alias tone: energy off the tone's harmonics over energy on them,
+ * in dB (Blackman-Harris window)
+ */
+inline double benchAliasingDb(const float* signal) {
+    static double re[BENCH_ALIAS_FFT_SIZE];
+    static double im[BENCH_ALIAS_FFT_SIZE];
+    for (int i = 0; i < BENCH_ALIAS_FFT_SIZE; i++) {
+        double phase = 6.283185307179586 * i / BENCH_ALIAS_FFT_SIZE;
+        double window = 0.35875 - 0.48829 * cos(phase) + 0.14128 * cos(2.0 * phase)
+                        - 0.01168 * cos(3.0 * phase);
+        re[i] = signal[i] * window;
+        im[i] = 0.0;
+    }
+    benchFft(re, im, BENCH_ALIAS_FFT_SIZE);
+
+    double harmonic = 0.0;
+    double other = 0.0;
+    for (int bin = BENCH_ALIAS_MASK_BINS + 1; bin < BENCH_ALIAS_FFT_SIZE / 2; bin++) {
+        double power = re[bin] * re[bin] + im[bin] * im[bin];
+        int nearest = (bin + BENCH_ALIAS_TONE_BIN / 2) / BENCH_ALIAS_TONE_BIN * BENCH_ALIAS_TONE_BIN;
+        if (nearest > 0 && abs(bin - nearest) <= BENCH_ALIAS_MASK_BINS) {
+            harmonic += power;
+        } else {
+            other += power;
+        }
+    }
+    return 10.0 * log10(other / harmonic);
+}
+
+/**
+ * Time render(in, out, n) over the whole input in blockSize chunks
+ * @return Median ns/sample over BENCH_REPEATS runs
+ */
+template <typename Render>
+double benchNsPerSample(Render render, const float* input, float* output,
+                        int numSamples, int blockSize) {
+    double runs[BENCH_REPEATS];
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = benchNowNs();
+        for (int i = 0; i + blockSize <= numSamples; i += blockSize) {
+            render(input + i, output + i, blockSize);
+        }
+        runs[r] = (benchNowNs() - start) / (double)numSamples;
+        benchConsume(output, numSamples);
+    }
+
+    // Insertion sort, then take the median
+    for (int i = 1; i < BENCH_REPEATS; i++) {
+        double v = runs[i];
+        int j = i - 1;
+        while (j >= 0 && runs[j] > v) {
+            runs[j + 1] = runs[j];
+            j--;
+        }
+        runs[j + 1] = v;
+    }
+    return runs[BENCH_REPEATS / 2];
+}
+
+#endif // HOTHOUSE_BENCH_H
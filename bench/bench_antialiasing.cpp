@@ -0,0 +1,142 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Clipper Antialiasing Comparison
+ *
+ *   - closed-form check: the ClipCurve antiderivatives of every drive
+ *     voice against central differences
+ *   - aliasing against CPU for every drive preset (pedal and toggle
+ *     mode) with each ClipStageT choice: plain table, first- and
+ *     second-order ADAA, and 2x/4x/8x oversampling. Aliasing is the energy
+ *     off the harmonics of a 3 kHz tone relative to the energy on them;
+ *     latency is in whole samples
+ *
+ * Gain at 0.6, tone fully open, bass cut / gate off, wet only.
+ * Exits non-zero if an antiderivative disagrees with its curve.
+ */
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/distortion/distortion.cpp"
+#include "pedals/fuzz/fuzz.cpp"
+#include "bench/bench.h"
+
+#define ANTIDERIVATIVE_STEP 1.0e-4
+#define ANTIDERIVATIVE_TOLERANCE 1.0e-6
+#define ANTIALIASING_BLOCK 32
+
+struct NamedCurve {
+    const char* name;
+    ClipCurve curve;
+};
+
+// Worst |F1' - f| and |F2' - F1| over [-4, 4]
+static double antiderivativeError(const ClipCurve& curve) {
+    const double h = ANTIDERIVATIVE_STEP;
+    double worst = 0.0;
+    for (int i = 0; i <= 80000; i++) {
+        double x = -4.0 + 8.0 * i / 80000.0;
+        double slope2 = (curve.antiderivative2(x + h) - curve.antiderivative2(x - h)) / (2.0 * h);
+        double error = fabs(slope2 - curve.antiderivative1(x));
+        // f may jump at a knee; F1 is continuous there
+        if (curve.region(x - h) == curve.region(x + h)) {
+            double slope1 = (curve.antiderivative1(x + h) - curve.antiderivative1(x - h)) / (2.0 * h);
+            double error1 = fabs(slope1 - curve.evaluate(x));
+            if (error1 > error) error = error1;
+        }
+        if (error > worst) worst = error;
+    }
+    return worst;
+}
+
+template <typename Pedal>
+struct PedalRender {
+    Pedal* pedal;
+    void operator()(const float* in, float* out, int n) {
+        pedal->processBlock(in, out, n);
+    }
+};
+
+template <template <typename, int> class Pedal, int Antialiasing>
+static void reportMethod(const char* method, ToggleswitchPosition mode, const float* tone,
+                         const float* guitar, float* output, int numSamples) {
+    typedef Pedal<float, Antialiasing> Effect;
+    static Effect pedal(BENCH_SAMPLE_RATE);
+    HothouseControls controls;
+    for (int k = 0; k < KNOB_COUNT; k++) controls.knobs[k] = 0.5f;
+    controls.knobs[KNOB_1] = 0.6f;
+    controls.knobs[KNOB_2] = 1.0f;
+    controls.knobs[KNOB_3] = 0.0f;
+    controls.knobs[KNOB_6] = 1.0f;
+    controls.toggles[TOGGLESWITCH_1] = mode;
+    pedal.reset();
+    pedal.updateFromControls(controls);
+
+    // Settle the smoothers and filters, then analyse one FFT frame
+    for (int pass = 0; pass < 3; pass++) {
+        for (int i = 0; i < BENCH_ALIAS_FFT_SIZE; i += ANTIALIASING_BLOCK) {
+            pedal.processBlock(tone + i, output + i, ANTIALIASING_BLOCK);
+        }
+    }
+    double aliasing = benchAliasingDb(output);
+
+    PedalRender<Effect> render = {&pedal};
+    double ns = benchNsPerSample(render, guitar, output, numSamples, ANTIALIASING_BLOCK);
+    printf("%-20s %-8s %12.1f %12.2f %9d\n", "", method, aliasing, ns,
+           (int)ClipStageT<float, Antialiasing>::LATENCY);
+}
+
+template <template <typename, int> class Pedal>
+static void reportPreset(const char* name, ToggleswitchPosition mode, const float* tone,
+                         const float* guitar, float* output, int numSamples) {
+    printf("%s\n", name);
+    reportMethod<Pedal, 1>("plain", mode, tone, guitar, output, numSamples);
+    reportMethod<Pedal, ADAA_FIRST_ORDER>("adaa1", mode, tone, guitar, output, numSamples);
+    reportMethod<Pedal, ADAA_SECOND_ORDER>("adaa2", mode, tone, guitar, output, numSamples);
+    reportMethod<Pedal, 2>("2x", mode, tone, guitar, output, numSamples);
+    reportMethod<Pedal, 4>("4x", mode, tone, guitar, output, numSamples);
+    reportMethod<Pedal, 8>("8x", mode, tone, guitar, output, numSamples);
+}
+
+int main() {
+    const NamedCurve curves[] = {
+        {"overdrive", ClipCurve::soft(1.0f, 1.0f, 0.76159f)},
+        {"distortion hard", ClipCurve::hard(0.7f)},
+        {"distortion medium", ClipCurve::soft(0.8f, 0.85f, ClipCurve::tanhApprox(0.85f * 0.8f))},
+        {"distortion soft", ClipCurve::soft(0.5f, 2.0f, 0.76159f)},
+        {"fuzz vintage", ClipCurve::asymmetric(0.5f, 0.1f, -0.6f, 0.15f)},
+        {"fuzz modern", ClipCurve::hard(0.4f)},
+        {"fuzz octave", ClipCurve::asymmetric(0.5f, 0.5f, -0.5f, 0.5f)},
+    };
+    const int curveCount = (int)(sizeof(curves) / sizeof(curves[0]));
+
+    bool ok = true;
+    printf("%-20s %22s\n", "curve", "antiderivative error");
+    for (int c = 0; c < curveCount; c++) {
+        double error = antiderivativeError(curves[c].curve);
+        if (error > ANTIDERIVATIVE_TOLERANCE) ok = false;
+        printf("%-20s %22.2e\n", curves[c].name, error);
+    }
+
+    const int numSamples = BENCH_SAMPLE_RATE * 4;
+    float* guitar = new float[numSamples];
+    float* output = new float[numSamples];
+    float* tone = new float[BENCH_ALIAS_FFT_SIZE];
+    benchFillGuitar(guitar, numSamples, (float)BENCH_SAMPLE_RATE);
+    benchFillAliasTone(tone, 0.5f);
+
+    printf("\n%-20s %-8s %12s %12s %9s\n", "preset", "method", "alias (dB)", "ns/sample", "latency");
+    reportPreset<OverdriveT>("overdrive", TOGGLESWITCH_MIDDLE, tone, guitar, output, numSamples);
+    reportPreset<DistortionT>("distortion hard", TOGGLESWITCH_UP, tone, guitar, output, numSamples);
+    reportPreset<DistortionT>("distortion medium", TOGGLESWITCH_MIDDLE, tone, guitar, output, numSamples);
+    reportPreset<DistortionT>("distortion soft", TOGGLESWITCH_DOWN, tone, guitar, output, numSamples);
+    reportPreset<FuzzT>("fuzz vintage", TOGGLESWITCH_UP, tone, guitar, output, numSamples);
+    reportPreset<FuzzT>("fuzz modern", TOGGLESWITCH_MIDDLE, tone, guitar, output, numSamples);
+    reportPreset<FuzzT>("fuzz octave", TOGGLESWITCH_DOWN, tone, guitar, output, numSamples);
+
+    delete[] guitar;
+    delete[] output;
+    delete[] tone;
+
+    printf("\nantiderivatives: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
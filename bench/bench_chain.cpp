@@ -0,0 +1,69 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Chain Benchmark
+ *
+ * Compares a Compressor -> Overdrive -> Delay rig built two ways:
+ *   - dynamic:    EffectChain, one virtual processBlock() per stage
+ *   - static:     StaticChain, every stage's control-rate and audio-rate
+ *                 bodies run back to back per control block, no vtable
+ * and checks that both render the same samples.
+ */
+
+#include "hothouse.h"
+#include "pedals/compressor/compressor.cpp"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/delay/delay.cpp"
+#include "bench/bench.h"
+
+typedef StaticChain<Compressor, Overdrive, Delay> Rig;
+
+// Large effects live in static storage, as they would on the device
+static Compressor compressor(BENCH_SAMPLE_RATE);
+static Overdrive overdrive(BENCH_SAMPLE_RATE);
+static Delay delay(BENCH_SAMPLE_RATE);
+static Rig rig(BENCH_SAMPLE_RATE);
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+
+    HothouseEffect* stages[] = {&compressor, &overdrive, &delay};
+    EffectChain chain(stages, 3);
+
+    HothouseControls controls;
+    chain.updateFromControls(controls);
+    rig.updateFromControls(controls);
+
+    // Same stages, same control schedule: identical output
+    float* reference = new float[numSamples];
+    for (int i = 0; i < numSamples; i += 32) chain.processBlock(input + i, reference + i, 32);
+    for (int i = 0; i < numSamples; i += 32) rig.processBlock(input + i, output + i, 32);
+    int mismatches = 0;
+    for (int i = 0; i < numSamples; i++) mismatches += output[i] != reference[i];
+    delete[] reference;
+
+    const int blockSizes[] = {4, 1024};
+    printf("%-10s %8s %12s\n", "chain", "block", "ns/sample");
+    for (int b = 0; b < 2; b++) {
+        int blockSize = blockSizes[b];
+
+        double dynamicNs = benchNsPerSample(
+            [&](const float* in, float* out, int n) { chain.processBlock(in, out, n); },
+            input, output, numSamples, blockSize);
+        double staticNs = benchNsPerSample(
+            [&](const float* in, float* out, int n) { rig.processBlock(in, out, n); },
+            input, output, numSamples, blockSize);
+
+        printf("%-10s %8d %12.2f\n", "dynamic", blockSize, dynamicNs);
+        printf("%-10s %8d %12.2f\n", "static", blockSize, staticNs);
+    }
+
+    delete[] input;
+    delete[] output;
+
+    printf("\nstatic matches dynamic: %s (%d samples differ)\n", mismatches == 0 ? "PASS" : "FAIL",
+           mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
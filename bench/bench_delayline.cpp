@@ -0,0 +1,152 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * DelayLine Microbenchmark
+ *
+ * A damped comb filter (the Reverb inner loop) built on three kinds of
+ * circular buffer:
+ *   - modulo:   index = (index + 1) % size    (old CombFilter::process)
+ *   - branch:   if (++index >= size) index = 0 (old block loops)
+ *   - mask:     DelayLine, per-sample read()/write()
+ *   - block:    DelayLine, readBlock()/writeBlock() per 32 samples
+ * plus a chorus-style modulated read with each interpolation mode.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define COMB_SIZE 1557
+#define COMB_CAPACITY 2048
+#define BLOCK_SIZE 32
+
+struct ModuloComb {
+    float* buffer;
+    int index;
+    float z;
+    ModuloComb() : index(0), z(0.0f) {
+        buffer = hothouseDefaultArena().allocateFloats(MEMORY_FAST, COMB_SIZE);
+    }
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i++) {
+            float output = buffer[index];
+            z = output * 0.5f + z * 0.5f;
+            buffer[index] = in[i] + z * 0.8f;
+            index = (index + 1) % COMB_SIZE;
+            out[i] = output;
+        }
+    }
+};
+
+struct BranchComb {
+    float* buffer;
+    int index;
+    float z;
+    BranchComb() : index(0), z(0.0f) {
+        buffer = hothouseDefaultArena().allocateFloats(MEMORY_FAST, COMB_SIZE);
+    }
+    void operator()(const float* in, float* out, int n) {
+        int idx = index;
+        float state = z;
+        for (int i = 0; i < n; i++) {
+            float output = buffer[idx];
+            state = output * 0.5f + state * 0.5f;
+            buffer[idx] = in[i] + state * 0.8f;
+            if (++idx >= COMB_SIZE) idx = 0;
+            out[i] = output;
+        }
+        index = idx;
+        z = state;
+    }
+};
+
+struct MaskComb {
+    DelayLine<float, COMB_CAPACITY> line;
+    float z;
+    MaskComb() : z(0.0f) {
+        line.init(hothouseDefaultArena(), MEMORY_FAST);
+    }
+    void operator()(const float* in, float* out, int n) {
+        float state = z;
+        for (int i = 0; i < n; i++) {
+            float output = line.read(COMB_SIZE);
+            state = output * 0.5f + state * 0.5f;
+            line.write(in[i] + state * 0.8f);
+            out[i] = output;
+        }
+        z = state;
+    }
+};
+
+struct BlockComb {
+    DelayLine<float, COMB_CAPACITY> line;
+    float z;
+    BlockComb() : z(0.0f) {
+        line.init(hothouseDefaultArena(), MEMORY_FAST);
+    }
+    void operator()(const float* in, float* out, int n) {
+        float fed[BLOCK_SIZE];
+        line.readBlock(out, COMB_SIZE, n);
+        float state = z;
+        for (int i = 0; i < n; i++) {
+            state = out[i] * 0.5f + state * 0.5f;
+            fed[i] = in[i] + state * 0.8f;
+        }
+        z = state;
+        line.writeBlock(fed, n);
+    }
+};
+
+// Chorus-style read with a slowly swept fractional delay
+template <DelayInterpolation Interp>
+struct ModulatedRead {
+    DelayLine<float, 8192> line;
+    float phase;
+    ModulatedRead() : phase(0.0f) {
+        line.init(hothouseDefaultArena(), MEMORY_FAST);
+    }
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i++) {
+            phase += 1.0f / BENCH_SAMPLE_RATE;
+            if (phase >= 1.0f) phase -= 1.0f;
+            float delay = 720.0f + 240.0f * (2.0f * fabsf(2.0f * phase - 1.0f) - 1.0f);
+            out[i] = line.read<Interp>(delay);
+            line.write(in[i]);
+        }
+    }
+};
+
+template <typename Render>
+void report(const char* name, Render& render, const float* input, float* output, int numSamples) {
+    double ns = benchNsPerSample(render, input, output, numSamples, BLOCK_SIZE);
+    printf("%-16s %8.2f\n", name, ns);
+}
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+
+    printf("%-16s %8s\n", "comb", "ns/sample");
+    ModuloComb modulo;
+    BranchComb branch;
+    MaskComb mask;
+    BlockComb block;
+    report("modulo", modulo, input, output, numSamples);
+    report("branch", branch, input, output, numSamples);
+    report("mask", mask, input, output, numSamples);
+    report("mask block", block, input, output, numSamples);
+
+    printf("\n%-16s %8s\n", "modulated read", "ns/sample");
+    ModulatedRead<DELAY_INTERP_NONE> none;
+    ModulatedRead<DELAY_INTERP_LINEAR> linear;
+    ModulatedRead<DELAY_INTERP_CUBIC> cubic;
+    ModulatedRead<DELAY_INTERP_ALLPASS> allpass;
+    report("none", none, input, output, numSamples);
+    report("linear", linear, input, output, numSamples);
+    report("cubic", cubic, input, output, numSamples);
+    report("allpass", allpass, input, output, numSamples);
+
+    delete[] input;
+    delete[] output;
+    return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Delay Storage Format Harness and Benchmark
+ *
+ * Compares DelayLine storage formats (float, Q15, Companded12):
+ *   - bytes per second of delay, and the Delay presets built on them
+ *   - noise floor: SNR of a write/read round trip for sines at several
+ *     levels, and of the Delay and Reverb pedals against float storage
+ *   - ns/sample of block and per-sample write/read on a one-second line,
+ *     and of the Delay pedal with each format
+ *
+ * Exits non-zero if the vectorized and scalar companders disagree or a
+ * companded sample is off by more than half a code step.
+ */
+
+#include "hothouse.h"
+#include "pedals/delay/delay.cpp"
+#include "pedals/reverb/reverb.cpp"
+#include "bench/bench.h"
+
+#define STORAGE_BLOCK 32
+#define STORAGE_DELAY 48000
+#define STORAGE_CAPACITY 65536
+
+static const char* formatNames[3] = {"float", "Q15", "Companded12"};
+
+// Round trip through a line: write every block, read it back one second later
+template <typename Storage>
+static double roundTripSnrDb(const float* input, int numSamples) {
+    static DelayLine<float, STORAGE_CAPACITY, Storage> line;
+    static bool initialized = false;
+    if (!initialized) line.init(hothouseDefaultArena(), MEMORY_BULK);
+    initialized = true;
+    line.clear();
+
+    double signal = 0.0;
+    double noise = 0.0;
+    float block[STORAGE_BLOCK];
+    for (int i = 0; i + STORAGE_BLOCK <= numSamples; i += STORAGE_BLOCK) {
+        line.writeBlock(input + i, STORAGE_BLOCK);
+        line.readBlock(block, STORAGE_BLOCK, STORAGE_BLOCK);
+        for (int j = 0; j < STORAGE_BLOCK; j++) {
+            double error = (double)block[j] - input[i + j];
+            signal += (double)input[i + j] * input[i + j];
+            noise += error * error;
+        }
+    }
+    if (noise == 0.0) return 999.0;
+    return 10.0 * log10(signal / noise);
+}
+
+template <typename Storage>
+struct BlockAccess {
+    DelayLine<float, STORAGE_CAPACITY, Storage>* line;
+    void operator()(const float* in, float* out, int n) {
+        line->readBlock(out, STORAGE_DELAY, n);
+        line->writeBlock(in, n);
+    }
+};
+
+template <typename Storage>
+struct SampleAccess {
+    DelayLine<float, STORAGE_CAPACITY, Storage>* line;
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i++) {
+            out[i] = line->read(STORAGE_DELAY);
+            line->write(in[i]);
+        }
+    }
+};
+
+template <typename Pedal>
+struct PedalRender {
+    Pedal* pedal;
+    void operator()(const float* in, float* out, int n) {
+        pedal->processBlock(in, out, n);
+    }
+};
+
+template <typename Pedal>
+static void renderPedal(Pedal& pedal, const HothouseControls& controls, const float* input,
+                        float* output, int numSamples) {
+    pedal.reset();
+    pedal.updateFromControls(controls);
+    for (int i = 0; i + STORAGE_BLOCK <= numSamples; i += STORAGE_BLOCK) {
+        pedal.processBlock(input + i, output + i, STORAGE_BLOCK);
+    }
+}
+
+static double snrDb(const float* reference, const float* test, int numSamples) {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        double error = (double)test[i] - reference[i];
+        signal += (double)reference[i] * reference[i];
+        noise += error * error;
+    }
+    if (noise == 0.0) return 999.0;
+    return 10.0 * log10(signal / noise);
+}
+
+// Scalar and vectorized companders agree, and stay within half a step
+static bool checkCompander() {
+    const int count = 1 << 20;
+    static float values[1 << 20];
+    static uint16_t codes[1 << 20];
+    static float decoded[1 << 20];
+    unsigned int seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float unit = (float)(seed >> 8) / 16777216.0f;  // [0, 1)
+        float magnitude = powf(2.0f, -20.0f * unit);
+        values[i] = (seed & 1) ? magnitude : -magnitude;
+    }
+    values[0] = 0.0f;
+    values[1] = 1.0f;
+    values[2] = -1.0f;
+    hothouseCompandBlock(values, codes, count);
+    hothouseExpandBlock(codes, decoded, count);
+
+    bool ok = true;
+    double worst = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (codes[i] != hothouseCompand(values[i]) || decoded[i] != hothouseExpand(codes[i])) {
+            ok = false;
+        }
+        // Half a step of the segment holding |x| + 2^-7 (8 mantissa bits)
+        double step = ldexp(1.0, ilogb(fabs((double)values[i]) + HOTHOUSE_COMPAND_OFFSET) - 8);
+        double error = fabs((double)decoded[i] - values[i]) / (0.5 * step);
+        if (error > worst) worst = error;
+    }
+    printf("compander: scalar/vector %s, worst error %.3f half-steps\n",
+           ok ? "match" : "MISMATCH", worst);
+    return ok && worst <= 1.001;  // Plus float rounding of |x| + 2^-7
+}
+
+// Delay lines and pedals live in static storage, as they would on the device
+static DelayLine<float, STORAGE_CAPACITY, float> floatLine;
+static DelayLine<float, STORAGE_CAPACITY, Q15> q15Line;
+static DelayLine<float, STORAGE_CAPACITY, Companded12> companded12Line;
+static DelayT<float, float> floatDelay(BENCH_SAMPLE_RATE);
+static DelayT<float, Q15> q15Delay(BENCH_SAMPLE_RATE);
+static DelayT<float, Companded12> companded12Delay(BENCH_SAMPLE_RATE);
+static LongDelay longDelay(BENCH_SAMPLE_RATE);
+static LongDelay12 longDelay12(BENCH_SAMPLE_RATE);
+static ReverbT<float, float> floatReverb(BENCH_SAMPLE_RATE);
+static ReverbT<float, Q15> q15Reverb(BENCH_SAMPLE_RATE);
+static ReverbT<float, Companded12> companded12Reverb(BENCH_SAMPLE_RATE);
+
+int main() {
+    bool ok = checkCompander();
+
+    printf("\n%-12s %12s %14s\n", "format", "bytes/sample", "ms per 64KB");
+    size_t lineBytes[3] = {DelayLine<float, 2, float>::bytes(), DelayLine<float, 2, Q15>::bytes(),
+                           DelayLine<float, 2, Companded12>::bytes()};
+    for (int f = 0; f < 3; f++) {
+        double bytesPerSample = lineBytes[f] / 2.0;
+        printf("%-12s %12.2f %14.0f\n", formatNames[f], bytesPerSample,
+               1000.0 * 65536.0 / bytesPerSample / BENCH_SAMPLE_RATE);
+    }
+    printf("Delay: %d KB, LongDelay (Q15): %d KB, LongDelay12 (Companded12): %d KB\n",
+           (int)(DelayLine<float, DELAY_LINE_CAPACITY>::bytes() / 1024),
+           (int)(DelayLine<float, 2 * DELAY_LINE_CAPACITY, Q15>::bytes() / 1024),
+           (int)(DelayLine<float, 4 * DELAY_LINE_CAPACITY, Companded12>::bytes() / 1024));
+
+    // Round-trip SNR for a 440 Hz sine at each level
+    const int numSamples = BENCH_SAMPLE_RATE * 4;
+    float* input = new float[numSamples];
+    float* reference = new float[numSamples];
+    float* output = new float[numSamples];
+    const double levelsDb[] = {0.0, -20.0, -40.0, -60.0};
+    printf("\nround-trip SNR (dB), 440 Hz sine\n%-12s", "format");
+    for (int l = 0; l < 4; l++) printf(" %8.0fdB", levelsDb[l]);
+    printf("\n");
+    for (int f = 0; f < 3; f++) {
+        printf("%-12s", formatNames[f]);
+        for (int l = 0; l < 4; l++) {
+            float amplitude = (float)pow(10.0, levelsDb[l] / 20.0) * 0.999f;
+            for (int i = 0; i < numSamples; i++) {
+                input[i] = amplitude * sinf(6.28318530718f * 440.0f * i / BENCH_SAMPLE_RATE);
+            }
+            double snr = f == 0 ? roundTripSnrDb<float>(input, numSamples)
+                       : f == 1 ? roundTripSnrDb<Q15>(input, numSamples)
+                                : roundTripSnrDb<Companded12>(input, numSamples);
+            printf(" %10.1f", snr);
+        }
+        printf("\n");
+    }
+
+    // Delay pedal with feedback: each storage against float storage
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+    HothouseControls controls;
+    for (int k = 0; k < KNOB_COUNT; k++) controls.knobs[k] = 0.5f;
+    controls.knobs[KNOB_2] = 0.8f;
+    controls.toggles[TOGGLESWITCH_1] = TOGGLESWITCH_UP;
+    renderPedal(floatDelay, controls, input, reference, numSamples);
+    renderPedal(q15Delay, controls, input, output, numSamples);
+    double q15Snr = snrDb(reference, output, numSamples);
+    renderPedal(companded12Delay, controls, input, output, numSamples);
+    double companded12Snr = snrDb(reference, output, numSamples);
+    printf("\nSNR against float storage (dB)\n%-12s %10s %10s\n", "pedal", "Q15", "Companded12");
+    printf("%-12s %10.1f %10.1f\n", "Delay", q15Snr, companded12Snr);
+    controls.toggles[TOGGLESWITCH_1] = TOGGLESWITCH_DOWN;
+    renderPedal(floatReverb, controls, input, reference, numSamples);
+    renderPedal(q15Reverb, controls, input, output, numSamples);
+    q15Snr = snrDb(reference, output, numSamples);
+    renderPedal(companded12Reverb, controls, input, output, numSamples);
+    companded12Snr = snrDb(reference, output, numSamples);
+    printf("%-12s %10.1f %10.1f\n", "Reverb hall", q15Snr, companded12Snr);
+
+    // Throughput on a one-second delay
+    const int speedSamples = BENCH_SAMPLE_RATE * 10;
+    float* speedInput = new float[speedSamples];
+    float* speedOutput = new float[speedSamples];
+    benchFillGuitar(speedInput, speedSamples, (float)BENCH_SAMPLE_RATE);
+    floatLine.init(hothouseDefaultArena(), MEMORY_BULK);
+    q15Line.init(hothouseDefaultArena(), MEMORY_BULK);
+    companded12Line.init(hothouseDefaultArena(), MEMORY_BULK);
+    BlockAccess<float> floatBlock = {&floatLine};
+    BlockAccess<Q15> q15Block = {&q15Line};
+    BlockAccess<Companded12> companded12Block = {&companded12Line};
+    SampleAccess<float> floatSample = {&floatLine};
+    SampleAccess<Q15> q15Sample = {&q15Line};
+    SampleAccess<Companded12> companded12Sample = {&companded12Line};
+    PedalRender<DelayT<float, float> > floatPedal = {&floatDelay};
+    PedalRender<DelayT<float, Q15> > q15Pedal = {&q15Delay};
+    PedalRender<DelayT<float, Companded12> > companded12Pedal = {&companded12Delay};
+    PedalRender<LongDelay> longPedal = {&longDelay};
+    PedalRender<LongDelay12> long12Pedal = {&longDelay12};
+    controls.knobs[KNOB_1] = 1.0f;
+    controls.toggles[TOGGLESWITCH_1] = TOGGLESWITCH_DOWN;
+    longDelay.updateFromControls(controls);
+    longDelay12.updateFromControls(controls);
+
+    printf("\nns/sample, %d-sample blocks\n%-12s %10s %10s %10s\n", STORAGE_BLOCK, "format",
+           "block r/w", "sample r/w", "Delay");
+    printf("%-12s %10.2f %10.2f %10.2f\n", formatNames[0],
+           benchNsPerSample(floatBlock, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(floatSample, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(floatPedal, speedInput, speedOutput, speedSamples, STORAGE_BLOCK));
+    printf("%-12s %10.2f %10.2f %10.2f\n", formatNames[1],
+           benchNsPerSample(q15Block, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(q15Sample, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(q15Pedal, speedInput, speedOutput, speedSamples, STORAGE_BLOCK));
+    printf("%-12s %10.2f %10.2f %10.2f\n", formatNames[2],
+           benchNsPerSample(companded12Block, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(companded12Sample, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(companded12Pedal, speedInput, speedOutput, speedSamples, STORAGE_BLOCK));
+    printf("LongDelay at 2 s: %.2f ns/sample, LongDelay12 at 4 s: %.2f ns/sample\n",
+           benchNsPerSample(longPedal, speedInput, speedOutput, speedSamples, STORAGE_BLOCK),
+           benchNsPerSample(long12Pedal, speedInput, speedOutput, speedSamples, STORAGE_BLOCK));
+
+    delete[] input;
+    delete[] reference;
+    delete[] output;
+    delete[] speedInput;
+    delete[] speedOutput;
+
+    printf("\n%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
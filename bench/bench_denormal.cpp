@@ -0,0 +1,123 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Denormal Benchmark
+ *
+ * Feeds a single impulse followed by silence through the feedback-heavy
+ * effects and records the time of every block while their recursive
+ * states decay. Reported as mean ns/block per time segment for:
+ *   - none:  DC injection compiled out, no FTZ guard (unprotected)
+ *   - dc:    HOTHOUSE_DENORMAL_DC injection only (portable fallback)
+ *   - ftz:   HothouseDenormalGuard only
+ *   - both:  what HothousePedal::processBuffer() runs
+ *
+ * The unprotected pedals are a second copy of the sources compiled with
+ * HOTHOUSE_DENORMAL_DC set to zero, in their own namespace.
+ */
+
+#include "hothouse.h"
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/compressor/compressor.cpp"
+
+#undef HOTHOUSE_DENORMAL_DC
+#define HOTHOUSE_DENORMAL_DC 0.0f
+namespace unprotected {
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/compressor/compressor.cpp"
+}
+
+#include "bench/bench.h"
+
+#define DENORMAL_BLOCK 32
+#define DENORMAL_SECONDS 24
+#define DENORMAL_SEGMENT_SECONDS 2
+#define DENORMAL_SEGMENTS (DENORMAL_SECONDS / DENORMAL_SEGMENT_SECONDS)
+#define DENORMAL_VARIANTS 4
+
+static const char* variantNames[DENORMAL_VARIANTS] = {"none", "dc", "ftz", "both"};
+
+/**
+ * Impulse, then silence; fills segmentNs with mean ns/block per segment
+ */
+template <typename Effect>
+void runDecay(Effect& effect, const HothouseControls& controls, bool ftz, double* segmentNs) {
+    effect.reset();
+    effect.updateFromControls(controls);
+
+    const int blocksPerSegment = BENCH_SAMPLE_RATE * DENORMAL_SEGMENT_SECONDS / DENORMAL_BLOCK;
+    float input[DENORMAL_BLOCK];
+    float output[DENORMAL_BLOCK];
+    for (int i = 0; i < DENORMAL_BLOCK; i++) input[i] = 0.0f;
+
+    for (int s = 0; s < DENORMAL_SEGMENTS; s++) {
+        double total = 0.0;
+        for (int b = 0; b < blocksPerSegment; b++) {
+            input[0] = (s == 0 && b == 0) ? 1.0f : 0.0f;
+            double start = benchNowNs();
+            if (ftz) {
+                HothouseDenormalGuard guard;
+                effect.processBlock(input, output, DENORMAL_BLOCK);
+            } else {
+                effect.processBlock(input, output, DENORMAL_BLOCK);
+            }
+            total += benchNowNs() - start;
+            benchConsume(output, DENORMAL_BLOCK);
+        }
+        segmentNs[s] = total / blocksPerSegment;
+    }
+}
+
+template <typename Protected, typename Unprotected>
+void report(const char* name, Protected& protectedFx, Unprotected& unprotectedFx,
+            const HothouseControls& controls) {
+    double results[DENORMAL_VARIANTS][DENORMAL_SEGMENTS];
+    runDecay(unprotectedFx, controls, false, results[0]);
+    runDecay(protectedFx, controls, false, results[1]);
+    runDecay(unprotectedFx, controls, true, results[2]);
+    runDecay(protectedFx, controls, true, results[3]);
+
+    printf("\n%s (ns per %d-sample block)\n", name, DENORMAL_BLOCK);
+    printf("%-10s", "time");
+    for (int v = 0; v < DENORMAL_VARIANTS; v++) printf(" %10s", variantNames[v]);
+    printf("\n");
+    for (int s = 0; s < DENORMAL_SEGMENTS; s++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d-%ds", s * DENORMAL_SEGMENT_SECONDS,
+                 (s + 1) * DENORMAL_SEGMENT_SECONDS);
+        printf("%-10s", label);
+        for (int v = 0; v < DENORMAL_VARIANTS; v++) printf(" %10.0f", results[v][s]);
+        printf("\n");
+    }
+}
+
+// Large effects live in static storage, as they would on the device
+static Reverb reverb(BENCH_SAMPLE_RATE);
+static unprotected::Reverb reverbUnprotected(BENCH_SAMPLE_RATE);
+static Delay delay(BENCH_SAMPLE_RATE);
+static unprotected::Delay delayUnprotected(BENCH_SAMPLE_RATE);
+static Compressor compressor(BENCH_SAMPLE_RATE);
+static unprotected::Compressor compressorUnprotected(BENCH_SAMPLE_RATE);
+
+int main() {
+    HothouseControls controls;
+
+    // Long hall tail
+    controls.knobs[KNOB_1] = 0.8f;
+    controls.toggles[TOGGLESWITCH_1] = TOGGLESWITCH_DOWN;
+    report("reverb", reverb, reverbUnprotected, controls);
+
+    // Short repeats, moderate feedback
+    controls = HothouseControls();
+    controls.knobs[KNOB_1] = 0.2f;
+    controls.knobs[KNOB_2] = 0.6f;
+    controls.toggles[TOGGLESWITCH_1] = TOGGLESWITCH_UP;
+    report("delay", delay, delayUnprotected, controls);
+
+    // Fast release so the envelope reaches the subnormal range quickly
+    controls = HothouseControls();
+    controls.knobs[KNOB_4] = 0.0f;
+    report("compressor", compressor, compressorUnprotected, controls);
+
+    return 0;
+}
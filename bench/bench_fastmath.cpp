@@ -0,0 +1,192 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Fast Math Accuracy Harness and Benchmark
+ *
+ *   - fastLog2/fastExp2 worst-case error at each FastMathPrecision
+ *   - compressor gain error in dB: the log2-domain gain computer with the
+ *     fast functions against the dB-domain one in double precision, over
+ *     a sweep of threshold, ratio, knee and envelope level
+ *   - ns/sample of the per-sample gain path (log10f + powf against
+ *     fastLog2 + fastExp2) and of the Compressor pedal, as a share of
+ *     the 48 kHz sample period
+ *
+ * Exits non-zero if the compressor's default precision exceeds 0.01 dB.
+ */
+
+#include "hothouse.h"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+
+#define GAIN_ERROR_LIMIT_DB 0.01
+
+static const char* precisionNames[3] = {"coarse", "medium", "fine"};
+
+// Reference gain computer in dB, double precision
+static double referenceGainDb(double envDb, double threshDb, double ratio, double kneeDb) {
+    double slope = 1.0 / ratio - 1.0;
+    if (kneeDb <= 0.0) return envDb > threshDb ? (envDb - threshDb) * slope : 0.0;
+    double half = kneeDb * 0.5;
+    if (envDb < threshDb - half) return 0.0;
+    if (envDb > threshDb + half) return (envDb - threshDb) * slope;
+    double x = envDb - threshDb + half;
+    return x * x * slope / (2.0 * kneeDb);
+}
+
+// The compressor's log2-domain gain computer, returning linear gain
+template <FastMathPrecision Precision>
+static float fastGain(float env, float threshLog2, float invRatio, float kneeLog2) {
+    float envLog2 = fastLog2<Precision>(env);
+    float slope = invRatio - 1.0f;
+    float gainLog2;
+    float half = kneeLog2 * 0.5f;
+    if (kneeLog2 <= 0.0f) {
+        gainLog2 = envLog2 > threshLog2 ? (envLog2 - threshLog2) * slope : 0.0f;
+    } else if (envLog2 < threshLog2 - half) {
+        gainLog2 = 0.0f;
+    } else if (envLog2 > threshLog2 + half) {
+        gainLog2 = (envLog2 - threshLog2) * slope;
+    } else {
+        float x = envLog2 - threshLog2 + half;
+        gainLog2 = x * x * slope / (2.0f * kneeLog2);
+    }
+    return fastExp2<Precision>(gainLog2);
+}
+
+template <FastMathPrecision Precision>
+static void primitiveErrors(double& log2Error, double& exp2Error) {
+    log2Error = 0.0;
+    exp2Error = 0.0;
+    for (int i = 0; i < 1000000; i++) {
+        float x = (float)pow(10.0, -6.0 + 9.0 * i / 1000000.0);
+        double e = fabs((double)fastLog2<Precision>(x) - log2((double)x));
+        if (e > log2Error) log2Error = e;
+        float y = -30.0f + 40.0f * (float)i / 1000000.0f;
+        double reference = exp2((double)y);
+        double r = fabs((double)fastExp2<Precision>(y) - reference) / reference;
+        if (r > exp2Error) exp2Error = r;
+    }
+}
+
+template <FastMathPrecision Precision>
+static double gainErrorDb() {
+    const float thresholds[] = {0.01f, 0.1f, 0.5f, 1.0f};
+    const float ratios[] = {1.5f, 4.0f, 20.0f};
+    const float knees[] = {0.0f, 6.0f, 12.0f};
+    double worst = 0.0;
+    for (int t = 0; t < 4; t++) {
+        for (int r = 0; r < 3; r++) {
+            for (int k = 0; k < 3; k++) {
+                double threshDb = 20.0 * log10((double)thresholds[t] + 0.0001);
+                float threshLog2 = log2f(thresholds[t] + 0.0001f);
+                for (int i = 0; i <= 20000; i++) {
+                    float env = (float)pow(10.0, -4.0 + 4.0 * i / 20000.0);
+                    double exact = referenceGainDb(20.0 * log10((double)env), threshDb,
+                                                   ratios[r], knees[k]);
+                    float gain = fastGain<Precision>(env, threshLog2, 1.0f / ratios[r],
+                                                     knees[k] / HOTHOUSE_DB_PER_LOG2);
+                    double error = fabs(20.0 * log10((double)gain) - exact);
+                    if (error > worst) worst = error;
+                }
+            }
+        }
+    }
+    return worst;
+}
+
+// Envelope follower plus gain, as in the compressor's inner loop
+struct ReferenceGainPath {
+    float env;
+    ReferenceGainPath() : env(0.0f) {}
+    void operator()(const float* in, float* out, int n) {
+        float threshDb = -12.0f;
+        for (int i = 0; i < n; i++) {
+            float rectified = fabsf(in[i]);
+            env = 0.99f * env + 0.01f * rectified;
+            float gain = 1.0f;
+            if (env >= 0.0001f) {
+                float envDb = 20.0f * log10f(env);
+                float gainDb = envDb > threshDb ? (envDb - threshDb) * -0.75f : 0.0f;
+                gain = powf(10.0f, gainDb / 20.0f);
+            }
+            out[i] = in[i] * gain;
+        }
+    }
+};
+
+template <FastMathPrecision Precision>
+struct FastGainPath {
+    float env;
+    FastGainPath() : env(0.0f) {}
+    void operator()(const float* in, float* out, int n) {
+        float threshLog2 = -12.0f / HOTHOUSE_DB_PER_LOG2;
+        for (int i = 0; i < n; i++) {
+            float rectified = fabsf(in[i]);
+            env = 0.99f * env + 0.01f * rectified;
+            float gain = 1.0f;
+            if (env >= 0.0001f) {
+                float envLog2 = fastLog2<Precision>(env);
+                float gainLog2 = envLog2 > threshLog2 ? (envLog2 - threshLog2) * -0.75f : 0.0f;
+                gain = fastExp2<Precision>(gainLog2);
+            }
+            out[i] = in[i] * gain;
+        }
+    }
+};
+
+struct CompressorPath {
+    Compressor compressor;
+    void operator()(const float* in, float* out, int n) {
+        compressor.processBlock(in, out, n);
+    }
+};
+
+template <typename Render>
+static void reportSpeed(const char* name, Render& render, const float* input, float* output,
+                        int numSamples) {
+    double ns = benchNsPerSample(render, input, output, numSamples, 32);
+    double periodNs = 1e9 / BENCH_SAMPLE_RATE;
+    printf("%-18s %10.2f %13.3f%%\n", name, ns, 100.0 * ns / periodNs);
+}
+
+int main() {
+    double log2Error[3], exp2Error[3], gainError[3];
+    primitiveErrors<FAST_MATH_COARSE>(log2Error[0], exp2Error[0]);
+    primitiveErrors<FAST_MATH_MEDIUM>(log2Error[1], exp2Error[1]);
+    primitiveErrors<FAST_MATH_FINE>(log2Error[2], exp2Error[2]);
+    gainError[0] = gainErrorDb<FAST_MATH_COARSE>();
+    gainError[1] = gainErrorDb<FAST_MATH_MEDIUM>();
+    gainError[2] = gainErrorDb<FAST_MATH_FINE>();
+
+    printf("%-10s %14s %14s %16s\n", "precision", "log2 abs err", "exp2 rel err", "gain err (dB)");
+    for (int p = 0; p < 3; p++) {
+        printf("%-10s %14.3g %14.3g %16.5f\n", precisionNames[p], log2Error[p], exp2Error[p],
+               gainError[p]);
+    }
+
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+
+    printf("\n%-18s %10s %14s\n", "gain path", "ns/sample", "48kHz budget");
+    ReferenceGainPath reference;
+    FastGainPath<FAST_MATH_COARSE> coarse;
+    FastGainPath<FAST_MATH_MEDIUM> medium;
+    FastGainPath<FAST_MATH_FINE> fine;
+    static CompressorPath compressor;
+    HothouseControls controls;
+    compressor.compressor.updateFromControls(controls);
+    reportSpeed("log10f + powf", reference, input, output, numSamples);
+    reportSpeed("fast coarse", coarse, input, output, numSamples);
+    reportSpeed("fast medium", medium, input, output, numSamples);
+    reportSpeed("fast fine", fine, input, output, numSamples);
+    reportSpeed("Compressor pedal", compressor, input, output, numSamples);
+
+    delete[] input;
+    delete[] output;
+
+    bool ok = gainError[COMPRESSOR_MATH_PRECISION] <= GAIN_ERROR_LIMIT_DB;
+    printf("\ncompressor precision: %s, %s\n", precisionNames[COMPRESSOR_MATH_PRECISION],
+           ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Filter Library Harness and Benchmark
+ *
+ *   - lanes against scalar: OnePoleLanesT and MultibandBiquad must match
+ *     the same filters run one at a time, bit for bit
+ *   - response: magnitude of each BiquadType and SvfMode at a few
+ *     frequencies, from the impulse response, against the expected value
+ *   - ns/sample of each filter, four scalar filters against one lane
+ *     filter, and the cost of a setter call with and without a change
+ *
+ * Exits non-zero if a lane filter differs from its scalar filters or a
+ * response is off by more than 0.1 dB.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define FILTER_BLOCK 32
+#define RESPONSE_LENGTH 16384
+#define RESPONSE_TOLERANCE_DB 0.1
+
+// Magnitude in dB at hz of a filter, from its impulse response
+template <typename Filter>
+static double responseDb(Filter& filter, double hz) {
+    static float impulse[RESPONSE_LENGTH];
+    for (int i = 0; i < RESPONSE_LENGTH; i++) impulse[i] = i == 0 ? 1.0f : 0.0f;
+    filter.reset();
+    for (int i = 0; i < RESPONSE_LENGTH; i += FILTER_BLOCK) {
+        filter.processBlock(impulse + i, impulse + i, FILTER_BLOCK);
+    }
+    double w = 6.283185307179586 * hz / BENCH_SAMPLE_RATE;
+    double re = 0.0;
+    double im = 0.0;
+    for (int i = 0; i < RESPONSE_LENGTH; i++) {
+        re += impulse[i] * cos(w * i);
+        im -= impulse[i] * sin(w * i);
+    }
+    return 10.0 * log10(re * re + im * im + 1e-30);
+}
+
+struct ResponseCheck {
+    double hz;
+    double expectedDb;
+};
+
+static bool reportResponse(const char* name, double hz, double measured, double expected) {
+    bool ok = fabs(measured - expected) <= RESPONSE_TOLERANCE_DB || (expected < -60.0 && measured < -60.0);
+    printf("%-22s %8.0f %12.2f %12.2f  %s\n", name, hz, measured, expected, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+static bool checkBiquad(const char* name, BiquadType type, float q, float gainDb,
+                        const ResponseCheck* checks, int count) {
+    BiquadT<float> biquad;
+    biquad.setResponse(type, 1000.0f, (float)BENCH_SAMPLE_RATE, q, gainDb);
+    bool ok = true;
+    for (int c = 0; c < count; c++) {
+        ok &= reportResponse(name, checks[c].hz, responseDb(biquad, checks[c].hz), checks[c].expectedDb);
+    }
+    return ok;
+}
+
+static bool checkSvf(const char* name, SvfMode mode, const ResponseCheck* checks, int count) {
+    SvfT<float> svf;
+    svf.setResponse(mode, 1000.0f, (float)BENCH_SAMPLE_RATE, 0.7071f);
+    bool ok = true;
+    for (int c = 0; c < count; c++) {
+        ok &= reportResponse(name, checks[c].hz, responseDb(svf, checks[c].hz), checks[c].expectedDb);
+    }
+    return ok;
+}
+
+static bool checkResponses() {
+    const double corner = 20.0 * log10(sqrt(0.5));
+    printf("%-22s %8s %12s %12s\n", "response", "Hz", "dB", "expected");
+    const ResponseCheck lowpass[] = {{50.0, 0.0}, {1000.0, corner}};
+    const ResponseCheck highpass[] = {{20000.0, 0.0}, {1000.0, corner}};
+    const ResponseCheck bandpass[] = {{1000.0, 0.0}};
+    const ResponseCheck notch[] = {{1000.0, -100.0}, {50.0, 0.0}};
+    const ResponseCheck peak[] = {{1000.0, 6.0}, {20.0, 0.0}};
+    const ResponseCheck lowShelf[] = {{20.0, 6.0}, {20000.0, 0.0}};
+    const ResponseCheck highShelf[] = {{20.0, 0.0}, {23000.0, 6.0}};
+    const ResponseCheck allpass[] = {{100.0, 0.0}, {1000.0, 0.0}, {10000.0, 0.0}};
+    bool ok = true;
+    ok &= checkBiquad("biquad lowpass", BIQUAD_LOWPASS, 0.7071f, 0.0f, lowpass, 2);
+    ok &= checkBiquad("biquad highpass", BIQUAD_HIGHPASS, 0.7071f, 0.0f, highpass, 2);
+    ok &= checkBiquad("biquad bandpass", BIQUAD_BANDPASS, 2.0f, 0.0f, bandpass, 1);
+    ok &= checkBiquad("biquad notch", BIQUAD_NOTCH, 2.0f, 0.0f, notch, 2);
+    ok &= checkBiquad("biquad peak", BIQUAD_PEAK, 2.0f, 6.0f, peak, 2);
+    ok &= checkBiquad("biquad low shelf", BIQUAD_LOW_SHELF, 0.7071f, 6.0f, lowShelf, 2);
+    ok &= checkBiquad("biquad high shelf", BIQUAD_HIGH_SHELF, 0.7071f, 6.0f, highShelf, 2);
+    ok &= checkBiquad("biquad allpass", BIQUAD_ALLPASS, 0.7071f, 0.0f, allpass, 3);
+    ok &= checkSvf("svf lowpass", SVF_LOWPASS, lowpass, 2);
+    ok &= checkSvf("svf highpass", SVF_HIGHPASS, highpass, 2);
+    ok &= checkSvf("svf notch", SVF_NOTCH, notch, 2);
+    ok &= checkSvf("svf allpass", SVF_ALLPASS, allpass, 3);
+    return ok;
+}
+
+// Four scalar one-poles and four biquad cascades, as the lane filters run them
+struct ScalarOnePoles {
+    OnePoleT<float, true> filters[4];
+    ScalarOnePoles() {
+        for (int l = 0; l < 4; l++) filters[l].setPole(l * 0.2f + 0.1f);
+    }
+    void run(float* const* lanes, int n) {
+        for (int l = 0; l < 4; l++) filters[l].processBlock(lanes[l], n);
+    }
+};
+
+struct LaneOnePoles {
+    OnePoleLanesT<float, 4, true> filter;
+    LaneOnePoles() {
+        for (int l = 0; l < 4; l++) filter.setPole(l, l * 0.2f + 0.1f);
+    }
+    void run(float* const* lanes, int n) { filter.processBlock(lanes, lanes, n); }
+};
+
+// A 4-band split: low, two bands and high, Butterworth pairs per lane
+static void designBands(int lane, BiquadT<float>* stages) {
+    const BiquadType types[4] = {BIQUAD_LOWPASS, BIQUAD_BANDPASS, BIQUAD_BANDPASS, BIQUAD_HIGHPASS};
+    const float hz[4] = {200.0f, 800.0f, 2500.0f, 6000.0f};
+    for (int s = 0; s < 2; s++) {
+        stages[s].setResponse(types[lane], hz[lane], (float)BENCH_SAMPLE_RATE, 0.7071f);
+    }
+}
+
+struct ScalarBands {
+    BiquadCascadeT<float, 2> cascades[4];
+    ScalarBands() {
+        for (int l = 0; l < 4; l++) designBands(l, &cascades[l].stage(0));
+    }
+    void run(float* const* lanes, int n) {
+        for (int l = 0; l < 4; l++) cascades[l].processBlock(lanes[l], n);
+    }
+};
+
+struct LaneBands {
+    MultibandBiquad<2> bank;
+    LaneBands() {
+        for (int l = 0; l < 4; l++) {
+            BiquadT<float> stages[2];
+            designBands(l, stages);
+            for (int s = 0; s < 2; s++) bank.setCoefficients(l, s, stages[s].getCoefficients());
+        }
+    }
+    void run(float* const* lanes, int n) { bank.processBlock(lanes, lanes, n); }
+};
+
+// Renders four planar copies of the input through a lane filter
+template <typename Bank>
+struct LaneRender {
+    Bank bank;
+    float lanes[4][HOTHOUSE_MAX_CONTROL_BLOCK];
+    void operator()(const float* in, float* out, int n) {
+        float* pointers[4] = {lanes[0], lanes[1], lanes[2], lanes[3]};
+        for (int l = 0; l < 4; l++) {
+            for (int i = 0; i < n; i++) lanes[l][i] = in[i];
+        }
+        bank.run(pointers, n);
+        for (int i = 0; i < n; i++) out[i] = lanes[0][i] + lanes[1][i] + lanes[2][i] + lanes[3][i];
+    }
+};
+
+template <typename Scalar, typename Lanes>
+static bool checkLanes(const char* name, const float* input, int numSamples) {
+    static LaneRender<Scalar> scalar;
+    static LaneRender<Lanes> lanes;
+    float* a = new float[numSamples];
+    float* b = new float[numSamples];
+    // Odd block sizes exercise the lane filters' tail loops
+    for (int i = 0; i < numSamples;) {
+        int n = 1 + (i / 7) % 37;
+        if (n > numSamples - i) n = numSamples - i;
+        scalar(input + i, a + i, n);
+        lanes(input + i, b + i, n);
+        i += n;
+    }
+    int mismatches = 0;
+    for (int i = 0; i < numSamples; i++) {
+        if (a[i] != b[i]) mismatches++;
+    }
+    delete[] a;
+    delete[] b;
+    printf("%-22s %10d  %s\n", name, mismatches, mismatches == 0 ? "ok" : "FAIL");
+    return mismatches == 0;
+}
+
+template <typename Filter>
+struct FilterRender {
+    Filter filter;
+    void operator()(const float* in, float* out, int n) { filter.processBlock(in, out, n); }
+};
+
+template <typename Render>
+static void reportSpeed(const char* name, Render& render, const float* input, float* output,
+                        int numSamples) {
+    printf("%-26s %10.2f\n", name, benchNsPerSample(render, input, output, numSamples, FILTER_BLOCK));
+}
+
+// Setter cost per call: the same value every call, and a new value every call
+static void reportSetters() {
+    const int calls = 1000000;
+    BiquadT<float> biquad;
+    SvfT<float> svf;
+    OnePoleT<float> onePole;
+    float sink = 0.0f;
+    double t0 = benchNowNs();
+    for (int i = 0; i < calls; i++) {
+        biquad.setResponse(BIQUAD_LOWPASS, 1000.0f, (float)BENCH_SAMPLE_RATE, 0.7071f);
+        svf.setResponse(SVF_LOWPASS, 1000.0f, (float)BENCH_SAMPLE_RATE, 0.7071f);
+        onePole.setCutoff(1000.0f, (float)BENCH_SAMPLE_RATE);
+        sink += biquad.getCoefficients().b0;
+    }
+    double t1 = benchNowNs();
+    for (int i = 0; i < calls; i++) {
+        float hz = 500.0f + (float)(i & 1023);
+        biquad.setResponse(BIQUAD_LOWPASS, hz, (float)BENCH_SAMPLE_RATE, 0.7071f);
+        svf.setResponse(SVF_LOWPASS, hz, (float)BENCH_SAMPLE_RATE, 0.7071f);
+        onePole.setCutoff(hz, (float)BENCH_SAMPLE_RATE);
+        sink += biquad.getCoefficients().b0;
+    }
+    double t2 = benchNowNs();
+    benchConsume(&sink, 1);
+    printf("\n%-26s %10s\n", "setters (biquad+svf+pole)", "ns/call");
+    printf("%-26s %10.2f\n", "unchanged", (t1 - t0) / calls);
+    printf("%-26s %10.2f\n", "new cutoff", (t2 - t1) / calls);
+}
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 4;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+
+    bool ok = checkResponses();
+
+    printf("\n%-22s %10s\n", "lanes vs scalar", "mismatches");
+    ok &= checkLanes<ScalarOnePoles, LaneOnePoles>("one-pole x4", input, numSamples);
+    ok &= checkLanes<ScalarBands, LaneBands>("biquad 2-stage x4", input, numSamples);
+
+    printf("\n%-26s %10s\n", "filter", "ns/sample");
+    static FilterRender<OnePoleT<float> > onePole;
+    static FilterRender<OneZeroT<float> > oneZero;
+    static FilterRender<DcBlockerT<float> > dcBlocker;
+    static FilterRender<BiquadT<float> > biquad;
+    static FilterRender<BiquadCascadeT<float, 4> > cascade;
+    static FilterRender<SvfT<float> > svf;
+    onePole.filter.setCoefficient(0.3f);
+    oneZero.filter.setCoefficient(0.995f);
+    biquad.filter.setResponse(BIQUAD_PEAK, 1000.0f, (float)BENCH_SAMPLE_RATE, 1.0f, 6.0f);
+    cascade.filter.setResponse(BIQUAD_LOWPASS, 5000.0f, (float)BENCH_SAMPLE_RATE, 0.7071f);
+    svf.filter.setResponse(SVF_LOWPASS, 1000.0f, (float)BENCH_SAMPLE_RATE, 0.7071f);
+    reportSpeed("one-pole", onePole, input, output, numSamples);
+    reportSpeed("one-zero", oneZero, input, output, numSamples);
+    reportSpeed("dc blocker", dcBlocker, input, output, numSamples);
+    reportSpeed("biquad", biquad, input, output, numSamples);
+    reportSpeed("biquad cascade x4", cascade, input, output, numSamples);
+    reportSpeed("svf", svf, input, output, numSamples);
+
+    static LaneRender<ScalarOnePoles> scalarOnePoles;
+    static LaneRender<LaneOnePoles> laneOnePoles;
+    static LaneRender<ScalarBands> scalarBands;
+    static LaneRender<LaneBands> laneBands;
+    reportSpeed("one-pole x4 scalar", scalarOnePoles, input, output, numSamples);
+    reportSpeed("one-pole x4 lanes", laneOnePoles, input, output, numSamples);
+    reportSpeed("4-band biquad scalar", scalarBands, input, output, numSamples);
+    reportSpeed("4-band biquad lanes", laneBands, input, output, numSamples);
+
+    reportSetters();
+
+    delete[] input;
+    delete[] output;
+
+    printf("\nfilters: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Fixed-Point Accuracy Harness and Benchmark
+ *
+ * Runs every pedal in each TOGGLESWITCH_1 mode three times on the same
+ * guitar-like input: as float (the reference), as Q31 and as Q15. Each
+ * run goes through HothousePedalT::processBuffer(), so the fixed-point
+ * runs include the conversion at the codec boundary. Reports:
+ *   - SNR of each fixed-point output against the float output, clamped
+ *     to full scale as the codec would
+ *   - ns/sample of each run at 32-sample buffers
+ *
+ * Fixed-point samples saturate at full scale where float runs on, so a
+ * mode whose float output leaves [-1, 1] is marked "over" and cannot be
+ * expected to match. Exits non-zero if any other Q31 run is below
+ * FIXED_SNR_LIMIT_DB.
+ */
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/distortion/distortion.cpp"
+#include "pedals/fuzz/fuzz.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/chorus/chorus.cpp"
+#include "pedals/tremolo/tremolo.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+
+#define FIXED_SECONDS 4
+#define FIXED_BLOCK 32
+#define FIXED_SNR_LIMIT_DB 60.0
+
+static const char* modeNames[3] = {"up", "middle", "down"};
+
+// Single-parameter forms of the pedals with further template parameters
+template <typename Sample> using OverdriveOf = OverdriveT<Sample>;
+template <typename Sample> using DistortionOf = DistortionT<Sample>;
+template <typename Sample> using FuzzOf = FuzzT<Sample>;
+template <typename Sample> using DelayOf = DelayT<Sample>;
+template <typename Sample> using ReverbOf = ReverbT<Sample>;
+
+// Render the whole input through a pedal running the given effect
+template <typename Sample>
+static void render(HothouseEffectT<Sample>& effect, const HothouseControls& controls,
+                   const float* input, float* output, int numSamples) {
+    HothousePedalT<Sample> pedal;
+    pedal.setEffect(&effect);
+    effect.reset();
+    pedal.updateControls(controls);
+    for (int i = 0; i + FIXED_BLOCK <= numSamples; i += FIXED_BLOCK) {
+        pedal.processBuffer(input + i, output + i, FIXED_BLOCK);
+    }
+}
+
+template <typename Sample>
+struct PedalRender {
+    HothousePedalT<Sample>* pedal;
+    void operator()(const float* in, float* out, int n) {
+        pedal->processBuffer(in, out, n);
+    }
+};
+
+template <typename Sample>
+static double speed(HothouseEffectT<Sample>& effect, const HothouseControls& controls,
+                    const float* input, float* output, int numSamples) {
+    HothousePedalT<Sample> pedal;
+    pedal.setEffect(&effect);
+    pedal.updateControls(controls);
+    PedalRender<Sample> renderer = {&pedal};
+    return benchNsPerSample(renderer, input, output, numSamples, FIXED_BLOCK);
+}
+
+static double snrDb(const float* reference, const float* test, int numSamples) {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        double clamped = fmax(-1.0, fmin(1.0, (double)reference[i]));
+        double error = (double)test[i] - clamped;
+        signal += clamped * clamped;
+        noise += error * error;
+    }
+    if (noise == 0.0) return 999.0;
+    return 10.0 * log10(signal / noise);
+}
+
+static bool allPassed = true;
+
+template <template <typename> class Pedal>
+static void report(const char* name, const float* input, float* reference, float* output,
+                   int numSamples) {
+    static Pedal<float> floatEffect(BENCH_SAMPLE_RATE);
+    static Pedal<Q31> q31Effect(BENCH_SAMPLE_RATE);
+    static Pedal<Q15> q15Effect(BENCH_SAMPLE_RATE);
+
+    for (int mode = 0; mode < 3; mode++) {
+        HothouseControls controls;
+        for (int k = 0; k < KNOB_COUNT; k++) controls.knobs[k] = 0.5f;
+        controls.toggles[TOGGLESWITCH_1] = (ToggleswitchPosition)mode;
+
+        render<float>(floatEffect, controls, input, reference, numSamples);
+        float peak = 0.0f;
+        for (int i = 0; i < numSamples; i++) peak = fmaxf(peak, fabsf(reference[i]));
+        bool over = peak > 1.0f;
+        render<Q31>(q31Effect, controls, input, output, numSamples);
+        double q31Snr = snrDb(reference, output, numSamples);
+        render<Q15>(q15Effect, controls, input, output, numSamples);
+        double q15Snr = snrDb(reference, output, numSamples);
+
+        double floatNs = speed<float>(floatEffect, controls, input, output, numSamples);
+        double q31Ns = speed<Q31>(q31Effect, controls, input, output, numSamples);
+        double q15Ns = speed<Q15>(q15Effect, controls, input, output, numSamples);
+
+        bool ok = over || q31Snr >= FIXED_SNR_LIMIT_DB;
+        allPassed = allPassed && ok;
+        printf("%-11s %-7s %9.1f %9.1f %9.2f %9.2f %9.2f%s\n", name, modeNames[mode], q31Snr,
+               q15Snr, floatNs, q31Ns, q15Ns, over ? "  over" : (ok ? "" : "  FAIL"));
+    }
+}
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * FIXED_SECONDS;
+    float* input = new float[numSamples];
+    float* reference = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+
+    printf("%-11s %-7s %9s %9s %9s %9s %9s\n", "", "", "SNR (dB)", "", "ns/sample", "", "");
+    printf("%-11s %-7s %9s %9s %9s %9s %9s\n", "pedal", "toggle", "Q31", "Q15", "float", "Q31",
+           "Q15");
+    report<OverdriveOf>("overdrive", input, reference, output, numSamples);
+    report<DistortionOf>("distortion", input, reference, output, numSamples);
+    report<FuzzOf>("fuzz", input, reference, output, numSamples);
+    report<DelayOf>("delay", input, reference, output, numSamples);
+    report<ReverbOf>("reverb", input, reference, output, numSamples);
+    report<ChorusT>("chorus", input, reference, output, numSamples);
+    report<TremoloT>("tremolo", input, reference, output, numSamples);
+    report<CompressorT>("compressor", input, reference, output, numSamples);
+
+    delete[] input;
+    delete[] reference;
+    delete[] output;
+
+    printf("\nQ31 >= %.0f dB: %s\n", FIXED_SNR_LIMIT_DB, allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * LFO Benchmark
+ *
+ * Per-block cost of WavetableLfo::renderBlock()/renderMorph() for each
+ * waveform, against the float-phase LFO the pedals used before
+ * (phase += increment with a wrap branch, waveform math per sample).
+ * Also reports the frequency error of both accumulators over a minute.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define LFO_RATE_HZ 4.7f
+
+static const char* waveformNames[LFO_WAVEFORM_COUNT] = {"sine", "triangle", "square", "saw"};
+
+// The previous per-effect LFO: float phase, waveform math per sample
+template <int Waveform>
+struct FloatPhaseLfo {
+    float phase;
+    float increment;
+    FloatPhaseLfo() : phase(0.0f), increment(LFO_RATE_HZ / BENCH_SAMPLE_RATE) {}
+    void operator()(const float* in, float* out, int n) {
+        (void)in;
+        for (int i = 0; i < n; i++) {
+            switch (Waveform) {
+                case LFO_TRIANGLE:
+                    out[i] = 2.0f * fabsf(2.0f * (phase - floorf(phase + 0.5f))) - 1.0f;
+                    break;
+                case LFO_SQUARE:
+                    out[i] = phase < 0.5f ? 1.0f : -1.0f;
+                    break;
+                case LFO_SAW:
+                    out[i] = 2.0f * phase - 1.0f;
+                    break;
+                default:
+                    out[i] = sineLookup(phase);
+                    break;
+            }
+            phase += increment;
+            if (phase >= 1.0f) phase -= 1.0f;
+        }
+    }
+};
+
+struct TableLfo {
+    WavetableLfo lfo;
+    TableLfo(LfoWaveform waveform) : lfo((float)BENCH_SAMPLE_RATE) {
+        lfo.setFrequency(LFO_RATE_HZ);
+        lfo.setWaveform(waveform);
+    }
+    void operator()(const float* in, float* out, int n) {
+        (void)in;
+        lfo.renderBlock(out, n);
+    }
+};
+
+struct MorphLfo {
+    WavetableLfo lfo;
+    MorphLfo() : lfo((float)BENCH_SAMPLE_RATE) {
+        lfo.setFrequency(LFO_RATE_HZ);
+    }
+    void operator()(const float* in, float* out, int n) {
+        (void)in;
+        lfo.renderMorph(out, n, LFO_TRIANGLE, LFO_SQUARE, 0.3f);
+    }
+};
+
+template <typename Render>
+void report(const char* kind, const char* waveform, Render& render, const float* input,
+            float* output, int numSamples) {
+    const int blockSizes[] = {4, 32, 128};
+    printf("%-8s %-9s", kind, waveform);
+    for (int b = 0; b < 3; b++) {
+        double ns = benchNsPerSample(render, input, output, numSamples, blockSizes[b]);
+        printf(" %10.1f", ns * blockSizes[b]);
+    }
+    printf("\n");
+}
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    for (int i = 0; i < numSamples; i++) input[i] = 0.0f;
+
+    printf("ns per block\n%-8s %-9s %10s %10s %10s\n", "lfo", "waveform", "4", "32", "128");
+
+    FloatPhaseLfo<LFO_SINE> floatSine;
+    FloatPhaseLfo<LFO_TRIANGLE> floatTriangle;
+    FloatPhaseLfo<LFO_SQUARE> floatSquare;
+    FloatPhaseLfo<LFO_SAW> floatSaw;
+    report("float", waveformNames[LFO_SINE], floatSine, input, output, numSamples);
+    report("float", waveformNames[LFO_TRIANGLE], floatTriangle, input, output, numSamples);
+    report("float", waveformNames[LFO_SQUARE], floatSquare, input, output, numSamples);
+    report("float", waveformNames[LFO_SAW], floatSaw, input, output, numSamples);
+
+    for (int w = 0; w < LFO_WAVEFORM_COUNT; w++) {
+        TableLfo table((LfoWaveform)w);
+        report("table", waveformNames[w], table, input, output, numSamples);
+    }
+    MorphLfo morph;
+    report("morph", "tri/sq", morph, input, output, numSamples);
+
+    // Frequency error after one minute: count whole cycles of each accumulator
+    const int minute = BENCH_SAMPLE_RATE * 60;
+    double expectedCycles = (double)LFO_RATE_HZ * 60.0;
+    float floatPhase = 0.0f;
+    float floatIncrement = LFO_RATE_HZ / BENCH_SAMPLE_RATE;
+    int floatCycles = 0;
+    for (int i = 0; i < minute; i++) {
+        floatPhase += floatIncrement;
+        if (floatPhase >= 1.0f) {
+            floatPhase -= 1.0f;
+            floatCycles++;
+        }
+    }
+    WavetableLfo lfo((float)BENCH_SAMPLE_RATE);
+    lfo.setFrequency(LFO_RATE_HZ);
+    float modulation[1];
+    int tableCycles = 0;
+    float previousPhase = 0.0f;
+    for (int i = 0; i < minute; i++) {
+        lfo.renderBlock(modulation, 1);
+        if (lfo.getPhase() < previousPhase) tableCycles++;
+        previousPhase = lfo.getPhase();
+    }
+    double floatTotal = floatCycles + floatPhase;
+    double tableTotal = tableCycles + lfo.getPhase();
+    printf("\nphase after 60 s at %.1f Hz (expected %.4f cycles)\n", LFO_RATE_HZ, expectedCycles);
+    printf("float accumulator:   %.4f cycles (%.2e relative error)\n", floatTotal,
+           fabs(floatTotal - expectedCycles) / expectedCycles);
+    printf("integer accumulator: %.4f cycles (%.2e relative error)\n", tableTotal,
+           fabs(tableTotal - expectedCycles) / expectedCycles);
+
+    delete[] input;
+    delete[] output;
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * CPU Load Meter Benchmark
+ *
+ *   - cost of one read of each HothouseCycleCounter source
+ *   - HothousePedal::processBuffer() on 4-sample buffers with the meter
+ *     off and on each source, for one effect and for a
+ *     Compressor -> Overdrive -> Delay chain; the difference is the
+ *     meter's overhead, shown as a share of the 4-sample deadline
+ *   - the load report the main loop sees for the chain
+ *   - a stage that spins past the deadline every 8th block, which must
+ *     show up as overruns and as the peak
+ *
+ * Exits non-zero if the meter costs more than 1% of the deadline or
+ * misses the overruns.
+ */
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+#include <algorithm>
+
+#define METER_BUFFER 4
+#define METER_OVERHEAD_LIMIT 0.01  // Share of the deadline
+#define METER_SPIN_INTERVAL 8
+
+static Compressor compressor(BENCH_SAMPLE_RATE);
+static Overdrive overdrive(BENCH_SAMPLE_RATE);
+static Delay delay(BENCH_SAMPLE_RATE);
+static Overdrive soloOverdrive(BENCH_SAMPLE_RATE);
+
+struct PedalRender {
+    HothousePedal* pedal;
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i += METER_BUFFER) {
+            pedal->processBuffer(in + i, out + i, METER_BUFFER);
+        }
+    }
+};
+
+/**
+ * Passes audio through, busy-waiting past the deadline every
+ * METER_SPIN_INTERVAL-th block
+ */
+class DeadlineSpinner : public HothouseEffect {
+private:
+    int blockCount;
+
+public:
+    int spins;
+
+    DeadlineSpinner() : blockCount(0), spins(0) {}
+
+    float process(float inputSample) override { return inputSample; }
+
+    void processBlock(const float* inputBuffer, float* outputBuffer, int numSamples) override {
+        for (int i = 0; i < numSamples; i++) outputBuffer[i] = inputBuffer[i];
+        if (++blockCount % METER_SPIN_INTERVAL != 0) return;
+        double deadline = 1.5e9 * numSamples / BENCH_SAMPLE_RATE;
+        double start = benchNowNs();
+        while (benchNowNs() - start < deadline) {
+        }
+        spins++;
+    }
+
+    void reset() override { blockCount = 0; }
+
+    void updateFromControls(const HothouseControls& controls) override { (void)controls; }
+};
+
+struct NamedCounter {
+    const char* name;
+    HothouseCycleCounter counter;
+};
+
+// Median ns of one read, over batches of reads
+static double readNs(const HothouseCycleCounter& counter) {
+    double times[BENCH_REPEATS];
+    volatile uint32_t sink = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = benchNowNs();
+        for (int i = 0; i < 100000; i++) sink = sink + counter.read();
+        times[r] = (benchNowNs() - start) / 100000;
+    }
+    (void)sink;
+    std::sort(times, times + BENCH_REPEATS);
+    return times[BENCH_REPEATS / 2];
+}
+
+static void printStats(const char* name, const HothouseLoadStats& stats) {
+    printf("  %-12s %9.2f%% %9.2f%% %10u\n", name, 100.0 * stats.average, 100.0 * stats.peak,
+           (unsigned)stats.overruns);
+}
+
+int main() {
+    NamedCounter counters[3];
+    int counterCount = 0;
+#if defined(HOTHOUSE_COUNTER_CLOCK)
+    counters[counterCount].name = "clock";
+    counters[counterCount++].counter = HothouseCycleCounter::clock();
+#endif
+#if defined(HOTHOUSE_COUNTER_TSC)
+    counters[counterCount].name = "tsc";
+    counters[counterCount++].counter = HothouseCycleCounter::tsc();
+#endif
+    if (counterCount == 0) {
+        printf("no cycle counter on this host\n");
+        return 0;
+    }
+
+    const int numSamples = BENCH_SAMPLE_RATE * 4;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+    const double deadlineNs = 1e9 * METER_BUFFER / BENCH_SAMPLE_RATE;
+
+    printf("%-8s %14s %14s\n", "counter", "ticks/s", "ns/read");
+    for (int c = 0; c < counterCount; c++) {
+        printf("%-8s %14.0f %14.2f\n", counters[c].name, counters[c].counter.ticksPerSecond,
+               readNs(counters[c].counter));
+    }
+
+    HothouseConfig config;
+    config.bufferSize = METER_BUFFER;
+    HothouseEffect* stages[] = {&compressor, &overdrive, &delay};
+    EffectChain chain(stages, 3);
+    struct Rig {
+        const char* name;
+        HothouseEffect* effect;
+    };
+    const Rig rigs[] = {{"overdrive", &soloOverdrive}, {"chain", &chain}};
+
+    bool ok = true;
+    printf("\n%-10s %-8s %12s %12s %12s\n", "rig", "meter", "ns/buffer", "overhead ns", "of deadline");
+    for (int r = 0; r < 2; r++) {
+        HothousePedal pedal(config);
+        pedal.setEffect(rigs[r].effect);
+        PedalRender render = {&pedal};
+        double baseline = METER_BUFFER * benchNsPerSample(render, input, output, numSamples, numSamples);
+        printf("%-10s %-8s %12.1f\n", rigs[r].name, "off", baseline);
+        for (int c = 0; c < counterCount; c++) {
+            pedal.enableLoadMeter(counters[c].counter);
+            double metered = METER_BUFFER * benchNsPerSample(render, input, output, numSamples, numSamples);
+            double overhead = metered - baseline;
+            ok &= overhead < METER_OVERHEAD_LIMIT * deadlineNs;
+            printf("%-10s %-8s %12.1f %12.1f %11.3f%%\n", "", counters[c].name, metered, overhead,
+                   100.0 * overhead / deadlineNs);
+        }
+    }
+
+    // What the main loop sees for the chain, metered on the last counter
+    HothousePedal pedal(config);
+    pedal.setEffect(&chain);
+    pedal.enableLoadMeter(counters[counterCount - 1].counter);
+    PedalRender render = {&pedal};
+    render(input, output, numSamples);
+    const HothouseLoadReport& report = pedal.getLoad();
+    const char* stageNames[] = {"compressor", "overdrive", "delay"};
+    printf("\nchain report (%u blocks, meter %.3f%%)\n", (unsigned)report.blocks, 100.0 * report.meterLoad);
+    printf("  %-12s %10s %10s %10s\n", "stage", "average", "peak", "overruns");
+    printStats("total", report.total);
+    for (int s = 0; s < report.numStages; s++) printStats(stageNames[s], report.stages[s]);
+
+    // One spinning stage: every METER_SPIN_INTERVAL-th block overruns
+    DeadlineSpinner spinner;
+    HothouseEffect* spinStages[] = {&overdrive, &spinner};
+    EffectChain spinChain(spinStages, 2);
+    HothousePedal spinPedal(config);
+    spinPedal.setEffect(&spinChain);
+    spinPedal.enableLoadMeter(counters[counterCount - 1].counter);
+    const int spinSamples = BENCH_SAMPLE_RATE / 4;
+    for (int i = 0; i < spinSamples; i += METER_BUFFER) {
+        spinPedal.processBuffer(input + i, output + i, METER_BUFFER);
+    }
+    const HothouseLoadReport& spinReport = spinPedal.getLoad();
+    bool caught = spinReport.stages[1].overruns >= (uint32_t)spinner.spins * 9 / 10 &&
+                  spinReport.total.overruns >= spinReport.stages[1].overruns && spinReport.total.peak > 1.4f;
+    ok &= caught;
+    printf("\nspinning stage (%d spins)\n", spinner.spins);
+    printf("  %-12s %10s %10s %10s\n", "stage", "average", "peak", "overruns");
+    printStats("total", spinReport.total);
+    printStats("overdrive", spinReport.stages[0]);
+    printStats("spinner", spinReport.stages[1]);
+
+    delete[] input;
+    delete[] output;
+
+    printf("\nload meter: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Oversampler Benchmark
+ *
+ * For each Oversampler factor (1, 2, 4, 8): round-trip latency in samples
+ * and ms, the up/down cost alone, and the passband error of the round
+ * trip on the alias tone. Pedal aliasing per factor is in
+ * bench_antialiasing.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define OVERSAMPLER_BLOCK 32
+
+template <int Factor>
+struct RoundTrip {
+    Oversampler<Factor> oversampler;
+    RoundTrip() { oversampler.init(hothouseDefaultArena(), MEMORY_FAST); }
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i++) out[i] = in[i];
+        oversampler.process(out, n, [](float* x, int m) { (void)x; (void)m; });
+    }
+};
+
+// Round trip of the tone against the tone delayed by LATENCY, in dB
+template <int Factor>
+static double roundTripSnr(const float* tone, float* output) {
+    RoundTrip<Factor> roundTrip;
+    for (int i = 0; i < BENCH_ALIAS_FFT_SIZE; i += OVERSAMPLER_BLOCK) {
+        roundTrip(tone + i, output + i, OVERSAMPLER_BLOCK);
+    }
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = BENCH_ALIAS_FFT_SIZE / 2; i < BENCH_ALIAS_FFT_SIZE; i++) {
+        double reference = tone[i - Oversampler<Factor>::LATENCY];
+        double error = output[i] - reference;
+        signal += reference * reference;
+        noise += error * error;
+    }
+    return noise > 0.0 ? 10.0 * log10(signal / noise) : 999.0;
+}
+
+template <int Factor>
+static void reportFactor(const float* guitar, const float* tone, float* output, int numSamples) {
+    static RoundTrip<Factor> roundTrip;
+    double ns = benchNsPerSample(roundTrip, guitar, output, numSamples, OVERSAMPLER_BLOCK);
+    double snr = roundTripSnr<Factor>(tone, output);
+    printf("%6dx %10d %10.3f %14.2f %12.1f\n", Factor, Oversampler<Factor>::LATENCY,
+           1000.0 * Oversampler<Factor>::LATENCY / BENCH_SAMPLE_RATE, ns, snr);
+}
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 4;
+    float* guitar = new float[numSamples];
+    float* output = new float[numSamples];
+    float* tone = new float[BENCH_ALIAS_FFT_SIZE];
+    benchFillGuitar(guitar, numSamples, (float)BENCH_SAMPLE_RATE);
+    benchFillAliasTone(tone, 0.5f);
+
+    printf("%7s %10s %10s %14s %12s\n", "factor", "latency", "ms", "up+down ns/s", "SNR (dB)");
+    reportFactor<1>(guitar, tone, output, numSamples);
+    reportFactor<2>(guitar, tone, output, numSamples);
+    reportFactor<4>(guitar, tone, output, numSamples);
+    reportFactor<8>(guitar, tone, output, numSamples);
+
+    delete[] guitar;
+    delete[] output;
+    delete[] tone;
+    return 0;
+}
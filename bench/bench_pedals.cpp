@@ -0,0 +1,206 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Per-Pedal Benchmark Suite
+ *
+ * Times processBlock() for every pedal in every TOGGLESWITCH_1 mode, at
+ * block sizes 1, 4, 32, 128 and 1024, on three inputs:
+ *   - guitar:     benchFillGuitar(), plucked notes with decaying harmonics
+ *   - silence:    zeros, where recursive states decay toward denormals
+ *   - fullscale:  a 0 dBFS 110 Hz sine, every clipper and limiter busy
+ *
+ * Each call is timed on its own. The median, p99 and worst call are
+ * reported in ns/sample and, on x86, in TSC cycles/sample, as JSON on
+ * stdout or in the file named by the first argument. The cost of reading
+ * the clocks is measured and subtracted.
+ *
+ *   ./build/bench_pedals results.json
+ */
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/distortion/distortion.cpp"
+#include "pedals/fuzz/fuzz.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/chorus/chorus.cpp"
+#include "pedals/tremolo/tremolo.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+#include <algorithm>
+#include <vector>
+
+#define SUITE_SAMPLES (48 * 1024)  // One second at 48 kHz, whole blocks of every size
+#define SUITE_MIN_CALLS 1000       // Larger blocks repeat the input to get this many calls
+#define SUITE_BLOCK_COUNT 5
+#define SUITE_INPUT_COUNT 3
+
+static const int blockSizes[SUITE_BLOCK_COUNT] = {1, 4, 32, 128, 1024};
+static const char* inputNames[SUITE_INPUT_COUNT] = {"guitar", "silence", "fullscale"};
+static const char* modeNames[3] = {"up", "middle", "down"};
+static const ToggleswitchPosition modes[3] = {TOGGLESWITCH_UP, TOGGLESWITCH_MIDDLE,
+                                               TOGGLESWITCH_DOWN};
+
+// Large effects live in static storage, as they would on the device
+static Overdrive overdrive(BENCH_SAMPLE_RATE);
+static Distortion distortion(BENCH_SAMPLE_RATE);
+static Fuzz fuzz(BENCH_SAMPLE_RATE);
+static Delay delay(BENCH_SAMPLE_RATE);
+static Reverb reverb(BENCH_SAMPLE_RATE);
+static Chorus chorus(BENCH_SAMPLE_RATE);
+static Tremolo tremolo(BENCH_SAMPLE_RATE);
+static Compressor compressor(BENCH_SAMPLE_RATE);
+
+struct Percentiles {
+    double median;
+    double p99;
+    double worst;
+};
+
+// Percentiles of a set of per-call costs, each divided by the block size
+static Percentiles percentiles(std::vector<double>& values, int blockSize) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    Percentiles p;
+    p.median = values[n / 2] / blockSize;
+    p.p99 = values[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] / blockSize;
+    p.worst = values[n - 1] / blockSize;
+    return p;
+}
+
+struct ClockOverhead {
+    double ns;
+    double cycles;
+};
+
+// Median cost of one timed empty call, subtracted from every call
+static ClockOverhead measureOverhead() {
+    std::vector<double> ns(10000);
+    std::vector<double> cycles(10000);
+    for (size_t i = 0; i < ns.size(); i++) {
+        double t0 = benchNowNs();
+        unsigned long long c0 = benchCycles();
+        unsigned long long c1 = benchCycles();
+        double t1 = benchNowNs();
+        ns[i] = t1 - t0;
+        cycles[i] = (double)(c1 - c0);
+    }
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+    ClockOverhead overhead = {ns[ns.size() / 2], cycles[cycles.size() / 2]};
+    return overhead;
+}
+
+static void printPercentiles(FILE* out, const char* name, const Percentiles& p, bool last) {
+    fprintf(out, "\"%s\": {\"median\": %.3f, \"p99\": %.3f, \"worst\": %.3f}%s", name, p.median, p.p99,
+            p.worst, last ? "" : ", ");
+}
+
+static void runCase(FILE* out, bool& first, const char* pedal, HothouseEffect& effect, int mode,
+                    int inputIndex, const float* input, float* output, int blockSize,
+                    const ClockOverhead& overhead) {
+    HothouseControls controls;
+    controls.toggles[TOGGLESWITCH_1] = modes[mode];
+    effect.reset();
+    effect.updateFromControls(controls);
+
+    // Warm caches, smoothers and branch predictors with one untimed pass
+    for (int i = 0; i < SUITE_SAMPLES; i += blockSize) {
+        effect.processBlock(input + i, output + i, blockSize);
+    }
+
+    const int callsPerPass = SUITE_SAMPLES / blockSize;
+    const int passes = (SUITE_MIN_CALLS + callsPerPass - 1) / callsPerPass;
+    std::vector<double> ns;
+    std::vector<double> cycles;
+    ns.reserve((size_t)callsPerPass * passes);
+    cycles.reserve((size_t)callsPerPass * passes);
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < SUITE_SAMPLES; i += blockSize) {
+            double t0 = benchNowNs();
+            unsigned long long c0 = benchCycles();
+            effect.processBlock(input + i, output + i, blockSize);
+            unsigned long long c1 = benchCycles();
+            double t1 = benchNowNs();
+            ns.push_back(std::max(0.0, t1 - t0 - overhead.ns));
+            cycles.push_back(std::max(0.0, (double)(c1 - c0) - overhead.cycles));
+        }
+        benchConsume(output, SUITE_SAMPLES);
+    }
+
+    Percentiles nsPerSample = percentiles(ns, blockSize);
+    fprintf(out, "%s    {\"pedal\": \"%s\", \"mode\": \"%s\", \"input\": \"%s\", \"block\": %d, ",
+            first ? "" : ",\n", pedal, modeNames[mode], inputNames[inputIndex], blockSize);
+#if defined(BENCH_HAS_CYCLES)
+    printPercentiles(out, "ns_per_sample", nsPerSample, false);
+    printPercentiles(out, "cycles_per_sample", percentiles(cycles, blockSize), true);
+#else
+    printPercentiles(out, "ns_per_sample", nsPerSample, true);
+#endif
+    fprintf(out, "}");
+    first = false;
+
+    fprintf(stderr, "%-11s %-7s %-10s %5d %9.2f %9.2f %9.2f\n", pedal, modeNames[mode],
+            inputNames[inputIndex], blockSize, nsPerSample.median, nsPerSample.p99, nsPerSample.worst);
+}
+
+int main(int argc, char** argv) {
+    FILE* out = stdout;
+    if (argc > 1) {
+        out = fopen(argv[1], "w");
+        if (out == nullptr) {
+            fprintf(stderr, "cannot write %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    float* inputs[SUITE_INPUT_COUNT];
+    for (int k = 0; k < SUITE_INPUT_COUNT; k++) inputs[k] = new float[SUITE_SAMPLES];
+    float* output = new float[SUITE_SAMPLES];
+    benchFillGuitar(inputs[0], SUITE_SAMPLES, (float)BENCH_SAMPLE_RATE);
+    for (int i = 0; i < SUITE_SAMPLES; i++) {
+        inputs[1][i] = 0.0f;
+        inputs[2][i] = (float)sin(6.283185307179586 * 110.0 * i / BENCH_SAMPLE_RATE);
+    }
+
+    struct Pedal {
+        const char* name;
+        HothouseEffect* effect;
+    };
+    const Pedal pedals[] = {
+        {"overdrive", &overdrive}, {"distortion", &distortion}, {"fuzz", &fuzz},
+        {"delay", &delay},         {"reverb", &reverb},         {"chorus", &chorus},
+        {"tremolo", &tremolo},     {"compressor", &compressor},
+    };
+    const int pedalCount = (int)(sizeof(pedals) / sizeof(pedals[0]));
+
+    HothouseDenormalGuard guard;  // As processBuffer() runs them
+    ClockOverhead overhead = measureOverhead();
+    fprintf(out, "{\n  \"sample_rate\": %d,\n  \"control_block\": %d,\n", BENCH_SAMPLE_RATE,
+            HOTHOUSE_CONTROL_BLOCK);
+#if defined(BENCH_HAS_CYCLES)
+    fprintf(out, "  \"cycle_counter\": \"rdtsc\",\n");
+#else
+    fprintf(out, "  \"cycle_counter\": null,\n");
+#endif
+    fprintf(out, "  \"clock_overhead_ns\": %.1f,\n  \"results\": [\n", overhead.ns);
+    fprintf(stderr, "%-11s %-7s %-10s %5s %9s %9s %9s\n", "pedal", "mode", "input", "block",
+            "median", "p99", "worst");
+
+    bool first = true;
+    for (int p = 0; p < pedalCount; p++) {
+        for (int mode = 0; mode < 3; mode++) {
+            for (int k = 0; k < SUITE_INPUT_COUNT; k++) {
+                for (int b = 0; b < SUITE_BLOCK_COUNT; b++) {
+                    runCase(out, first, pedals[p].name, *pedals[p].effect, mode, k, inputs[k], output,
+                            blockSizes[b], overhead);
+                }
+            }
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+    for (int k = 0; k < SUITE_INPUT_COUNT; k++) delete[] inputs[k];
+    delete[] output;
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Sample Rate Harness
+ *
+ * Runs every pedal at 32, 44.1, 48 and 96 kHz (built with
+ * HOTHOUSE_MAX_SAMPLE_RATE 96000) on the same guitar phrase and reports:
+ *   - output level against 48 kHz, which stays put when lengths and
+ *     coefficients follow the rate
+ *   - the Delay's echo time and the Reverb's first comb echo in ms
+ *   - ns/sample and the share of the sample period it takes
+ *   - fast and bulk memory per pedal at each rate
+ *
+ * Exits non-zero if a level moves by more than 0.5 dB, an echo by more
+ * than 0.1 ms, or any output is not finite.
+ */
+
+#define HOTHOUSE_MAX_SAMPLE_RATE 96000
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/distortion/distortion.cpp"
+#include "pedals/fuzz/fuzz.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/chorus/chorus.cpp"
+#include "pedals/tremolo/tremolo.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+
+#define RATE_COUNT 4
+#define RATE_BLOCK 32
+#define LEVEL_TOLERANCE_DB 0.5
+#define ECHO_TOLERANCE_MS 0.1
+#define ARENA_BYTES (4 * 1024 * 1024)
+
+static const int rates[RATE_COUNT] = {32000, 44100, 48000, 96000};
+
+alignas(HOTHOUSE_MEMORY_ALIGNMENT) static unsigned char fastMemory[ARENA_BYTES];
+alignas(HOTHOUSE_MEMORY_ALIGNMENT) static unsigned char bulkMemory[ARENA_BYTES];
+
+// Effects with buffers take the arena; the others only the rate
+template <typename Effect>
+static Effect* create(int rate, HothouseMemoryArena& arena, std::true_type) {
+    return new Effect(rate, arena);
+}
+
+template <typename Effect>
+static Effect* create(int rate, HothouseMemoryArena& arena, std::false_type) {
+    (void)arena;
+    return new Effect(rate);
+}
+
+template <typename Effect>
+static Effect* create(int rate, HothouseMemoryArena& arena) {
+    return create<Effect>(rate, arena, std::is_constructible<Effect, int, HothouseMemoryArena&>());
+}
+
+template <typename Effect>
+struct EffectRender {
+    Effect* effect;
+    void operator()(const float* in, float* out, int n) { effect->processBlock(in, out, n); }
+};
+
+struct RateResult {
+    double levelDb;
+    double ns;
+    size_t fastBytes;
+    size_t bulkBytes;
+    bool finite;
+};
+
+// Level in dB of the second half of a render of the guitar phrase
+template <typename Effect>
+static RateResult measure(int rate) {
+    HothouseMemoryArena arena(fastMemory, sizeof(fastMemory), bulkMemory, sizeof(bulkMemory));
+    Effect* effect = create<Effect>(rate, arena);
+    HothouseControls controls;
+    effect->updateFromControls(controls);
+
+    const int numSamples = rate * 2 / RATE_BLOCK * RATE_BLOCK;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)rate);
+    for (int i = 0; i < numSamples; i += RATE_BLOCK) {
+        effect->processBlock(input + i, output + i, RATE_BLOCK);
+    }
+
+    RateResult result;
+    double energy = 0.0;
+    result.finite = true;
+    for (int i = 0; i < numSamples; i++) {
+        if (!(fabsf(output[i]) < 1e6f)) result.finite = false;
+        if (i >= numSamples / 2) energy += (double)output[i] * output[i];
+    }
+    result.levelDb = 10.0 * log10(energy / (numSamples / 2) + 1e-30);
+    EffectRender<Effect> render = {effect};
+    result.ns = benchNsPerSample(render, input, output, numSamples, RATE_BLOCK);
+    result.fastBytes = arena.getRegion(MEMORY_FAST).getUsed();
+    result.bulkBytes = arena.getRegion(MEMORY_BULK).getUsed();
+    delete[] input;
+    delete[] output;
+    delete effect;
+    return result;
+}
+
+template <typename Effect>
+static bool reportPedal(const char* name) {
+    RateResult results[RATE_COUNT];
+    for (int r = 0; r < RATE_COUNT; r++) results[r] = measure<Effect>(rates[r]);
+    const double reference = results[2].levelDb;
+    bool ok = true;
+    for (int r = 0; r < RATE_COUNT; r++) {
+        double delta = results[r].levelDb - reference;
+        bool rateOk = results[r].finite && fabs(delta) <= LEVEL_TOLERANCE_DB;
+        ok &= rateOk;
+        printf("%-11s %7d %10.2f %10.2f %8.3f%% %9d %9d  %s\n", r == 0 ? name : "", rates[r], delta,
+               results[r].ns, 100.0 * results[r].ns * rates[r] / 1e9, (int)(results[r].fastBytes / 1024),
+               (int)(results[r].bulkBytes / 1024), rateOk ? "ok" : "FAIL");
+    }
+    return ok;
+}
+
+// Time in ms of the first output sample above threshold after an impulse
+template <typename Effect>
+static double echoMs(int rate, const HothouseControls& controls, float threshold) {
+    HothouseMemoryArena arena(fastMemory, sizeof(fastMemory), bulkMemory, sizeof(bulkMemory));
+    Effect* effect = create<Effect>(rate, arena);
+    const int numSamples = rate * 2;
+    float block[RATE_BLOCK];
+    float output[RATE_BLOCK];
+    double found = -1.0;
+    // Let the smoothers settle on the controls first
+    effect->updateFromControls(controls);
+    for (int i = 0; i < rate / 2; i += RATE_BLOCK) {
+        for (int j = 0; j < RATE_BLOCK; j++) block[j] = 0.0f;
+        effect->processBlock(block, output, RATE_BLOCK);
+    }
+    for (int i = 0; i < numSamples && found < 0.0; i += RATE_BLOCK) {
+        for (int j = 0; j < RATE_BLOCK; j++) block[j] = i + j == 0 ? 1.0f : 0.0f;
+        effect->processBlock(block, output, RATE_BLOCK);
+        for (int j = 0; j < RATE_BLOCK; j++) {
+            if (i + j > 0 && fabsf(output[j]) > threshold) {
+                found = 1000.0 * (i + j) / rate;
+                break;
+            }
+        }
+    }
+    delete effect;
+    return found;
+}
+
+template <typename Effect>
+static bool reportEcho(const char* name, const HothouseControls& controls, float threshold) {
+    double ms[RATE_COUNT];
+    for (int r = 0; r < RATE_COUNT; r++) ms[r] = echoMs<Effect>(rates[r], controls, threshold);
+    bool ok = true;
+    printf("%-11s", name);
+    for (int r = 0; r < RATE_COUNT; r++) {
+        printf(" %10.2f", ms[r]);
+        ok &= ms[r] > 0.0 && fabs(ms[r] - ms[2]) <= ECHO_TOLERANCE_MS;
+    }
+    printf("  %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main() {
+    printf("%-11s %7s %10s %10s %9s %9s %9s\n", "pedal", "rate", "level dB", "ns/sample", "period",
+           "fast KB", "bulk KB");
+    bool ok = true;
+    ok &= reportPedal<Overdrive>("overdrive");
+    ok &= reportPedal<Distortion>("distortion");
+    ok &= reportPedal<Fuzz>("fuzz");
+    ok &= reportPedal<Delay>("delay");
+    ok &= reportPedal<Reverb>("reverb");
+    ok &= reportPedal<Chorus>("chorus");
+    ok &= reportPedal<Tremolo>("tremolo");
+    ok &= reportPedal<Compressor>("compressor");
+
+    // Wet only, no feedback, no pre-delay: the first echo is the delay
+    // time, and the reverb's shortest comb
+    HothouseControls controls;
+    controls.knobs[KNOB_1] = 0.3f;
+    controls.knobs[KNOB_2] = 0.0f;
+    controls.knobs[KNOB_3] = 0.0f;
+    controls.knobs[KNOB_6] = 1.0f;
+    printf("\n%-11s", "echo ms");
+    for (int r = 0; r < RATE_COUNT; r++) printf(" %10d", rates[r]);
+    printf("\n");
+    ok &= reportEcho<Delay>("delay", controls, 0.1f);
+    ok &= reportEcho<Reverb>("reverb", controls, 0.01f);
+
+    printf("\nsample rates: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Sine Table Benchmark and Accuracy Check
+ *
+ * Compares sineLookup() against sinf(2*pi*x):
+ *   - accuracy: max and RMS error over a dense phase sweep, checked
+ *     against the bound documented in hothouse.h
+ *   - speed: ns per value when rendering an LFO block
+ *
+ * Exits non-zero if the error bound is exceeded.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define SINE_CHECK_POINTS 10000000
+#define SINE_ERROR_BOUND 2.0e-5
+
+struct SinfLfo {
+    float phase;
+    float increment;
+    SinfLfo() : phase(0.0f), increment(5.0f / BENCH_SAMPLE_RATE) {}
+    void operator()(const float* in, float* out, int n) {
+        (void)in;
+        for (int i = 0; i < n; i++) {
+            out[i] = sinf(6.28318530718f * phase);
+            phase += increment;
+            if (phase >= 1.0f) phase -= 1.0f;
+        }
+    }
+};
+
+struct TableLfo {
+    float phase;
+    float increment;
+    TableLfo() : phase(0.0f), increment(5.0f / BENCH_SAMPLE_RATE) {}
+    void operator()(const float* in, float* out, int n) {
+        (void)in;
+        for (int i = 0; i < n; i++) {
+            out[i] = sineLookup(phase);
+            phase += increment;
+            if (phase >= 1.0f) phase -= 1.0f;
+        }
+    }
+};
+
+int main() {
+    // Accuracy against a double-precision reference
+    double maxError = 0.0;
+    double sumSquares = 0.0;
+    double sinfMaxError = 0.0;
+    for (int i = 0; i < SINE_CHECK_POINTS; i++) {
+        float phase = (float)i / (float)SINE_CHECK_POINTS;
+        double reference = sin(6.283185307179586 * (double)phase);
+        double error = fabs((double)sineLookup(phase) - reference);
+        double sinfError = fabs((double)sinf(6.28318530718f * phase) - reference);
+        if (error > maxError) maxError = error;
+        if (sinfError > sinfMaxError) sinfMaxError = sinfError;
+        sumSquares += error * error;
+    }
+    double rmsError = sqrt(sumSquares / SINE_CHECK_POINTS);
+
+    printf("table size:     %d (+1 guard)\n", SINE_TABLE_SIZE);
+    printf("max error:      %.3g (%.1f dB), bound %.3g\n", maxError, 20.0 * log10(maxError),
+           SINE_ERROR_BOUND);
+    printf("rms error:      %.3g (%.1f dB)\n", rmsError, 20.0 * log10(rmsError));
+    printf("sinf max error: %.3g (float argument rounding)\n", sinfMaxError);
+
+    // Speed
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    for (int i = 0; i < numSamples; i++) input[i] = 0.0f;
+
+    SinfLfo sinfLfo;
+    TableLfo tableLfo;
+    printf("\n%-10s %8s %12s\n", "lfo", "block", "ns/sample");
+    const int blockSizes[] = {4, 32};
+    for (int b = 0; b < 2; b++) {
+        printf("%-10s %8d %12.2f\n", "sinf", blockSizes[b],
+               benchNsPerSample(sinfLfo, input, output, numSamples, blockSizes[b]));
+        printf("%-10s %8d %12.2f\n", "table", blockSizes[b],
+               benchNsPerSample(tableLfo, input, output, numSamples, blockSizes[b]));
+    }
+
+    delete[] input;
+    delete[] output;
+
+    bool ok = maxError <= SINE_ERROR_BOUND;
+    printf("\n%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
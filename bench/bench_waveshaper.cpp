@@ -0,0 +1,111 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Waveshaper Benchmark
+ *
+ * For each clipping voice of Overdrive, Distortion and Fuzz:
+ *   - curve:  the hand-coded branchy function, per sample, behind a
+ *             runtime switch on the voice (what the pedals did before)
+ *   - table:  Waveshaper::processBlock() on the baked curve
+ * in ns/sample at 32-sample blocks, plus the worst-case and RMS table
+ * error against the curve for a guitar signal at 20x gain.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#define SHAPER_GAIN 20.0f
+#define SHAPER_VOICES 7
+
+static float hardClip(float x, float threshold) {
+    if (x > threshold) return threshold;
+    if (x < -threshold) return -threshold;
+    return x;
+}
+
+static float softClip(float x) {
+    if (x > 1.0f) return 0.76159f;
+    if (x < -1.0f) return -0.76159f;
+    float x2 = x * x;
+    return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
+
+static float vintageClip(float x) {
+    if (x > 0.5f) return 0.5f + (x - 0.5f) * 0.1f;
+    if (x < -0.6f) return -0.6f + (x + 0.6f) * 0.15f;
+    return x;
+}
+
+static float octaveClip(float x) {
+    float rectified = fabsf(x);
+    if (rectified > 0.5f) rectified = 0.5f;
+    return rectified * (x > 0 ? 1.0f : -1.0f) * 0.5f + x * 0.5f;
+}
+
+// Voices in pedal order, with the table range each pedal bakes
+static const char* voiceNames[SHAPER_VOICES] = {
+    "overdrive", "dist hard", "dist medium", "dist soft", "fuzz vintage", "fuzz modern",
+    "fuzz octave"};
+static const float voiceRanges[SHAPER_VOICES] = {1.5f, 1.0f, 1.0f, 3.0f, 1.0f, 0.5f, 1.0f};
+
+static float curve(int voice, float x) {
+    switch (voice) {
+        case 0: return softClip(x);
+        case 1: return hardClip(x, 0.7f);
+        case 2: return softClip(hardClip(x, 0.85f) * 0.8f);
+        case 3: return softClip(x * 0.5f);
+        case 4: return vintageClip(x);
+        case 5: return hardClip(x, 0.4f);
+        default: return octaveClip(x);
+    }
+}
+
+struct CurveRender {
+    int voice;
+    void operator()(const float* in, float* out, int n) {
+        for (int i = 0; i < n; i++) out[i] = curve(voice, in[i]);
+    }
+};
+
+struct TableRender {
+    const Waveshaper* shaper;
+    void operator()(const float* in, float* out, int n) {
+        shaper->processBlock(in, out, n);
+    }
+};
+
+int main() {
+    const int numSamples = BENCH_SAMPLE_RATE * 10;
+    float* input = new float[numSamples];
+    float* output = new float[numSamples];
+    benchFillGuitar(input, numSamples, (float)BENCH_SAMPLE_RATE);
+    for (int i = 0; i < numSamples; i++) input[i] *= SHAPER_GAIN;
+
+    printf("%-14s %12s %12s %12s %12s\n", "voice", "curve ns", "table ns", "max error",
+           "rms error");
+    for (int v = 0; v < SHAPER_VOICES; v++) {
+        static Waveshaper shaper;
+        shaper.init(hothouseDefaultArena(), MEMORY_FAST);
+        int voice = v;
+        shaper.bake([voice](float x) { return curve(voice, x); }, voiceRanges[v]);
+
+        CurveRender curveRender = {v};
+        TableRender tableRender = {&shaper};
+        double curveNs = benchNsPerSample(curveRender, input, output, numSamples, 32);
+        double tableNs = benchNsPerSample(tableRender, input, output, numSamples, 32);
+
+        shaper.processBlock(input, output, numSamples);
+        double maxError = 0.0;
+        double sumSquares = 0.0;
+        for (int i = 0; i < numSamples; i++) {
+            double error = fabs((double)output[i] - curve(v, input[i]));
+            if (error > maxError) maxError = error;
+            sumSquares += error * error;
+        }
+        printf("%-14s %12.2f %12.2f %12.2e %12.2e\n", voiceNames[v], curveNs, tableNs, maxError,
+               sqrt(sumSquares / numSamples));
+    }
+
+    delete[] input;
+    delete[] output;
+    return 0;
+}
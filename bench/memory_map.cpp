@@ -0,0 +1,222 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Memory Map
+ *
+ * Builds a chain of pedals on an arena the size of the default one (or of
+ * --fast / --bulk bytes, to try another board) and prints where it went:
+ *   - per effect: the object's own size, what it requests from each region
+ *     at compile time (arenaBytes()) and what it took at run time
+ *     (getMemoryUsage()), with its offset in each region
+ *   - region totals against capacity, and a map of each region
+ *   - the compile-time footprint of a StaticChain, for comparison
+ *
+ *   ./build/memory_map [--fast bytes] [--bulk bytes] [name[,name...]]
+ *     names: overdrive, distortion, fuzz, delay, reverb, chorus, tremolo,
+ *     compressor (default: all of them, in that order)
+ *
+ * Exits non-zero if an effect's run-time usage differs from its
+ * compile-time request, other than FAST spilling into BULK, or if the
+ * arena ran out.
+ */
+
+#include "hothouse.h"
+#include "pedals/overdrive/overdrive.cpp"
+#include "pedals/distortion/distortion.cpp"
+#include "pedals/fuzz/fuzz.cpp"
+#include "pedals/delay/delay.cpp"
+#include "pedals/reverb/reverb.cpp"
+#include "pedals/chorus/chorus.cpp"
+#include "pedals/tremolo/tremolo.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define MAP_WIDTH 64
+#define DEFAULT_CHAIN "overdrive,distortion,fuzz,delay,reverb,chorus,tremolo,compressor"
+
+typedef StaticChain<Compressor, Overdrive, Delay> ExampleRig;
+
+static_assert(hothouseFitsMemory<Compressor, Overdrive, Delay>(HOTHOUSE_FAST_MEMORY_BYTES,
+                                                               HOTHOUSE_BULK_MEMORY_BYTES),
+              "the example rig must fit the default arena without spilling");
+
+struct Placement {
+    std::string name;
+    HothouseEffect* effect;
+    size_t request[MEMORY_REGION_COUNT];  // Compile time
+    size_t offset[MEMORY_REGION_COUNT];   // Where its buffers start
+    HothouseMemoryUsage usage;            // Run time
+};
+
+// Effects with buffers take the arena; the others only the rate
+template <typename Effect>
+static Effect* create(HothouseMemoryArena& arena, std::true_type) {
+    return new Effect(BENCH_SAMPLE_RATE, arena);
+}
+
+template <typename Effect>
+static Effect* create(HothouseMemoryArena& arena, std::false_type) {
+    (void)arena;
+    return new Effect(BENCH_SAMPLE_RATE);
+}
+
+template <typename Effect>
+static bool place(const std::string& wanted, const char* name, HothouseMemoryArena& arena,
+                  Placement& placement) {
+    if (wanted != name) return false;
+    for (int r = 0; r < MEMORY_REGION_COUNT; r++) {
+        placement.request[r] = Effect::arenaBytes((MemoryRegion)r);
+        placement.offset[r] = hothouseArenaBytes(arena.getRegion((MemoryRegion)r).getUsed());
+    }
+    placement.effect =
+        create<Effect>(arena, std::is_constructible<Effect, int, HothouseMemoryArena&>());
+    placement.usage = placement.effect->getMemoryUsage();
+    return true;
+}
+
+static bool placeEffect(const std::string& name, HothouseMemoryArena& arena, Placement& placement) {
+    placement.name = name;
+    return place<Overdrive>(name, "overdrive", arena, placement) ||
+           place<Distortion>(name, "distortion", arena, placement) ||
+           place<Fuzz>(name, "fuzz", arena, placement) ||
+           place<Delay>(name, "delay", arena, placement) ||
+           place<Reverb>(name, "reverb", arena, placement) ||
+           place<Chorus>(name, "chorus", arena, placement) ||
+           place<Tremolo>(name, "tremolo", arena, placement) ||
+           place<Compressor>(name, "compressor", arena, placement);
+}
+
+// Run-time usage must be the compile-time request, with any part of the
+// FAST request moved to BULK
+static bool matchesRequest(const Placement& p) {
+    return p.usage.objectBytes > 0 && p.usage.fastBytes <= p.request[MEMORY_FAST] &&
+           p.usage.fastBytes + p.usage.bulkBytes == p.request[MEMORY_FAST] + p.request[MEMORY_BULK];
+}
+
+static void printOffset(const Placement& p, MemoryRegion region) {
+    if (p.usage.getRegion(region) == 0) {
+        printf(" %10s", "-");
+    } else {
+        printf(" %10zu", p.offset[region]);
+    }
+}
+
+// One letter per effect, for the cell it covers most of; '.' is free
+static void printMap(const std::vector<Placement>& placements, HothouseMemoryArena& arena,
+                     MemoryRegion region) {
+    HothouseMemoryRegion& memory = arena.getRegion(region);
+    const double cell = (double)memory.getCapacity() / MAP_WIDTH;
+    char line[MAP_WIDTH + 1];
+    for (int c = 0; c < MAP_WIDTH; c++) {
+        double from = c * cell;
+        double to = from + cell;
+        double most = 0.0;
+        line[c] = '.';
+        for (size_t e = 0; e < placements.size(); e++) {
+            double start = (double)placements[e].offset[region];
+            double end = start + placements[e].usage.getRegion(region);
+            double overlap = std::min(to, end) - std::max(from, start);
+            if (overlap > most) {
+                most = overlap;
+                line[c] = (char)('A' + e);
+            }
+        }
+    }
+    line[MAP_WIDTH] = '\0';
+    printf("  %-5s |%s| %zu KB, %.0f bytes per cell\n", memory.getName(), line,
+           memory.getCapacity() / 1024, cell);
+}
+
+static void usage() {
+    fprintf(stderr, "usage: memory_map [--fast bytes] [--bulk bytes] [name[,name...]]\n");
+}
+
+int main(int argc, char** argv) {
+    size_t fastBytes = HOTHOUSE_FAST_MEMORY_BYTES;
+    size_t bulkBytes = HOTHOUSE_BULK_MEMORY_BYTES;
+    std::string chainNames = DEFAULT_CHAIN;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--fast" || arg == "--bulk") && i + 1 < argc) {
+            size_t bytes = (size_t)strtoull(argv[++i], nullptr, 0);
+            (arg == "--fast" ? fastBytes : bulkBytes) = bytes;
+        } else if (arg[0] != '-') {
+            chainNames = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    // Regions padded so their start can be aligned
+    std::vector<unsigned char> fastStorage(fastBytes + HOTHOUSE_MEMORY_ALIGNMENT);
+    std::vector<unsigned char> bulkStorage(bulkBytes + HOTHOUSE_MEMORY_ALIGNMENT);
+    unsigned char* fastMemory = fastStorage.data() + (HOTHOUSE_MEMORY_ALIGNMENT -
+        (size_t)fastStorage.data() % HOTHOUSE_MEMORY_ALIGNMENT) % HOTHOUSE_MEMORY_ALIGNMENT;
+    unsigned char* bulkMemory = bulkStorage.data() + (HOTHOUSE_MEMORY_ALIGNMENT -
+        (size_t)bulkStorage.data() % HOTHOUSE_MEMORY_ALIGNMENT) % HOTHOUSE_MEMORY_ALIGNMENT;
+    HothouseMemoryArena arena(fastMemory, fastBytes, bulkMemory, bulkBytes);
+
+    std::vector<Placement> placements;
+    size_t start = 0;
+    while (start <= chainNames.size()) {
+        size_t comma = chainNames.find(',', start);
+        if (comma == std::string::npos) comma = chainNames.size();
+        Placement placement;
+        if (!placeEffect(chainNames.substr(start, comma - start), arena, placement) ||
+            (int)placements.size() >= MAX_CHAIN_EFFECTS) {
+            fprintf(stderr, "unknown effect or too many stages: %s\n",
+                    chainNames.substr(start, comma - start).c_str());
+            return 2;
+        }
+        placements.push_back(placement);
+        start = comma + 1;
+    }
+
+    EffectChain chain;
+    for (size_t e = 0; e < placements.size(); e++) chain.addEffect(placements[e].effect);
+
+    bool ok = !arena.hasFailed();
+    printf("%-3s %-11s %9s %11s %11s %11s %11s %10s %10s\n", "", "effect", "object", "fast req",
+           "bulk req", "fast used", "bulk used", "fast at", "bulk at");
+    for (size_t e = 0; e < placements.size(); e++) {
+        const Placement& p = placements[e];
+        bool matches = matchesRequest(p);
+        ok &= matches;
+        printf("%c   %-11s %9zu %11zu %11zu %11zu %11zu", (char)('A' + e), p.name.c_str(),
+               p.usage.objectBytes, p.request[MEMORY_FAST], p.request[MEMORY_BULK], p.usage.fastBytes,
+               p.usage.bulkBytes);
+        printOffset(p, MEMORY_FAST);
+        printOffset(p, MEMORY_BULK);
+        printf("%s%s\n", p.usage.fastBytes < p.request[MEMORY_FAST] ? "  spilled" : "",
+               matches ? "" : "  MISMATCH");
+    }
+    HothouseMemoryUsage total = chain.getMemoryUsage();
+    printf("%-3s %-11s %9zu %11s %11s %11zu %11zu\n", "", "chain", total.objectBytes, "", "",
+           total.fastBytes, total.bulkBytes);
+    printf("(chain object: EffectChain, %zu bytes, plus the effects)\n", sizeof(EffectChain));
+
+    printf("\n%-7s %10s %10s %10s %7s %8s\n", "region", "capacity", "used", "free", "used", "failed");
+    for (int r = 0; r < MEMORY_REGION_COUNT; r++) {
+        HothouseMemoryRegion& memory = arena.getRegion((MemoryRegion)r);
+        printf("%-7s %10zu %10zu %10zu %6.1f%% %8d\n", memory.getName(), memory.getCapacity(),
+               memory.getUsed(), memory.getCapacity() - memory.getUsed(),
+               100.0 * memory.getUsed() / memory.getCapacity(), memory.getFailedAllocations());
+    }
+
+    printf("\nmap\n");
+    printMap(placements, arena, MEMORY_FAST);
+    printMap(placements, arena, MEMORY_BULK);
+
+    printf("\ncompile time: StaticChain<Compressor, Overdrive, Delay>\n");
+    printf("  object %zu, fast %zu, bulk %zu (effects' own objects: %zu)\n", sizeof(ExampleRig),
+           ExampleRig::arenaBytes(MEMORY_FAST), ExampleRig::arenaBytes(MEMORY_BULK),
+           HothouseMemoryFootprint<Compressor, Overdrive, Delay>::objectBytes());
+
+    for (size_t e = 0; e < placements.size(); e++) delete placements[e].effect;
+
+    printf("\nmemory map: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
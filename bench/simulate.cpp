@@ -0,0 +1,574 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Real-Time Callback Simulator
+ *
+ * Runs deploy.cpp's audioCallback() the way the codec's DMA interrupt
+ * would: on a SCHED_FIFO thread, once every bufferSize / sampleRate
+ * (83.3 us for 4 samples at 48 kHz), on a fixed grid of absolute start
+ * times. The calling thread plays the main loop, publishing controls
+ * through the control mailbox at 1 kHz and applying a timeline of
+ * control changes as the audio reaches them.
+ *
+ * For every callback it records the start jitter (actual start against
+ * the grid), the execution time and whether it finished after its
+ * deadline (the next grid point). A callback that starts a whole period
+ * late has lost its buffer: the grid moves on and the skipped buffers
+ * are counted as dropped. Results are printed as histograms, with the
+ * pedal's own per-stage load report.
+ *
+ *   ./build/simulate [options]
+ *     --effect name[,name...]  overdrive, distortion, fuzz, delay, reverb,
+ *                              chorus, tremolo, compressor; several make an
+ *                              EffectChain (default overdrive)
+ *     --input file.wav         mono or first channel; 16/24/32-bit PCM or
+ *                              float (default: synthetic guitar)
+ *     --output file.wav        write the processed audio (32-bit float)
+ *     --controls file          control timeline, see below
+ *     --seconds s              run time (default: the input's length, or 10)
+ *     --buffer n               samples per callback (default 4)
+ *     --rate hz                sample rate without an input file (default 48000)
+ *     --spin-us us             busy-wait this long before each start instead
+ *                              of sleeping, to beat wake-up latency (default 20)
+ *
+ * Control timeline, one event per line, '#' starts a comment:
+ *     0.0   knob1        0.8      (knob1-knob6, 0.0 to 1.0)
+ *     2.5   toggle1      down     (toggle1-toggle3: up, middle, down)
+ *     4.0   footswitch1  press    (footswitch1-footswitch2)
+ *
+ * SCHED_FIFO needs root or CAP_SYS_NICE; without it the simulator runs
+ * at normal priority and says so. Run it on an otherwise idle multi-core
+ * host: on one CPU, or once the kernel's real-time throttling
+ * (sched_rt_runtime_us) pauses the thread, the host itself drops buffers.
+ * Exits non-zero if any deadline was missed or a buffer dropped.
+ */
+
+#define HOTHOUSE_HOST_SIMULATION
+#include "deploy.cpp"
+#include "bench/bench.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SIM_DEFAULT_SECONDS 10.0
+#define SIM_MAIN_LOOP_NS 1000000     // Control publish interval (1 kHz)
+#define SIM_HISTOGRAM_BINS 14        // Upper edges 0.5 us .. 2048 us, then overflow
+#define SIM_BAR_WIDTH 40
+
+struct SimOptions {
+    std::string effects;
+    std::string inputPath;
+    std::string outputPath;
+    std::string controlsPath;
+    double seconds;
+    int bufferSize;
+    int sampleRate;
+    int spinNs;
+
+    SimOptions()
+        : effects("overdrive"), seconds(0.0), bufferSize(4), sampleRate(48000), spinNs(20000) {}
+};
+
+struct ControlEvent {
+    enum Kind { KNOB, TOGGLE, FOOTSWITCH };
+
+    double seconds;
+    Kind kind;
+    int index;
+    float value;  // Knob position or ToggleswitchPosition
+};
+
+static int64_t simNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Sleep until (spinNs before) an absolute time, then spin up to it
+static void waitUntil(int64_t target, int spinNs) {
+    int64_t wake = target - spinNs;
+    if (simNowNs() < wake) {
+        struct timespec until;
+        until.tv_sec = (time_t)(wake / 1000000000);
+        until.tv_nsec = (long)(wake % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) != 0) {
+        }
+    }
+    while (simNowNs() < target) {
+    }
+}
+
+/**
+ * Read a little-endian integer from a byte buffer
+ */
+static uint32_t readLe(const unsigned char* bytes, int count) {
+    uint32_t value = 0;
+    for (int i = count - 1; i >= 0; i--) value = (value << 8) | bytes[i];
+    return value;
+}
+
+static void writeLe(FILE* file, uint32_t value, int count) {
+    for (int i = 0; i < count; i++) fputc((int)((value >> (8 * i)) & 0xFF), file);
+}
+
+/**
+ * Load the first channel of a PCM (16/24/32-bit) or float WAV file
+ */
+static bool loadWav(const char* path, std::vector<float>& samples, int& sampleRate) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    std::vector<unsigned char> bytes;
+    unsigned char chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + got);
+    fclose(file);
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        return false;
+    }
+
+    int format = 0;
+    int channels = 0;
+    int bits = 0;
+    size_t offset = 12;
+    while (offset + 8 <= bytes.size()) {
+        size_t size = readLe(&bytes[offset + 4], 4);
+        const unsigned char* body = &bytes[offset + 8];
+        if (offset + 8 + size > bytes.size()) size = bytes.size() - offset - 8;
+        if (memcmp(&bytes[offset], "fmt ", 4) == 0 && size >= 16) {
+            format = (int)readLe(body, 2);
+            channels = (int)readLe(body + 2, 2);
+            sampleRate = (int)readLe(body + 4, 4);
+            bits = (int)readLe(body + 14, 2);
+            if (format == 0xFFFE && size >= 26) format = (int)readLe(body + 24, 2);  // Extensible
+        } else if (memcmp(&bytes[offset], "data", 4) == 0 && channels > 0) {
+            const int frameBytes = channels * bits / 8;
+            const size_t frames = frameBytes > 0 ? size / frameBytes : 0;
+            samples.resize(frames);
+            for (size_t i = 0; i < frames; i++) {
+                const unsigned char* sample = body + i * frameBytes;
+                if (format == 3 && bits == 32) {
+                    uint32_t word = readLe(sample, 4);
+                    memcpy(&samples[i], &word, 4);
+                } else if (format == 1 && (bits == 16 || bits == 24 || bits == 32)) {
+                    uint32_t word = readLe(sample, bits / 8) << (32 - bits);
+                    samples[i] = (float)(int32_t)word / 2147483648.0f;
+                } else {
+                    return false;
+                }
+            }
+            return frames > 0;
+        }
+        offset += 8 + size + (size & 1);
+    }
+    return false;
+}
+
+static bool saveWav(const char* path, const float* samples, int numSamples, int sampleRate) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return false;
+    const uint32_t dataBytes = (uint32_t)numSamples * 4;
+    fwrite("RIFF", 1, 4, file);
+    writeLe(file, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLe(file, 16, 4);
+    writeLe(file, 3, 2);  // IEEE float
+    writeLe(file, 1, 2);
+    writeLe(file, (uint32_t)sampleRate, 4);
+    writeLe(file, (uint32_t)sampleRate * 4, 4);
+    writeLe(file, 4, 2);
+    writeLe(file, 32, 2);
+    fwrite("data", 1, 4, file);
+    writeLe(file, dataBytes, 4);
+    fwrite(samples, 4, (size_t)numSamples, file);
+    fclose(file);
+    return true;
+}
+
+/**
+ * Parse one "seconds control value" line into an event
+ */
+static bool parseEvent(const char* line, ControlEvent& event) {
+    char control[32];
+    char value[32];
+    if (sscanf(line, "%lf %31s %31s", &event.seconds, control, value) != 3) return false;
+    int index = 0;
+    if (sscanf(control, "knob%d", &index) == 1 && index >= 1 && index <= KNOB_COUNT) {
+        event.kind = ControlEvent::KNOB;
+        event.index = index - 1;
+        event.value = (float)atof(value);
+        return true;
+    }
+    if (sscanf(control, "toggle%d", &index) == 1 && index >= 1 && index <= TOGGLESWITCH_COUNT) {
+        event.kind = ControlEvent::TOGGLE;
+        event.index = index - 1;
+        if (strcmp(value, "up") == 0) {
+            event.value = (float)TOGGLESWITCH_UP;
+        } else if (strcmp(value, "middle") == 0) {
+            event.value = (float)TOGGLESWITCH_MIDDLE;
+        } else if (strcmp(value, "down") == 0) {
+            event.value = (float)TOGGLESWITCH_DOWN;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (sscanf(control, "footswitch%d", &index) == 1 && index >= 1 && index <= FOOTSWITCH_COUNT &&
+        strcmp(value, "press") == 0) {
+        event.kind = ControlEvent::FOOTSWITCH;
+        event.index = index - 1;
+        event.value = 1.0f;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Read a control timeline, sorted by time
+ */
+static bool loadTimeline(const char* path, std::vector<ControlEvent>& events) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return false;
+    }
+    char line[256];
+    int number = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        number++;
+        char* comment = strchr(line, '#');
+        if (comment != nullptr) *comment = '\0';
+        const char* text = line;
+        while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') text++;
+        if (*text == '\0') continue;
+        ControlEvent event;
+        if (!parseEvent(text, event)) {
+            fprintf(stderr, "%s:%d: expected \"seconds control value\"\n", path, number);
+            fclose(file);
+            return false;
+        }
+        events.push_back(event);
+    }
+    fclose(file);
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ControlEvent& a, const ControlEvent& b) { return a.seconds < b.seconds; });
+    return true;
+}
+
+static void applyEvent(const ControlEvent& event, HothouseControls& controls) {
+    switch (event.kind) {
+        case ControlEvent::KNOB:
+            controls.knobs[event.index] = constrain(event.value, 0.0f, 1.0f);
+            break;
+        case ControlEvent::TOGGLE:
+            controls.toggles[event.index] = (ToggleswitchPosition)(int)event.value;
+            break;
+        case ControlEvent::FOOTSWITCH:
+            controls.footswitchRisingEdge[event.index] = true;
+            break;
+    }
+}
+
+static HothouseEffect* createEffect(const std::string& name, int sampleRate) {
+    if (name == "overdrive") return new Overdrive(sampleRate);
+    if (name == "distortion") return new Distortion(sampleRate);
+    if (name == "fuzz") return new Fuzz(sampleRate);
+    if (name == "delay") return new Delay(sampleRate);
+    if (name == "reverb") return new Reverb(sampleRate);
+    if (name == "chorus") return new Chorus(sampleRate);
+    if (name == "tremolo") return new Tremolo(sampleRate);
+    if (name == "compressor") return new Compressor(sampleRate);
+    return nullptr;
+}
+
+/**
+ * State shared by the audio thread and the main loop
+ * Everything the audio thread writes is allocated before it starts.
+ */
+struct SimRun {
+    HothousePedal* pedal;
+    const float* input;
+    int inputLength;
+    float* output;  // Dropped buffers stay silent
+    int bufferSize;
+    long numSlots;  // Callback periods in the run
+    double periodNs;
+    int spinNs;
+
+    std::vector<int64_t> jitter;     // Per callback run
+    std::vector<int64_t> execution;  // Per callback run
+    std::vector<int> missesPerSecond;
+    long callbacks;
+    long missed;
+    long dropped;
+    bool realtime;
+
+    std::atomic<long> position;  // Input samples reached, for the timeline
+    std::atomic<bool> done;
+
+    SimRun() : callbacks(0), missed(0), dropped(0), realtime(false), position(0), done(false) {}
+};
+
+/**
+ * The DMA interrupt: audioCallback() on a fixed grid of start times
+ */
+static void audioThread(SimRun* run) {
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    run->realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+
+    std::vector<float> inputBuffer(run->bufferSize);
+    std::vector<float> outputBuffer(run->bufferSize);
+    const int64_t origin = simNowNs() + SIM_MAIN_LOOP_NS;
+
+    long slot = 0;
+    while (slot < run->numSlots) {
+        int64_t scheduled = origin + (int64_t)(slot * run->periodNs);
+        waitUntil(scheduled, run->spinNs);
+        int64_t started = simNowNs();
+
+        // Starting a whole period late means the codec has moved on
+        long late = (long)((started - scheduled) / run->periodNs);
+        if (late > 0) {
+            if (slot + late >= run->numSlots) late = run->numSlots - slot;
+            run->dropped += late;
+            slot += late;
+            if (slot >= run->numSlots) break;
+            scheduled = origin + (int64_t)(slot * run->periodNs);
+        }
+
+        const long offset = slot * run->bufferSize;
+        for (int i = 0; i < run->bufferSize; i++) {
+            inputBuffer[i] = run->input[(offset + i) % run->inputLength];
+        }
+        audioCallback(inputBuffer.data(), outputBuffer.data(), run->bufferSize, *run->pedal);
+        int64_t finished = simNowNs();
+
+        memcpy(run->output + offset, outputBuffer.data(), sizeof(float) * run->bufferSize);
+        run->jitter[run->callbacks] = started - scheduled;
+        run->execution[run->callbacks] = finished - started;
+        run->callbacks++;
+        if (finished - scheduled > (int64_t)run->periodNs) {
+            run->missed++;
+            run->missesPerSecond[(size_t)(slot * run->periodNs / 1e9)]++;  // By elapsed time
+        }
+        slot++;
+        run->position.store(slot * run->bufferSize, std::memory_order_relaxed);
+    }
+    run->done.store(true, std::memory_order_release);
+}
+
+/**
+ * Power-of-two histogram in microseconds, with p50/p99/max
+ */
+static void printHistogram(const char* title, std::vector<int64_t> values, double periodNs) {
+    long counts[SIM_HISTOGRAM_BINS + 1] = {0};
+    for (size_t i = 0; i < values.size(); i++) {
+        int bin = 0;
+        double edge = 500.0;
+        while (bin < SIM_HISTOGRAM_BINS && (double)values[i] >= edge) {
+            bin++;
+            edge *= 2.0;
+        }
+        counts[bin]++;
+    }
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    printf("\n%s (us): p50 %.2f  p99 %.2f  max %.2f  (period %.2f)\n", title, values[n / 2] / 1000.0,
+           values[n * 99 / 100] / 1000.0, values[n - 1] / 1000.0, periodNs / 1000.0);
+
+    int last = 0;
+    long largest = 1;
+    for (int b = 0; b <= SIM_HISTOGRAM_BINS; b++) {
+        if (counts[b] > 0) last = b;
+        if (counts[b] > largest) largest = counts[b];
+    }
+    double edge = 0.5;
+    for (int b = 0; b <= last; b++) {
+        char label[32];
+        if (b < SIM_HISTOGRAM_BINS) {
+            snprintf(label, sizeof(label), "< %g", edge);
+        } else {
+            snprintf(label, sizeof(label), ">= %g", edge / 2.0);
+        }
+        int bar = (int)((double)SIM_BAR_WIDTH * counts[b] / largest + 0.999);
+        printf("  %9s %10ld %7.3f%%  %s%s\n", label, counts[b], 100.0 * counts[b] / n,
+               std::string(bar, '#').c_str(), edge / 2.0 < periodNs / 1000.0 && periodNs / 1000.0 <= edge
+                                                  ? "  <- period" : "");
+        edge *= 2.0;
+    }
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: simulate [--effect name[,name...]] [--input file.wav] [--output file.wav]\n"
+            "                [--controls file] [--seconds s] [--buffer n] [--rate hz] [--spin-us us]\n");
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (flag == "--effect") {
+            options.effects = value;
+        } else if (flag == "--input") {
+            options.inputPath = value;
+        } else if (flag == "--output") {
+            options.outputPath = value;
+        } else if (flag == "--controls") {
+            options.controlsPath = value;
+        } else if (flag == "--seconds") {
+            options.seconds = atof(value);
+        } else if (flag == "--buffer") {
+            options.bufferSize = atoi(value);
+        } else if (flag == "--rate") {
+            options.sampleRate = atoi(value);
+        } else if (flag == "--spin-us") {
+            options.spinNs = (int)(atof(value) * 1000.0);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (options.bufferSize < 1 || options.sampleRate < 1) {
+        usage();
+        return 2;
+    }
+
+    // Input: a file, or the benchmarks' guitar phrase
+    std::vector<float> input;
+    if (!options.inputPath.empty()) {
+        if (!loadWav(options.inputPath.c_str(), input, options.sampleRate)) {
+            fprintf(stderr, "cannot read %s as a PCM or float WAV file\n", options.inputPath.c_str());
+            return 2;
+        }
+        if (options.seconds <= 0.0) options.seconds = (double)input.size() / options.sampleRate;
+    } else {
+        if (options.seconds <= 0.0) options.seconds = SIM_DEFAULT_SECONDS;
+        input.resize((size_t)(options.sampleRate * 4));
+        benchFillGuitar(input.data(), (int)input.size(), (float)options.sampleRate);
+    }
+
+    std::vector<ControlEvent> events;
+    if (!options.controlsPath.empty() && !loadTimeline(options.controlsPath.c_str(), events)) {
+        return 2;
+    }
+
+    // Effect or chain
+    std::vector<std::string> names;
+    std::vector<HothouseEffect*> effects;
+    size_t start = 0;
+    while (start <= options.effects.size()) {
+        size_t comma = options.effects.find(',', start);
+        if (comma == std::string::npos) comma = options.effects.size();
+        names.push_back(options.effects.substr(start, comma - start));
+        HothouseEffect* effect = createEffect(names.back(), options.sampleRate);
+        if (effect == nullptr || (int)effects.size() >= MAX_CHAIN_EFFECTS) {
+            fprintf(stderr, "unknown effect or too many stages: %s\n", names.back().c_str());
+            return 2;
+        }
+        effects.push_back(effect);
+        start = comma + 1;
+    }
+    if (hothouseDefaultArena().hasFailed()) {
+        fprintf(stderr, "effects do not fit in the memory arena\n");
+        return 2;
+    }
+    EffectChain chain(effects.data(), (int)effects.size());
+
+    HothouseConfig config;
+    config.sampleRate = options.sampleRate;
+    config.bufferSize = options.bufferSize;
+    HothousePedal pedal(config);
+    pedal.setEffect(effects.size() == 1 ? effects[0] : &chain);
+    pedal.enableLoadMeter(HothouseCycleCounter::clock());
+
+    SimRun run;
+    run.pedal = &pedal;
+    run.input = input.data();
+    run.inputLength = (int)input.size();
+    run.bufferSize = options.bufferSize;
+    run.numSlots = (long)(options.seconds * options.sampleRate / options.bufferSize);
+    run.periodNs = 1e9 * options.bufferSize / options.sampleRate;
+    run.spinNs = options.spinNs;
+    if (run.numSlots < 1) {
+        usage();
+        return 2;
+    }
+    std::vector<float> output((size_t)run.numSlots * options.bufferSize, 0.0f);
+    run.output = output.data();
+    run.jitter.resize(run.numSlots);
+    run.execution.resize(run.numSlots);
+    run.missesPerSecond.resize((size_t)options.seconds + 2);
+
+    // Controls as of time zero, then the audio thread
+    HothouseControls controls;
+    size_t nextEvent = 0;
+    while (nextEvent < events.size() && events[nextEvent].seconds <= 0.0) {
+        applyEvent(events[nextEvent++], controls);
+    }
+    controlMailbox.publish(controls);
+    mlockall(MCL_CURRENT | MCL_FUTURE);
+    std::thread audio(audioThread, &run);
+
+    // Main loop: publish controls at 1 kHz, applying events as the audio reaches them
+    while (!run.done.load(std::memory_order_acquire)) {
+        struct timespec pause = {0, SIM_MAIN_LOOP_NS};
+        nanosleep(&pause, nullptr);
+        for (int i = 0; i < FOOTSWITCH_COUNT; i++) controls.footswitchRisingEdge[i] = false;
+        double audioSeconds = (double)run.position.load(std::memory_order_relaxed) / options.sampleRate;
+        while (nextEvent < events.size() && events[nextEvent].seconds <= audioSeconds) {
+            applyEvent(events[nextEvent++], controls);
+        }
+        controlMailbox.publish(controls);
+    }
+    audio.join();
+
+    printf("%s: %d samples at %d Hz (period %.2f us), %.1f s, %s, %u CPU(s), %d control events\n",
+           options.effects.c_str(), options.bufferSize, options.sampleRate, run.periodNs / 1000.0,
+           options.seconds, run.realtime ? "SCHED_FIFO" : "normal priority (SCHED_FIFO not permitted)",
+           std::thread::hardware_concurrency(), (int)events.size());
+    printf("callbacks %ld, missed deadlines %ld, dropped buffers %ld\n", run.callbacks, run.missed,
+           run.dropped);
+    if (run.callbacks > 0) {
+        run.jitter.resize(run.callbacks);
+        run.execution.resize(run.callbacks);
+        printHistogram("start jitter", run.jitter, run.periodNs);
+        printHistogram("execution time", run.execution, run.periodNs);
+    }
+
+    printf("\nmissed deadlines per second:");
+    if (run.missed == 0) printf(" none");
+    printf("\n");
+    for (size_t s = 0; run.missed > 0 && s < run.missesPerSecond.size(); s++) {
+        if (run.missesPerSecond[s] == 0) continue;
+        int bar = (int)(SIM_BAR_WIDTH * run.missesPerSecond[s] / run.missed) + 1;
+        printf("  %4zu s %10d  %s\n", s, run.missesPerSecond[s], std::string(bar, '#').c_str());
+    }
+
+    const HothouseLoadReport& load = pedal.getLoad();
+    printf("\n%-12s %10s %10s %10s\n", "load", "average", "peak", "overruns");
+    printf("%-12s %9.2f%% %9.2f%% %10u\n", "total", 100.0 * load.total.average, 100.0 * load.total.peak,
+           (unsigned)load.total.overruns);
+    for (int s = 0; s < load.numStages && s < (int)names.size(); s++) {
+        printf("%-12s %9.2f%% %9.2f%% %10u\n", names[s].c_str(), 100.0 * load.stages[s].average,
+               100.0 * load.stages[s].peak, (unsigned)load.stages[s].overruns);
+    }
+
+    if (!options.outputPath.empty() &&
+        !saveWav(options.outputPath.c_str(), output.data(), (int)output.size(), options.sampleRate)) {
+        fprintf(stderr, "cannot write %s\n", options.outputPath.c_str());
+    }
+
+    bool ok = run.missed == 0 && run.dropped == 0;
+    printf("\ndeadlines: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Control Mailbox Stress Test
+ *
+ * A producer thread plays the main loop, publishing control snapshots as
+ * fast as it can; a consumer thread plays the audio callback, consuming
+ * them. Every snapshot is stamped so that a torn read (fields from two
+ * different snapshots), a snapshot going backwards, or a lost/duplicated
+ * footswitch edge is detected. Snapshots may be skipped, so a rising edge
+ * must be reported iff at least one press happened in the skipped range.
+ * Also reports the consumer-side cost of consume(), which is what the
+ * audio callback pays.
+ *
+ * Exits non-zero if any inconsistency was seen.
+ */
+
+#include "hothouse.h"
+#include "bench/bench.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#define STRESS_SNAPSHOTS 2000000
+#define STRESS_PRESS_INTERVAL 7
+#define STRESS_YIELD_INTERVAL 64
+
+static HothouseControlMailbox mailbox;
+static std::atomic<bool> producerDone(false);
+
+// Stamp a snapshot so every field can be checked against knobs[0]
+static void fillSnapshot(HothouseControls& controls, int sequence) {
+    float stamp = (float)sequence;
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        controls.knobs[i] = stamp + (float)i;
+    }
+    for (int i = 0; i < TOGGLESWITCH_COUNT; i++) {
+        controls.toggles[i] = (ToggleswitchPosition)((sequence + i) % 3);
+    }
+    for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+        controls.footswitchRisingEdge[i] = (sequence + i) % STRESS_PRESS_INTERVAL == 0;
+        controls.footswitchPressed[i] = (sequence & 1) != 0;
+    }
+}
+
+static bool isConsistent(const HothouseControls& controls, int& sequence) {
+    sequence = (int)controls.knobs[0];
+    for (int i = 1; i < KNOB_COUNT; i++) {
+        if (controls.knobs[i] != (float)sequence + (float)i) return false;
+    }
+    for (int i = 0; i < TOGGLESWITCH_COUNT; i++) {
+        if (controls.toggles[i] != (ToggleswitchPosition)((sequence + i) % 3)) return false;
+    }
+    for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+        if (controls.footswitchPressed[i] != ((sequence & 1) != 0)) return false;
+    }
+    return true;
+}
+
+// Presses of footswitch fs in snapshots (from, to]
+static int pressesBetween(int from, int to, int fs) {
+    int count = 0;
+    for (int s = from + 1; s <= to; s++) {
+        if ((s + fs) % STRESS_PRESS_INTERVAL == 0) count++;
+    }
+    return count;
+}
+
+static void producer() {
+    HothouseControls controls;
+    for (int s = 1; s <= STRESS_SNAPSHOTS; s++) {
+        fillSnapshot(controls, s);
+        mailbox.publish(controls);
+        // Give the consumer a chance to interleave on single-core hosts
+        if (s % STRESS_YIELD_INTERVAL == 0) std::this_thread::yield();
+    }
+    producerDone.store(true, std::memory_order_release);
+}
+
+int main() {
+    long lostEdges = 0;
+    long spuriousEdges = 0;
+    long consumed = 0;
+    long torn = 0;
+    long backwards = 0;
+    int lastSequence = 0;
+
+    std::vector<float> costNs;
+    costNs.reserve(1 << 20);
+
+    std::thread producerThread(producer);
+
+    bool finalPass = false;
+    while (true) {
+        // Read the flag first so one more consume() after it is the last word
+        bool done = producerDone.load(std::memory_order_acquire);
+
+        const HothouseControls* controls = 0;
+        double start = benchNowNs();
+        bool fresh = mailbox.consume(controls);
+        double elapsed = benchNowNs() - start;
+        if (costNs.size() < costNs.capacity()) costNs.push_back((float)elapsed);
+
+        if (fresh) {
+            consumed++;
+            int sequence;
+            if (!isConsistent(*controls, sequence)) {
+                torn++;
+            } else if (sequence < lastSequence) {
+                backwards++;
+            } else {
+                for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+                    bool expected = pressesBetween(lastSequence, sequence, i) > 0;
+                    if (expected && !controls->footswitchRisingEdge[i]) lostEdges++;
+                    if (!expected && controls->footswitchRisingEdge[i]) spuriousEdges++;
+                }
+                lastSequence = sequence;
+            }
+        } else {
+            std::this_thread::yield();
+        }
+
+        if (finalPass) break;
+        if (done) finalPass = true;
+    }
+    producerThread.join();
+
+    std::sort(costNs.begin(), costNs.end());
+    size_t n = costNs.size();
+
+    printf("snapshots published: %d\n", STRESS_SNAPSHOTS);
+    printf("snapshots consumed:  %ld\n", consumed);
+    printf("torn reads:          %ld\n", torn);
+    printf("out of order:        %ld\n", backwards);
+    printf("last sequence seen:  %d (expected %d)\n", lastSequence, STRESS_SNAPSHOTS);
+    printf("lost edges:          %ld\n", lostEdges);
+    printf("spurious edges:      %ld\n", spuriousEdges);
+    printf("consume() ns: median %.0f, p99 %.0f, max %.0f (%lu calls, includes clock overhead)\n",
+           costNs[n / 2], costNs[n * 99 / 100], costNs[n - 1], (unsigned long)n);
+
+    bool ok = torn == 0 && backwards == 0 && lostEdges == 0 && spuriousEdges == 0 &&
+              lastSequence == STRESS_SNAPSHOTS;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
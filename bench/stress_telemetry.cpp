@@ -0,0 +1,172 @@
+/**
+ * Cleveland Sound Hothouse Pedal
+ * Telemetry Ring Stress Test
+ *
+ * A producer thread plays the audio callback, pushing sequence-stamped
+ * records into an SpscRing as fast as it can; a consumer thread plays
+ * the main loop, draining it in bursts and stalling now and then so the
+ * ring overruns. Every record is checked for tearing (fields from two
+ * pushes) and order, and pushed = popped + dropped must hold at the end.
+ * Also reports the producer-side cost of push(), which is what the audio
+ * callback pays, and checks the telemetry a pedal produces: Delay
+ * counts feedback clamps, the Compressor its clamps and gain reduction.
+ *
+ * Exits non-zero if any inconsistency was seen.
+ */
+
+#include "hothouse.h"
+#include "pedals/delay/delay.cpp"
+#include "pedals/compressor/compressor.cpp"
+#include "bench/bench.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#define STRESS_RECORDS 4000000
+#define STRESS_RING 64
+#define STRESS_STALL_INTERVAL 5000  // Consumer stalls after this many pops
+#define STRESS_YIELD_INTERVAL 64
+
+struct StampedRecord {
+    uint32_t sequence;
+    uint32_t check[7];  // Each a function of sequence
+};
+
+static SpscRing<StampedRecord, STRESS_RING> ring;
+static std::atomic<bool> producerDone(false);
+static std::vector<float> pushNs;
+
+static void producer() {
+    StampedRecord record;
+    for (uint32_t s = 1; s <= STRESS_RECORDS; s++) {
+        record.sequence = s;
+        for (int i = 0; i < 7; i++) record.check[i] = s * 2654435761u + (uint32_t)i;
+        double start = benchNowNs();
+        ring.push(record);
+        double elapsed = benchNowNs() - start;
+        if (pushNs.size() < pushNs.capacity()) pushNs.push_back((float)elapsed);
+        // Give the consumer a chance to interleave on single-core hosts
+        if (s % STRESS_YIELD_INTERVAL == 0) std::this_thread::yield();
+    }
+    producerDone.store(true, std::memory_order_release);
+}
+
+/**
+ * Run a pedal on guitar input with telemetry on and sum the records
+ */
+static bool checkPedal(const char* name, HothouseEffect& effect, const HothouseControls& controls,
+                       float inputGain, bool expectReduction) {
+    HothousePedal pedal;
+    pedal.setEffect(&effect);
+    pedal.updateControls(controls);
+    pedal.enableTelemetry(true);
+
+    const int numSamples = BENCH_SAMPLE_RATE;
+    std::vector<float> input(numSamples);
+    std::vector<float> output(numSamples);
+    benchFillGuitar(input.data(), numSamples, (float)BENCH_SAMPLE_RATE);
+    for (int i = 0; i < numSamples; i++) input[i] *= inputGain;
+
+    uint32_t records = 0;
+    uint32_t clips = 0;
+    uint32_t expectedBlock = 0;
+    bool ordered = true;
+    float inputPeak = 0.0f;
+    float outputPeak = 0.0f;
+    float reduction = 0.0f;
+    HothouseTelemetry record;
+    for (int i = 0; i < numSamples; i += 4) {
+        pedal.processBuffer(&input[i], &output[i], 4);
+        // Drain every 1 ms, as a main loop would
+        if ((i / 4) % 12 != 11) continue;
+        while (pedal.popTelemetry(record)) {
+            ordered &= record.block == expectedBlock++;
+            records++;
+            clips += record.clips;
+            inputPeak = std::max(inputPeak, record.inputPeak);
+            outputPeak = std::max(outputPeak, record.outputPeak);
+            reduction = std::max(reduction, record.gainReductionDb);
+        }
+    }
+    float truePeak = hothouseBlockPeak(input.data(), numSamples);
+    bool ok = ordered && records == (uint32_t)numSamples / 4 && clips > 0 && inputPeak == truePeak &&
+              outputPeak > 0.0f && (reduction > 0.0f) == expectReduction && pedal.getTelemetryDropped() == 0;
+    printf("%-11s %8u %8u %10.3f %10.3f %12.2f  %s\n", name, records, clips, inputPeak, outputPeak,
+           reduction, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main() {
+    long popped = 0;
+    long torn = 0;
+    long backwards = 0;
+    uint32_t lastSequence = 0;
+
+    pushNs.reserve(1 << 20);
+    std::thread producerThread(producer);
+
+    bool finalPass = false;
+    while (true) {
+        // Read the flag first so one more drain after it is the last word
+        bool done = producerDone.load(std::memory_order_acquire);
+
+        StampedRecord record;
+        bool any = false;
+        while (ring.pop(record)) {
+            any = true;
+            popped++;
+            bool intact = true;
+            for (int i = 0; i < 7; i++) {
+                intact &= record.check[i] == record.sequence * 2654435761u + (uint32_t)i;
+            }
+            if (!intact) {
+                torn++;
+            } else if (record.sequence <= lastSequence) {
+                backwards++;
+            } else {
+                lastSequence = record.sequence;
+            }
+            // A main loop that falls behind now and then
+            if (popped % STRESS_STALL_INTERVAL == 0) {
+                double start = benchNowNs();
+                while (benchNowNs() - start < 200000.0) {
+                }
+            }
+        }
+        if (!any) std::this_thread::yield();
+
+        if (finalPass) break;
+        if (done) finalPass = true;
+    }
+    producerThread.join();
+
+    std::sort(pushNs.begin(), pushNs.end());
+    size_t n = pushNs.size();
+    long dropped = (long)ring.getDropped();
+
+    printf("records pushed:   %d\n", STRESS_RECORDS);
+    printf("records popped:   %ld\n", popped);
+    printf("records dropped:  %ld\n", dropped);
+    printf("torn records:     %ld\n", torn);
+    printf("out of order:     %ld\n", backwards);
+    printf("push() ns: median %.0f, p99 %.0f, max %.0f (%lu calls, includes clock overhead)\n",
+           pushNs[n / 2], pushNs[n * 99 / 100], pushNs[n - 1], (unsigned long)n);
+
+    bool ok = torn == 0 && backwards == 0 && popped + dropped == STRESS_RECORDS && ring.size() == 0;
+
+    // Pedal telemetry: hot input into full feedback, and a squashing compressor
+    printf("\n%-11s %8s %8s %10s %10s %12s\n", "pedal", "records", "clips", "in peak", "out peak",
+           "max GR (dB)");
+    static Delay delay(BENCH_SAMPLE_RATE);
+    HothouseControls controls;
+    controls.knobs[KNOB_2] = 1.0f;
+    ok &= checkPedal("delay", delay, controls, 2.0f, false);
+    Compressor compressor(BENCH_SAMPLE_RATE);
+    controls.knobs[KNOB_1] = 0.1f;
+    controls.knobs[KNOB_5] = 1.0f;
+    ok &= checkPedal("compressor", compressor, controls, 1.0f, true);
+
+    printf("\ntelemetry: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
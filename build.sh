@@ -2,6 +2,10 @@
 # Cleveland Sound Hothouse Pedal - Build Script
 # 
 # This script compiles the effect pedal code for deployment
+#
+# Usage:
+#   ./build.sh          Build the deployment example
+#   ./build.sh bench    Also build the host benchmarks in bench/
 
 set -e
 
@@ -19,6 +23,15 @@ mkdir -p $OUTPUT_DIR
 echo "Compiling deployment example..."
 $COMPILER $CFLAGS deploy.cpp -o $OUTPUT_DIR/hothouse_pedal -lm
 
+# Compile host benchmarks
+if [ "$1" = "bench" ]; then
+    for src in bench/*.cpp; do
+        name=$(basename "$src" .cpp)
+        echo "Compiling $name..."
+        $COMPILER $CFLAGS "$src" -o $OUTPUT_DIR/$name -lm -pthread
+    done
+fi
+
 echo "Build complete!"
 echo "Output: $OUTPUT_DIR/hothouse_pedal"
 echo ""
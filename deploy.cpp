@@ -101,6 +101,11 @@ namespace Hardware {
     }
 }
 
+/**
+ * Control snapshots published by the main loop, consumed by the audio callback
+ */
+HothouseControlMailbox controlMailbox;
+
 /**
  * Audio callback - called by the audio system for each buffer
  * In real implementation, this has signature:
@@ -109,11 +114,12 @@ namespace Hardware {
  */
 void audioCallback(float* inputBuffer, float* outputBuffer, int numSamples,
                    HothousePedal& pedal) {
-    // Read hardware controls (call hw.ProcessAllControls() in real implementation)
-    HothouseControls controls = Hardware::readAllControls();
-
-    // Update pedal with current control values
-    pedal.updateControls(controls);
+    // Pick up the latest control snapshot, if the main loop published one.
+    // No ADC or GPIO access here: that happens in the main loop.
+    const HothouseControls* controls;
+    if (controlMailbox.consume(controls)) {
+        pedal.updateControls(*controls);
+    }
 
     // Process audio buffer
     pedal.processBuffer(inputBuffer, outputBuffer, numSamples);
@@ -121,6 +127,7 @@ void audioCallback(float* inputBuffer, float* outputBuffer, int numSamples,
     // Note: LED updates should happen in main loop, not here
 }
 
+#ifndef HOTHOUSE_HOST_SIMULATION  // bench/simulate.cpp supplies its own main()
 /**
  * Main deployment code
  */
@@ -160,16 +167,46 @@ int main() {
     // Compressor compressor(config.sampleRate);
     // pedal.setEffect(&compressor);
 
+    // Or run several effects as one chain:
+    // Compressor compressor(config.sampleRate);
+    // Overdrive overdrive(config.sampleRate);
+    // Delay delay(config.sampleRate);
+    // HothouseEffect* chain[] = {&compressor, &overdrive, &delay};
+    // EffectChain effectChain(chain, 3);
+    // pedal.setEffect(&effectChain);
+
+    // Effect buffers come from hothouseDefaultArena() at construction.
+    // On the device, put the bulk region in SDRAM by defining
+    // HOTHOUSE_BULK_MEMORY_SECTION before including hothouse.h.
+    if (hothouseDefaultArena().hasFailed()) {
+        return 1;  // Rig does not fit in memory
+    }
+    // Or catch it at compile time, against the board's budgets:
+    // static_assert(hothouseFitsMemory<Compressor, Overdrive, Delay>(
+    //                   HOTHOUSE_FAST_MEMORY_BYTES, HOTHOUSE_BULK_MEMORY_BYTES),
+    //               "rig does not fit in SRAM/SDRAM");
+
+    // Optional CPU load meter: times every buffer against its deadline.
+    // On the device, count core cycles with the DWT (Daisy Seed: 480 MHz):
+    // pedal.enableLoadMeter(HothouseCycleCounter::dwt(480000000.0));
+    // and read pedal.getLoad() in the main loop (total, per chain stage).
+    // pedal.enableTelemetry(true) also queues per-buffer peaks, clip counts
+    // and gain reduction; drain them in the main loop with popTelemetry().
+
     // Audio buffers
     float inputBuffer[4];
     float outputBuffer[4];
 
     // Main loop
     // In real implementation, audio processing is handled by DMA/interrupts
-    // and this loop just handles LED updates
+    // and this loop handles control reads and LED updates
     while (true) {
+        // Read hardware controls and hand them to the audio callback
+        // (call hw.ProcessAllControls() first in real implementation)
+        controlMailbox.publish(Hardware::readAllControls());
+
         // TODO: In real implementation, audio callback runs via DMA interrupt
-        // For now, simulate it:
+        // For now, simulate it (build/simulate runs it at the real period):
         for (int i = 0; i < config.bufferSize; i++) {
             inputBuffer[i] = 0.0f;  // Replace with ADC read
         }
@@ -187,6 +224,7 @@ int main() {
 
     return 0;
 }
+#endif
 
 /**
  * Effect Selection Guide
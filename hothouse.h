@@ -14,175 +14,4369 @@
 #ifndef HOTHOUSE_H
 #define HOTHOUSE_H
 
-// Utility function to constrain values
-inline float constrain(float value, float min, float max) {
-    if (value < min) return min;
-    if (value > max) return max;
-    return value;
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Vector instruction set for the block kernels (scalar fallback otherwise)
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define HOTHOUSE_SIMD_SSE 1
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HOTHOUSE_SIMD_SSE2 1
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HOTHOUSE_SIMD_NEON 1
+#endif
+
+// Tick sources for the CPU load meter (see HothouseCycleCounter)
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#define HOTHOUSE_COUNTER_CLOCK 1
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOTHOUSE_COUNTER_TSC 1
+#endif
+#endif
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_8M_MAIN__)
+#define HOTHOUSE_COUNTER_DWT 1
+#endif
+
+/**
+ * Control rate: effects derive coefficients from smoothed parameters once
+ * every HOTHOUSE_CONTROL_BLOCK samples (0.67ms at 48kHz) and the audio-rate
+ * loop only applies or interpolates them. Configurable per effect with
+ * HothouseEffect::setControlRate(), up to HOTHOUSE_MAX_CONTROL_BLOCK.
+ */
+#define HOTHOUSE_CONTROL_BLOCK 32
+#define HOTHOUSE_MAX_CONTROL_BLOCK 128
+
+/**
+ * Sample rates
+ * Effects take their rate at construction and derive delay lengths and
+ * filter coefficients from it; 32, 44.1, 48 and 96 kHz are supported.
+ * Delay buffers are sized at compile time for HOTHOUSE_MAX_SAMPLE_RATE
+ * (define it as 96000 to run at 96 kHz, which doubles them); above that
+ * rate the longest delay settings are clamped. Lengths and coefficients
+ * in the pedals are written for HOTHOUSE_REFERENCE_RATE and scaled to the
+ * running rate with the helpers below, keeping times and corner
+ * frequencies.
+ */
+#ifndef HOTHOUSE_MAX_SAMPLE_RATE
+#define HOTHOUSE_MAX_SAMPLE_RATE 48000
+#endif
+#define HOTHOUSE_REFERENCE_RATE 48000
+
+// Smallest power of two >= n, for delay line capacities
+constexpr int hothouseNextPowerOfTwo(int n, int p = 1) {
+    return p >= n ? p : hothouseNextPowerOfTwo(n, p * 2);
+}
+
+// A length in samples at the reference rate, at HOTHOUSE_MAX_SAMPLE_RATE (rounded up)
+constexpr int hothouseMaxRateSamples(int referenceSamples) {
+    return (int)(((long long)referenceSamples * HOTHOUSE_MAX_SAMPLE_RATE + HOTHOUSE_REFERENCE_RATE - 1)
+                 / HOTHOUSE_REFERENCE_RATE);
+}
+
+// A length in samples at the reference rate, at sampleRate (rounded)
+inline int hothouseSamplesAtRate(int referenceSamples, float sampleRate) {
+    return (int)((double)referenceSamples * sampleRate / HOTHOUSE_REFERENCE_RATE + 0.5);
+}
+
+// A one-pole pole (y = (1 - p) x + p y) at the reference rate, moved to
+// sampleRate with the same time constant. Also moves a one-zero's zero.
+inline float hothouseRescalePole(float pole, float sampleRate) {
+    if (sampleRate == HOTHOUSE_REFERENCE_RATE || pole <= 0.0f) return pole;
+    return powf(pole, HOTHOUSE_REFERENCE_RATE / sampleRate);
+}
+
+// Same for a one-pole coefficient (1 - pole)
+inline float hothouseRescaleOnePole(float coefficient, float sampleRate) {
+    if (sampleRate == HOTHOUSE_REFERENCE_RATE) return coefficient;
+    return 1.0f - hothouseRescalePole(1.0f - coefficient, sampleRate);
 }
 
 /**
- * Toggle switch position enum (ON-OFF-ON switches)
- * Matches the official Hothouse API
+ * Denormal protection
+ * Recursive states (filter memories, feedback paths, envelope followers)
+ * decay toward zero in silence and end up subnormal, which many FPUs
+ * process 10-100x slower. Two layers keep them out of that range:
+ *   - HothouseDenormalGuard: scoped flush-to-zero/denormals-are-zero,
+ *     held by HothousePedal::processBuffer() around every block
+ *   - HOTHOUSE_DENORMAL_DC: tiny offset added into each recursive state,
+ *     for targets without an FTZ mode and for code run outside the guard.
+ *     At 1e-20 (-400 dBFS) it is far below any codec's noise floor.
  */
-enum ToggleswitchPosition {
-    TOGGLESWITCH_UP,      // Switch pushed up (position 1)
-    TOGGLESWITCH_MIDDLE,  // Switch in center/OFF position
-    TOGGLESWITCH_DOWN,    // Switch pushed down (position 2)
-    TOGGLESWITCH_UNKNOWN  // For ON-ON switches (no middle position)
+#ifndef HOTHOUSE_DENORMAL_DC
+#define HOTHOUSE_DENORMAL_DC 1e-20f
+#endif
+
+/**
+ * Scoped flush-to-zero guard
+ * Sets FTZ/DAZ (SSE MXCSR), FZ (AArch64 FPCR, ARM VFP FPSCR) for its
+ * lifetime and restores the previous mode on exit. No-op elsewhere.
+ */
+class HothouseDenormalGuard {
+private:
+    unsigned long savedMode;
+
+public:
+    HothouseDenormalGuard() {
+#if defined(HOTHOUSE_SIMD_SSE)
+        savedMode = _mm_getcsr();
+        _mm_setcsr((unsigned int)savedMode | 0x8040);  // FTZ | DAZ
+#elif defined(__aarch64__)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(savedMode));
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(savedMode | (1UL << 24)));
+#elif defined(__arm__) && defined(__ARM_FP)
+        unsigned int fpscr;
+        __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+        savedMode = fpscr;
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr | (1U << 24)));
+#else
+        savedMode = 0;
+#endif
+    }
+
+    ~HothouseDenormalGuard() {
+#if defined(HOTHOUSE_SIMD_SSE)
+        _mm_setcsr((unsigned int)savedMode);
+#elif defined(__aarch64__)
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(savedMode));
+#elif defined(__arm__) && defined(__ARM_FP)
+        unsigned int fpscr = (unsigned int)savedMode;
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+private:
+    HothouseDenormalGuard(const HothouseDenormalGuard&);
+    HothouseDenormalGuard& operator=(const HothouseDenormalGuard&);
 };
 
 /**
- * Knob identifiers
+ * Memory regions for effect buffers
+ * FAST is small, low-latency memory (on-chip SRAM) for buffers touched
+ * at random every sample; BULK is large external memory (SDRAM) for long
+ * delay lines.
  */
-enum Knob {
-    KNOB_1 = 0,
-    KNOB_2,
-    KNOB_3,
-    KNOB_4,
-    KNOB_5,
-    KNOB_6,
-    KNOB_COUNT
+enum MemoryRegion {
+    MEMORY_FAST = 0,
+    MEMORY_BULK,
+    MEMORY_REGION_COUNT
+};
+
+// Default arena sizes in bytes, override before including hothouse.h
+#ifndef HOTHOUSE_FAST_MEMORY_BYTES
+#define HOTHOUSE_FAST_MEMORY_BYTES (256 * 1024)
+#endif
+#ifndef HOTHOUSE_BULK_MEMORY_BYTES
+#define HOTHOUSE_BULK_MEMORY_BYTES (8 * 1024 * 1024)
+#endif
+
+// Linker section attributes for the default arena storage, e.g. on Daisy:
+//   #define HOTHOUSE_BULK_MEMORY_SECTION __attribute__((section(".sdram_bss")))
+#ifndef HOTHOUSE_FAST_MEMORY_SECTION
+#define HOTHOUSE_FAST_MEMORY_SECTION
+#endif
+#ifndef HOTHOUSE_BULK_MEMORY_SECTION
+#define HOTHOUSE_BULK_MEMORY_SECTION
+#endif
+
+#define HOTHOUSE_MEMORY_ALIGNMENT 16
+
+/**
+ * Bump allocator over one block of memory
+ */
+class HothouseMemoryRegion {
+private:
+    const char* name;
+    unsigned char* base;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    int failedAllocations;
+
+public:
+    HothouseMemoryRegion()
+        : name(""), base(nullptr), capacity(0), used(0), highWater(0), failedAllocations(0) {}
+
+    void init(const char* regionName, void* memory, size_t bytes) {
+        name = regionName;
+        base = (unsigned char*)memory;
+        capacity = bytes;
+        used = 0;
+        highWater = 0;
+        failedAllocations = 0;
+    }
+
+    /**
+     * Carve out an aligned block
+     * @return Pointer to the block, or nullptr if the region is full
+     */
+    void* allocate(size_t bytes, size_t alignment = HOTHOUSE_MEMORY_ALIGNMENT) {
+        size_t address = (size_t)(base + used);
+        size_t padding = (alignment - (address % alignment)) % alignment;
+        if (base == nullptr || used + padding + bytes > capacity) {
+            failedAllocations++;
+            return nullptr;
+        }
+        void* block = base + used + padding;
+        used += padding + bytes;
+        if (used > highWater) highWater = used;
+        return block;
+    }
+
+    // Release everything (only while no effect uses the region)
+    void reset() {
+        used = 0;
+    }
+
+    const char* getName() const { return name; }
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+    size_t getHighWater() const { return highWater; }
+    int getFailedAllocations() const { return failedAllocations; }  // Includes FAST spills
+};
+
+/**
+ * Init-time memory arena for effect buffers
+ * Effects request their buffers from a region in their constructors;
+ * nothing is allocated on the audio path. A FAST request that does not
+ * fit spills into BULK, so a rig that outgrows SRAM still runs. Buffers
+ * live as long as the arena: create effects once at startup.
+ */
+class HothouseMemoryArena {
+private:
+    HothouseMemoryRegion regions[MEMORY_REGION_COUNT];
+    int failedAllocations;
+
+public:
+    HothouseMemoryArena() : failedAllocations(0) {}
+
+    HothouseMemoryArena(void* fastMemory, size_t fastBytes, void* bulkMemory, size_t bulkBytes)
+        : failedAllocations(0) {
+        regions[MEMORY_FAST].init("fast", fastMemory, fastBytes);
+        regions[MEMORY_BULK].init("bulk", bulkMemory, bulkBytes);
+    }
+
+    /**
+     * Allocate a zeroed, aligned array
+     * @param region Preferred region (FAST falls back to BULK when full)
+     * @return Array, or nullptr if no region could hold it
+     */
+    template <typename T>
+    T* allocate(MemoryRegion region, int count) {
+        size_t bytes = (size_t)count * sizeof(T);
+        void* block = regions[region].allocate(bytes);
+        if (block == nullptr && region == MEMORY_FAST) {
+            block = regions[MEMORY_BULK].allocate(bytes);
+        }
+        T* array = (T*)block;
+        if (array == nullptr) {
+            failedAllocations++;
+            return nullptr;
+        }
+        for (int i = 0; i < count; i++) array[i] = T();
+        return array;
+    }
+
+    float* allocateFloats(MemoryRegion region, int count) {
+        return allocate<float>(region, count);
+    }
+
+    HothouseMemoryRegion& getRegion(MemoryRegion region) {
+        return regions[region];
+    }
+
+    // True if any request could not be satisfied (check once after setup)
+    bool hasFailed() const {
+        return failedAllocations > 0;
+    }
+};
+
+/**
+ * Process-wide arena backed by static storage, used by effects that are
+ * not given one explicitly
+ */
+inline HothouseMemoryArena& hothouseDefaultArena() {
+    alignas(HOTHOUSE_MEMORY_ALIGNMENT) static unsigned char
+        fastMemory[HOTHOUSE_FAST_MEMORY_BYTES] HOTHOUSE_FAST_MEMORY_SECTION;
+    alignas(HOTHOUSE_MEMORY_ALIGNMENT) static unsigned char
+        bulkMemory[HOTHOUSE_BULK_MEMORY_BYTES] HOTHOUSE_BULK_MEMORY_SECTION;
+    static HothouseMemoryArena arena(fastMemory, sizeof(fastMemory),
+                                     bulkMemory, sizeof(bulkMemory));
+    return arena;
+}
+
+// Bytes a request takes from a region once the next one is aligned
+constexpr size_t hothouseArenaBytes(size_t bytes) {
+    return (bytes + HOTHOUSE_MEMORY_ALIGNMENT - 1) / HOTHOUSE_MEMORY_ALIGNMENT * HOTHOUSE_MEMORY_ALIGNMENT;
+}
+
+/**
+ * Memory an effect occupies
+ * objectBytes is the object itself, wherever it lives (static storage, a
+ * StaticChain); fastBytes and bulkBytes are what its buffers took from
+ * each arena region, so a FAST request that spilled counts as bulk.
+ */
+struct HothouseMemoryUsage {
+    size_t objectBytes;
+    size_t fastBytes;
+    size_t bulkBytes;
+
+    HothouseMemoryUsage(size_t object = 0, size_t fast = 0, size_t bulk = 0)
+        : objectBytes(object), fastBytes(fast), bulkBytes(bulk) {}
+
+    size_t getRegion(MemoryRegion region) const {
+        return region == MEMORY_FAST ? fastBytes : bulkBytes;
+    }
+
+    void add(const HothouseMemoryUsage& other) {
+        objectBytes += other.objectBytes;
+        fastBytes += other.fastBytes;
+        bulkBytes += other.bulkBytes;
+    }
+};
+
+/**
+ * Arena position at construction, for an effect constructor to record
+ * what its init() calls took:
+ *
+ *   HothouseArenaMark mark(arena);
+ *   delayLine.init(arena, MEMORY_BULK);
+ *   this->memoryUsage = mark.since(sizeof(*this));
+ */
+class HothouseArenaMark {
+private:
+    HothouseMemoryArena& arena;
+    size_t start[MEMORY_REGION_COUNT];
+
+    size_t used(MemoryRegion region) const {
+        return hothouseArenaBytes(arena.getRegion(region).getUsed());
+    }
+
+public:
+    explicit HothouseArenaMark(HothouseMemoryArena& memoryArena) : arena(memoryArena) {
+        start[MEMORY_FAST] = used(MEMORY_FAST);
+        start[MEMORY_BULK] = used(MEMORY_BULK);
+    }
+
+    HothouseMemoryUsage since(size_t objectBytes) const {
+        return HothouseMemoryUsage(objectBytes, used(MEMORY_FAST) - start[MEMORY_FAST],
+                                   used(MEMORY_BULK) - start[MEMORY_BULK]);
+    }
+};
+
+/**
+ * Compile-time memory footprint of a set of effects
+ * Every effect declares what it asks the arena for:
+ *
+ *   static constexpr size_t arenaBytes(MemoryRegion region);
+ *
+ * (HothouseEffectT's returns 0.) The sums here are requests by region,
+ * before any FAST spill; objectBytes() is the objects' own sizeof.
+ */
+template <typename... Effects>
+struct HothouseMemoryFootprint;
+
+template <>
+struct HothouseMemoryFootprint<> {
+    static constexpr size_t objectBytes() { return 0; }
+    static constexpr size_t arenaBytes(MemoryRegion) { return 0; }
+    static constexpr size_t fastBytes() { return 0; }
+    static constexpr size_t bulkBytes() { return 0; }
+};
+
+template <typename First, typename... Rest>
+struct HothouseMemoryFootprint<First, Rest...> {
+    typedef HothouseMemoryFootprint<Rest...> Next;
+
+    static constexpr size_t objectBytes() { return sizeof(First) + Next::objectBytes(); }
+
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return First::arenaBytes(region) + Next::arenaBytes(region);
+    }
+
+    static constexpr size_t fastBytes() { return arenaBytes(MEMORY_FAST); }
+    static constexpr size_t bulkBytes() { return arenaBytes(MEMORY_BULK); }
+};
+
+/**
+ * Budget check for a rig, at compile time:
+ *
+ *   static_assert(hothouseFitsMemory<Compressor, Overdrive, Delay>(
+ *                     HOTHOUSE_FAST_MEMORY_BYTES, HOTHOUSE_BULK_MEMORY_BYTES),
+ *                 "rig does not fit in SRAM/SDRAM");
+ *
+ * @return true if each region's requests fit its budget with no FAST spill
+ */
+template <typename... Effects>
+constexpr bool hothouseFitsMemory(size_t fastBudget, size_t bulkBudget) {
+    return HothouseMemoryFootprint<Effects...>::fastBytes() <= fastBudget &&
+           HothouseMemoryFootprint<Effects...>::bulkBytes() <= bulkBudget;
+}
+
+// Bit casts between float and its IEEE-754 representation
+inline unsigned int hothouseFloatBits(float x) {
+    unsigned int bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float hothouseBitsFloat(unsigned int bits) {
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * Fixed-point samples
+ * Q31 (Q1.31) and Q15 (Q1.15) hold a value in [-1, 1) as a scaled
+ * integer. Sums and products saturate at the ends of the range instead of
+ * wrapping, and products round to nearest. Both are plain structs, so
+ * they can live in arena buffers and delay lines like float. Q31 is the
+ * processing format. Q15 is for 16-bit codecs and compact storage: its
+ * 3e-5 step is too coarse for parameter ramps and slow filters.
+ */
+template <typename Storage>
+struct HothouseFixedTraits;
+
+template <>
+struct HothouseFixedTraits<int32_t> {
+    typedef int64_t Wide;
+    enum { FRAC_BITS = 31 };
+};
+
+template <>
+struct HothouseFixedTraits<int16_t> {
+    typedef int32_t Wide;
+    enum { FRAC_BITS = 15 };
+};
+
+template <typename Storage>
+struct HothouseFixed {
+    typedef typename HothouseFixedTraits<Storage>::Wide Wide;
+    enum { FRAC_BITS = HothouseFixedTraits<Storage>::FRAC_BITS };
+
+    Storage raw;
+
+    static HothouseFixed fromRaw(Storage value) {
+        HothouseFixed result;
+        result.raw = value;
+        return result;
+    }
+
+    static HothouseFixed saturate(Wide value) {
+        const Wide high = ((Wide)1 << FRAC_BITS) - 1;
+        const Wide low = -((Wide)1 << FRAC_BITS);
+        return fromRaw((Storage)(value > high ? high : (value < low ? low : value)));
+    }
+
+    // Round a value already scaled by 2^FRAC_BITS, saturating
+    static HothouseFixed fromScaled(float scaled) {
+        const float limit = (float)((Wide)1 << FRAC_BITS);
+        const float rounded = scaled + (scaled < 0.0f ? -0.5f : 0.5f);
+        if (rounded >= limit) return fromRaw((Storage)(((Wide)1 << FRAC_BITS) - 1));
+        if (rounded <= -limit) return fromRaw((Storage)(-((Wide)1 << FRAC_BITS)));
+        return fromRaw((Storage)(Wide)rounded);
+    }
+
+    static HothouseFixed fromFloat(float x) {
+        return fromScaled(x * (float)((Wide)1 << FRAC_BITS));
+    }
+
+    explicit operator float() const {
+        return (float)raw * (1.0f / (float)((Wide)1 << FRAC_BITS));
+    }
+
+    HothouseFixed operator+(HothouseFixed other) const {
+        return saturate((Wide)raw + other.raw);
+    }
+
+    HothouseFixed operator-(HothouseFixed other) const {
+        return saturate((Wide)raw - other.raw);
+    }
+
+    HothouseFixed operator-() const {
+        return saturate(-(Wide)raw);
+    }
+
+    HothouseFixed operator*(HothouseFixed other) const {
+        return saturate(((Wide)raw * other.raw + ((Wide)1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+    }
+
+    HothouseFixed& operator+=(HothouseFixed other) { return *this = *this + other; }
+    HothouseFixed& operator-=(HothouseFixed other) { return *this = *this - other; }
+    HothouseFixed& operator*=(HothouseFixed other) { return *this = *this * other; }
+
+    bool operator<(HothouseFixed other) const { return raw < other.raw; }
+    bool operator>(HothouseFixed other) const { return raw > other.raw; }
+    bool operator<=(HothouseFixed other) const { return raw <= other.raw; }
+    bool operator>=(HothouseFixed other) const { return raw >= other.raw; }
+    bool operator==(HothouseFixed other) const { return raw == other.raw; }
+    bool operator!=(HothouseFixed other) const { return raw != other.raw; }
+};
+
+typedef HothouseFixed<int32_t> Q31;
+typedef HothouseFixed<int16_t> Q15;
+
+/**
+ * Sample-type operations for effects templated on their sample type
+ * Effects write their audio-rate code once against these, with float or
+ * a fixed-point type. Control-rate coefficients are derived in float and
+ * converted with fromFloat() once per control block.
+ *   scale(x, g)    x * g for a float g of any size (drive, makeup, and
+ *                  per-sample float modulation); saturates in fixed point
+ *   lerp(a, b, t)  a + (b - a) * t without overflowing the difference
+ *   clampUnit(x)   limit to [-1, 1]; free in fixed point
+ *   clips(x)       1 where clampUnit(x) would limit x (fixed point: x
+ *                  sits on a rail, so arithmetic saturated), else 0
+ */
+template <typename Sample>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<float> {
+    enum { IS_FLOAT = 1 };
+
+    static float fromFloat(float x) { return x; }
+    static float toFloat(float x) { return x; }
+    static float scale(float x, float gain) { return x * gain; }
+    static float abs(float x) { return fabsf(x); }
+    static float lerp(float a, float b, float t) { return a + (b - a) * t; }
+    static float clampUnit(float x) {
+        if (x > 1.0f) x = 1.0f;
+        if (x < -1.0f) x = -1.0f;
+        return x;
+    }
+    static uint32_t clips(float x) { return fabsf(x) > 1.0f ? 1u : 0u; }
+};
+
+template <typename Storage>
+struct SampleTraits<HothouseFixed<Storage> > {
+    typedef HothouseFixed<Storage> Fixed;
+    typedef typename Fixed::Wide Wide;
+    enum { IS_FLOAT = 0 };
+
+    static Fixed fromFloat(float x) { return Fixed::fromFloat(x); }
+    static float toFloat(Fixed x) { return (float)x; }
+    static Fixed scale(Fixed x, float gain) { return Fixed::fromScaled((float)x.raw * gain); }
+    static Fixed abs(Fixed x) { return x.raw < 0 ? -x : x; }
+    static Fixed lerp(Fixed a, Fixed b, Fixed t) {
+        Wide difference = (Wide)b.raw - a.raw;
+        return Fixed::saturate((Wide)a.raw +
+            ((difference * t.raw + ((Wide)1 << (Fixed::FRAC_BITS - 1))) >> Fixed::FRAC_BITS));
+    }
+    static Fixed clampUnit(Fixed x) { return x; }
+    static uint32_t clips(Fixed x) {
+        const Wide high = ((Wide)1 << Fixed::FRAC_BITS) - 1;
+        return (x.raw >= high || x.raw <= -high - 1) ? 1u : 0u;
+    }
+};
+
+/**
+ * Block conversion between sample formats, for the codec boundary and
+ * DelayLine storage. float <-> Q31 and float <-> Q15 are vectorized on
+ * SSE2/NEON; out-of-range floats saturate.
+ */
+template <typename Sample>
+inline void hothouseConvertBlock(const Sample* input, Sample* output, int numSamples) {
+    if (input != output) memcpy(output, input, sizeof(Sample) * numSamples);
+}
+
+#if defined(HOTHOUSE_SIMD_NEON)
+// Scale and round to nearest like HothouseFixed::fromScaled, saturating.
+// vcvtq_n_s32_f32 would truncate toward zero instead.
+inline int32x4_t hothouseRoundScaled(float32x4_t x, float scale) {
+    const float32x4_t scaled = vmulq_f32(x, vdupq_n_f32(scale));
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(scaled);
+#else
+    // Add 0.5 away from zero, then truncate
+    const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(scaled), vdupq_n_u32(0x80000000u));
+    const float32x4_t half =
+        vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+    return vcvtq_s32_f32(vaddq_f32(scaled, half));
+#endif
+}
+#endif
+
+inline void hothouseConvertBlock(const float* input, Q31* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 scale = _mm_set1_ps(2147483648.0f);
+    const __m128 high = _mm_set1_ps(2147483520.0f);  // Largest float below 2^31
+    const __m128 low = _mm_set1_ps(-2147483648.0f);
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(input + i), scale);
+        scaled = _mm_max_ps(_mm_min_ps(scaled, high), low);
+        _mm_storeu_si128((__m128i*)(output + i), _mm_cvtps_epi32(scaled));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_s32(&output[i].raw, hothouseRoundScaled(vld1q_f32(input + i), 2147483648.0f));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = Q31::fromFloat(input[i]);
+    }
+}
+
+inline void hothouseConvertBlock(const Q31* input, float* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128i raw = _mm_loadu_si128((const __m128i*)(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(raw), scale));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(output + i, vcvtq_n_f32_s32(vld1q_s32(&input[i].raw), 31));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = (float)input[i];
+    }
+}
+
+inline void hothouseConvertBlock(const float* input, Q15* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 high = _mm_set1_ps(32767.0f);
+    const __m128 low = _mm_set1_ps(-32768.0f);
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128 first = _mm_mul_ps(_mm_loadu_ps(input + i), scale);
+        __m128 second = _mm_mul_ps(_mm_loadu_ps(input + i + 4), scale);
+        first = _mm_max_ps(_mm_min_ps(first, high), low);
+        second = _mm_max_ps(_mm_min_ps(second, high), low);
+        _mm_storeu_si128((__m128i*)(output + i),
+                         _mm_packs_epi32(_mm_cvtps_epi32(first), _mm_cvtps_epi32(second)));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1_s16(&output[i].raw, vqmovn_s32(hothouseRoundScaled(vld1q_f32(input + i), 32768.0f)));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = Q15::fromFloat(input[i]);
+    }
+}
+
+inline void hothouseConvertBlock(const Q15* input, float* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(output + i, vcvtq_n_f32_s32(vmovl_s16(vld1_s16(&input[i].raw)), 15));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = (float)input[i];
+    }
+}
+
+inline void hothouseConvertBlock(const Q15* input, Q31* output, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        output[i].raw = (int32_t)input[i].raw << 16;
+    }
+}
+
+inline void hothouseConvertBlock(const Q31* input, Q15* output, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        output[i] = Q15::saturate(((int64_t)input[i].raw + 0x8000) >> 16);
+    }
+}
+
+// Single-sample conversion between sample formats
+template <typename From, typename To>
+struct HothouseSampleConverter {
+    static To convert(From x) {
+        return SampleTraits<To>::fromFloat(SampleTraits<From>::toFloat(x));
+    }
+};
+
+template <typename T>
+struct HothouseSampleConverter<T, T> {
+    static T convert(T x) { return x; }
+};
+
+/**
+ * 12-bit companding
+ * A code is a sign bit and 11 bits of |x| + 2^-7 taken as a float: the
+ * lowest eight exponents ([2^-7, 2)) and the top eight mantissa bits,
+ * rounded to nearest. Below 2^-7 the step is 2^-15 as in 16-bit; above,
+ * it grows with the level, keeping about 50 dB SNR on loud signals.
+ * Inputs are clamped to [-1, 1]; zero encodes and decodes exactly.
+ */
+#define HOTHOUSE_COMPAND_OFFSET 0.0078125f  // 2^-7
+#define HOTHOUSE_COMPAND_BASE (120u << 23)  // Float bits of 2^-7
+
+inline unsigned int hothouseCompand(float x) {
+    unsigned int sign = hothouseFloatBits(x) >> 31;
+    float magnitude = fminf(fabsf(x), 1.0f) + HOTHOUSE_COMPAND_OFFSET;
+    unsigned int code = (hothouseFloatBits(magnitude) + (1u << 14) - HOTHOUSE_COMPAND_BASE) >> 15;
+    return (sign << 11) | code;
+}
+
+inline float hothouseExpand(unsigned int code) {
+    float magnitude = hothouseBitsFloat(((code & 0x7FF) << 15) + HOTHOUSE_COMPAND_BASE)
+                      - HOTHOUSE_COMPAND_OFFSET;
+    return hothouseBitsFloat(hothouseFloatBits(magnitude) | ((code & 0x800) << 20));
+}
+
+inline void hothouseCompandBlock(const float* input, uint16_t* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 offset = _mm_set1_ps(HOTHOUSE_COMPAND_OFFSET);
+    const __m128i bias = _mm_set1_epi32((int)((1u << 14) - HOTHOUSE_COMPAND_BASE));
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i code[2];
+        for (int h = 0; h < 2; h++) {
+            __m128 x = _mm_loadu_ps(input + i + 4 * h);
+            __m128i sign = _mm_slli_epi32(_mm_srli_epi32(_mm_castps_si128(x), 31), 11);
+            __m128 magnitude = _mm_add_ps(_mm_min_ps(_mm_and_ps(x, absMask), one), offset);
+            code[h] = _mm_or_si128(
+                _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(magnitude), bias), 15), sign);
+        }
+        _mm_storeu_si128((__m128i*)(output + i), _mm_packs_epi32(code[0], code[1]));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t offset = vdupq_n_f32(HOTHOUSE_COMPAND_OFFSET);
+    const uint32x4_t bias = vdupq_n_u32((1u << 14) - HOTHOUSE_COMPAND_BASE);
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t x = vld1q_f32(input + i);
+        uint32x4_t sign = vshlq_n_u32(vshrq_n_u32(vreinterpretq_u32_f32(x), 31), 11);
+        float32x4_t magnitude = vaddq_f32(vminq_f32(vabsq_f32(x), one), offset);
+        uint32x4_t code = vshrq_n_u32(vaddq_u32(vreinterpretq_u32_f32(magnitude), bias), 15);
+        vst1_u16(output + i, vmovn_u32(vorrq_u32(code, sign)));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = (uint16_t)hothouseCompand(input[i]);
+    }
+}
+
+inline void hothouseExpandBlock(const uint16_t* input, float* output, int numSamples) {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i magnitudeMask = _mm_set1_epi32(0x7FF);
+    const __m128i signMask = _mm_set1_epi32(0x800);
+    const __m128i base = _mm_set1_epi32((int)HOTHOUSE_COMPAND_BASE);
+    const __m128 offset = _mm_set1_ps(HOTHOUSE_COMPAND_OFFSET);
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i packed = _mm_loadu_si128((const __m128i*)(input + i));
+        for (int h = 0; h < 2; h++) {
+            __m128i code = h == 0 ? _mm_unpacklo_epi16(packed, zero) : _mm_unpackhi_epi16(packed, zero);
+            __m128i bits = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(code, magnitudeMask), 15), base);
+            __m128 magnitude = _mm_sub_ps(_mm_castsi128_ps(bits), offset);
+            __m128i sign = _mm_slli_epi32(_mm_and_si128(code, signMask), 20);
+            _mm_storeu_ps(output + i + 4 * h, _mm_or_ps(magnitude, _mm_castsi128_ps(sign)));
+        }
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    const uint32x4_t magnitudeMask = vdupq_n_u32(0x7FF);
+    const uint32x4_t signMask = vdupq_n_u32(0x800);
+    const uint32x4_t base = vdupq_n_u32(HOTHOUSE_COMPAND_BASE);
+    const float32x4_t offset = vdupq_n_f32(HOTHOUSE_COMPAND_OFFSET);
+    for (; i + 4 <= numSamples; i += 4) {
+        uint32x4_t code = vmovl_u16(vld1_u16(input + i));
+        uint32x4_t bits = vaddq_u32(vshlq_n_u32(vandq_u32(code, magnitudeMask), 15), base);
+        float32x4_t magnitude = vsubq_f32(vreinterpretq_f32_u32(bits), offset);
+        uint32x4_t sign = vshlq_n_u32(vandq_u32(code, signMask), 20);
+        vst1q_f32(output + i,
+                  vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(magnitude), sign)));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = hothouseExpand(input[i]);
+    }
+}
+
+/**
+ * Storage formats for DelayLine
+ * DelayStorage<T, Storage, Capacity> holds Capacity samples of type T in
+ * the Storage format, converting on every store and load. Any sample
+ * type works as Storage (float, Q31, Q15: 4, 4 and 2 bytes per sample);
+ * the tag Companded12 packs two 12-bit companded codes into three bytes.
+ * Span loads and stores convert whole contiguous runs with the
+ * vectorized block converters.
+ */
+struct Companded12 {};
+
+template <typename T, typename Storage, int Capacity>
+class DelayStorage {
+private:
+    Storage* buffer;
+
+public:
+    enum { BYTES = Capacity * sizeof(Storage) };
+
+    DelayStorage() : buffer(nullptr) {}
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        buffer = arena.allocate<Storage>(region, Capacity);
+    }
+
+    void clear() {
+        for (int i = 0; i < Capacity; i++) buffer[i] = Storage();
+    }
+
+    T load(int index) const {
+        return HothouseSampleConverter<Storage, T>::convert(buffer[index]);
+    }
+
+    void store(int index, T sample) {
+        buffer[index] = HothouseSampleConverter<T, Storage>::convert(sample);
+    }
+
+    void loadSpan(T* output, int start, int numSamples) const {
+        hothouseConvertBlock(buffer + start, output, numSamples);
+    }
+
+    void storeSpan(const T* input, int start, int numSamples) {
+        hothouseConvertBlock(input, buffer + start, numSamples);
+    }
+};
+
+template <typename T, int Capacity>
+class DelayStorage<T, Companded12, Capacity> {
+    static_assert(Capacity % 2 == 0, "Companded12 storage packs samples in pairs");
+
+private:
+    enum { CHUNK = 64 };
+
+    uint8_t* bytes;  // Sample 2p in the low 12 bits of bytes 3p..3p+2, 2p+1 in the high 12
+
+    unsigned int loadCode(int index) const {
+        const uint8_t* p = bytes + (index >> 1) * 3;
+        return (index & 1) ? (p[1] >> 4) | ((unsigned int)p[2] << 4)
+                           : p[0] | ((unsigned int)(p[1] & 0x0F) << 8);
+    }
+
+    void storeCode(int index, unsigned int code) {
+        uint8_t* p = bytes + (index >> 1) * 3;
+        if (index & 1) {
+            p[1] = (uint8_t)((p[1] & 0x0F) | (code << 4));
+            p[2] = (uint8_t)(code >> 4);
+        } else {
+            p[0] = (uint8_t)code;
+            p[1] = (uint8_t)((p[1] & 0xF0) | (code >> 8));
+        }
+    }
+
+    static void expand(const uint16_t* codes, float* output, int numSamples) {
+        hothouseExpandBlock(codes, output, numSamples);
+    }
+
+    template <typename Sample>
+    static void expand(const uint16_t* codes, Sample* output, int numSamples) {
+        float values[CHUNK];
+        hothouseExpandBlock(codes, values, numSamples);
+        hothouseConvertBlock(values, output, numSamples);
+    }
+
+    static void compand(const float* input, uint16_t* codes, int numSamples) {
+        hothouseCompandBlock(input, codes, numSamples);
+    }
+
+    template <typename Sample>
+    static void compand(const Sample* input, uint16_t* codes, int numSamples) {
+        float values[CHUNK];
+        hothouseConvertBlock(input, values, numSamples);
+        hothouseCompandBlock(values, codes, numSamples);
+    }
+
+public:
+    enum { BYTES = Capacity / 2 * 3 };
+
+    DelayStorage() : bytes(nullptr) {}
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        bytes = arena.allocate<uint8_t>(region, BYTES);
+    }
+
+    void clear() {
+        memset(bytes, 0, BYTES);
+    }
+
+    T load(int index) const {
+        return SampleTraits<T>::fromFloat(hothouseExpand(loadCode(index)));
+    }
+
+    void store(int index, T sample) {
+        storeCode(index, hothouseCompand(SampleTraits<T>::toFloat(sample)));
+    }
+
+    void loadSpan(T* output, int start, int numSamples) const {
+        uint16_t codes[CHUNK];
+        while (numSamples > 0) {
+            int count = numSamples < CHUNK ? numSamples : CHUNK;
+            int index = start;
+            int k = 0;
+            if (index & 1) codes[k++] = (uint16_t)loadCode(index++);
+            for (; k + 4 <= count; k += 4, index += 4) {
+                uint64_t quad = 0;
+                memcpy(&quad, bytes + (index >> 1) * 3, 6);  // Little-endian
+                codes[k] = (uint16_t)(quad & 0xFFF);
+                codes[k + 1] = (uint16_t)((quad >> 12) & 0xFFF);
+                codes[k + 2] = (uint16_t)((quad >> 24) & 0xFFF);
+                codes[k + 3] = (uint16_t)(quad >> 36);
+            }
+            for (; k < count; k++) codes[k] = (uint16_t)loadCode(index++);
+            expand(codes, output, count);
+            output += count;
+            start += count;
+            numSamples -= count;
+        }
+    }
+
+    void storeSpan(const T* input, int start, int numSamples) {
+        uint16_t codes[CHUNK];
+        while (numSamples > 0) {
+            int count = numSamples < CHUNK ? numSamples : CHUNK;
+            compand(input, codes, count);
+            int index = start;
+            int k = 0;
+            if (index & 1) storeCode(index++, codes[k++]);
+            for (; k + 4 <= count; k += 4, index += 4) {
+                uint64_t quad = codes[k] | ((uint64_t)codes[k + 1] << 12)
+                                | ((uint64_t)codes[k + 2] << 24) | ((uint64_t)codes[k + 3] << 36);
+                memcpy(bytes + (index >> 1) * 3, &quad, 6);  // Little-endian
+            }
+            for (; k < count; k++) storeCode(index++, codes[k]);
+            input += count;
+            start += count;
+            numSamples -= count;
+        }
+    }
+};
+
+/**
+ * Fractional read modes for DelayLine
+ */
+enum DelayInterpolation {
+    DELAY_INTERP_NONE,     // Truncate to whole samples
+    DELAY_INTERP_LINEAR,   // 2-point linear
+    DELAY_INTERP_CUBIC,    // 4-point, 3rd-order Lagrange
+    DELAY_INTERP_ALLPASS   // 1st-order allpass (stateful: one reader, every sample)
+};
+
+/**
+ * Circular delay line with power-of-two capacity
+ * Positions wrap with a bitmask instead of a modulo or a branch. Storage
+ * comes from a HothouseMemoryArena, in the Storage format (see
+ * DelayStorage; T by default). Delays count writes: read(d) returns
+ * the sample written d writes ago, so reading before writing gives a
+ * d-sample delay for 1 <= d < Capacity (interpolated reads need one
+ * sample of headroom, cubic two). Block reads and writes convert each
+ * contiguous run at once; prefer them when Storage is not T.
+ */
+template <typename T, int Capacity, typename Storage = T>
+class DelayLine {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "DelayLine capacity must be a power of two");
+
+private:
+    enum { MASK = Capacity - 1 };
+
+    DelayStorage<T, Storage, Capacity> storage;
+    int writeIndex;
+    float allpassState;
+
+public:
+    DelayLine() : writeIndex(0), allpassState(0.0f) {}
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        storage.init(arena, region);
+        writeIndex = 0;
+        allpassState = 0.0f;
+    }
+
+    static int capacity() { return Capacity; }
+
+    // Buffer size in bytes, and what init() takes from the arena
+    static constexpr size_t bytes() { return DelayStorage<T, Storage, Capacity>::BYTES; }
+    static constexpr size_t arenaBytes() { return hothouseArenaBytes(bytes()); }
+
+    void clear() {
+        storage.clear();
+        writeIndex = 0;
+        allpassState = 0.0f;
+    }
+
+    void write(T sample) {
+        storage.store(writeIndex, sample);
+        writeIndex = (writeIndex + 1) & MASK;
+    }
+
+    T read(int delay) const {
+        return storage.load((writeIndex - delay) & MASK);
+    }
+
+    // Fractional-delay read, interpolated in float whatever the storage type
+    template <DelayInterpolation Interp>
+    T read(float delay) {
+        typedef SampleTraits<T> Traits;
+        int whole = (int)delay;
+        float frac = delay - (float)whole;
+        switch (Interp) {
+            case DELAY_INTERP_LINEAR: {
+                float a = Traits::toFloat(read(whole));
+                float b = Traits::toFloat(read(whole + 1));
+                return Traits::fromFloat(a + (b - a) * frac);
+            }
+            case DELAY_INTERP_CUBIC: {
+                float xm1 = Traits::toFloat(read(whole - 1));
+                float x0 = Traits::toFloat(read(whole));
+                float x1 = Traits::toFloat(read(whole + 1));
+                float x2 = Traits::toFloat(read(whole + 2));
+                float fm1 = frac - 1.0f;
+                float fm2 = frac - 2.0f;
+                float fp1 = frac + 1.0f;
+                return Traits::fromFloat(-frac * fm1 * fm2 * (1.0f / 6.0f) * xm1
+                                         + fp1 * fm1 * fm2 * 0.5f * x0
+                                         - fp1 * frac * fm2 * 0.5f * x1
+                                         + fp1 * frac * fm1 * (1.0f / 6.0f) * x2);
+            }
+            case DELAY_INTERP_ALLPASS: {
+                float eta = (1.0f - frac) / (1.0f + frac);
+                float x0 = Traits::toFloat(read(whole));
+                float x1 = Traits::toFloat(read(whole + 1));
+                allpassState = x1 + eta * (x0 - allpassState);
+                return Traits::fromFloat(allpassState);
+            }
+            default:
+                return read(whole);
+        }
+    }
+
+    // numSamples <= Capacity
+    void writeBlock(const T* input, int numSamples) {
+        int first = Capacity - writeIndex;
+        if (first > numSamples) first = numSamples;
+        storage.storeSpan(input, writeIndex, first);
+        storage.storeSpan(input + first, 0, numSamples - first);
+        writeIndex = (writeIndex + numSamples) & MASK;
+    }
+
+    /**
+     * Read numSamples consecutive samples, the first one delay writes ago
+     * (output[i] = read(delay - i)). Before writeBlock() a fixed delay d
+     * needs d >= numSamples; after it, pass d + numSamples for any d >= 0.
+     */
+    void readBlock(T* output, int delay, int numSamples) const {
+        int start = (writeIndex - delay) & MASK;
+        int first = Capacity - start;
+        if (first > numSamples) first = numSamples;
+        storage.loadSpan(output, start, first);
+        storage.loadSpan(output + first, 0, numSamples - first);
+    }
+
+    // Fractional block read, output[i] = read<Interp>(delay - i)
+    template <DelayInterpolation Interp>
+    void readBlock(T* output, float delay, int numSamples) {
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = read<Interp>(delay - (float)i);
+        }
+    }
+};
+
+// Utility function to constrain values
+inline float constrain(float value, float min, float max) {
+    if (value < min) return min;
+    if (value > max) return max;
+    return value;
+}
+
+/**
+ * Compile-time index list (std::index_sequence is C++14)
+ */
+template <int... Indices>
+struct HothouseIndexList {};
+
+template <int N, int... Indices>
+struct HothouseMakeIndices : HothouseMakeIndices<N - 1, N - 1, Indices...> {};
+
+template <int... Indices>
+struct HothouseMakeIndices<0, Indices...> {
+    typedef HothouseIndexList<Indices...> type;
+};
+
+/**
+ * Interpolated sine table
+ * One cycle in SINE_TABLE_SIZE steps plus a guard entry, generated at
+ * compile time from a Taylor series in double precision. sineLookup()
+ * interpolates linearly between entries; the error against sin(2*pi*x)
+ * is bounded by (2*pi/SINE_TABLE_SIZE)^2 / 8 = 1.9e-5 (about -94 dB),
+ * plus float rounding. bench/bench_sine checks this against sinf().
+ */
+#define SINE_TABLE_SIZE 512
+
+// Taylor series of sin(x), accurate to ~1e-16 for |x| <= pi
+constexpr double hothouseSineSeries(double x2, double term, double sum, int k) {
+    return k > 15 ? sum
+                  : hothouseSineSeries(x2, -term * x2 / ((2.0 * k) * (2.0 * k + 1.0)), sum + term, k + 1);
+}
+
+// sin(2*pi*i/SINE_TABLE_SIZE), argument reduced to [-pi, pi]
+constexpr double hothouseSineEntry(int i) {
+    return hothouseSineSeries(
+        (6.283185307179586 * (i <= SINE_TABLE_SIZE / 2 ? i : i - SINE_TABLE_SIZE) / SINE_TABLE_SIZE) *
+            (6.283185307179586 * (i <= SINE_TABLE_SIZE / 2 ? i : i - SINE_TABLE_SIZE) / SINE_TABLE_SIZE),
+        6.283185307179586 * (i <= SINE_TABLE_SIZE / 2 ? i : i - SINE_TABLE_SIZE) / SINE_TABLE_SIZE,
+        0.0, 1);
+}
+
+template <typename IndexList>
+struct HothouseSineTable;
+
+template <int... Indices>
+struct HothouseSineTable<HothouseIndexList<Indices...> > {
+    static constexpr float values[sizeof...(Indices)] = {(float)hothouseSineEntry(Indices)...};
+};
+
+template <int... Indices>
+constexpr float HothouseSineTable<HothouseIndexList<Indices...> >::values[sizeof...(Indices)];
+
+typedef HothouseSineTable<HothouseMakeIndices<SINE_TABLE_SIZE + 1>::type> SineTable;
+
+/**
+ * sin(2*pi*phase) for phase >= 0; whole cycles wrap, so 1.0 reads as 0.0
+ */
+inline float sineLookup(float phase) {
+    float position = phase * SINE_TABLE_SIZE;
+    int whole = (int)position;
+    float frac = position - (float)whole;
+    int index = whole & (SINE_TABLE_SIZE - 1);
+    float a = SineTable::values[index];
+    float b = SineTable::values[index + 1];
+    return a + (b - a) * frac;
+}
+
+/**
+ * LFO waveforms for WavetableLfo
+ */
+enum LfoWaveform {
+    LFO_SINE,      // sin(2*pi*phase)
+    LFO_TRIANGLE,  // -1 at phase 0, +1 at phase 0.5
+    LFO_SQUARE,    // +1 for the first half cycle, -1 for the second
+    LFO_SAW,       // Rising, -1 to +1
+    LFO_WAVEFORM_COUNT
+};
+
+/**
+ * Band-limited LFO tables
+ * Triangle, square and saw are Fourier series truncated at
+ * LFO_TABLE_HARMONICS, with Lanczos sigma factors on square and saw to
+ * hold the Gibbs overshoot to about 2%. Triangle is scaled to peak at 1. The rounded edges keep square and
+ * saw from clicking at tremolo depths. Same size and layout as SineTable,
+ * generated at compile time.
+ */
+#define LFO_TABLE_HARMONICS 31
+#define LFO_TABLE_BITS 9  // log2(SINE_TABLE_SIZE)
+
+static_assert((1 << LFO_TABLE_BITS) == SINE_TABLE_SIZE, "LFO_TABLE_BITS must match SINE_TABLE_SIZE");
+static_assert(SINE_TABLE_SIZE % (2 * (LFO_TABLE_HARMONICS + 1)) == 0,
+              "Lanczos factors must fall on SineTable entries");
+
+// sin(2*pi*j/SINE_TABLE_SIZE) for any j >= 0, read from SineTable to keep
+// compile times down
+constexpr double hothouseSineAt(int j) {
+    return SineTable::values[j % SINE_TABLE_SIZE];
+}
+
+// Lanczos sigma factor sinc(k / (H + 1)); sin(pi*k/(H+1)) falls on a SineTable entry
+constexpr double hothouseLanczos(int k) {
+    return hothouseSineAt(k * SINE_TABLE_SIZE / (2 * (LFO_TABLE_HARMONICS + 1))) /
+           (3.141592653589793 * k / (LFO_TABLE_HARMONICS + 1));
+}
+
+// Sum over odd k of cos(2*pi*k*i/N) / k^2
+constexpr double hothouseTriangleSum(int i, int k) {
+    return k > LFO_TABLE_HARMONICS
+               ? 0.0
+               : hothouseSineAt(k * i + SINE_TABLE_SIZE / 4) / ((double)k * k) + hothouseTriangleSum(i, k + 2);
+}
+
+// Sum over odd k of sigma_k * sin(2*pi*k*i/N) / k
+constexpr double hothouseSquareSum(int i, int k) {
+    return k > LFO_TABLE_HARMONICS
+               ? 0.0
+               : hothouseLanczos(k) * hothouseSineAt(k * i) / k + hothouseSquareSum(i, k + 2);
+}
+
+// Sum over all k of sigma_k * sin(2*pi*k*i/N) / k
+constexpr double hothouseSawSum(int i, int k) {
+    return k > LFO_TABLE_HARMONICS
+               ? 0.0
+               : hothouseLanczos(k) * hothouseSineAt(k * i) / k + hothouseSawSum(i, k + 1);
+}
+
+constexpr double hothouseLfoEntry(int waveform, int i) {
+    return waveform == LFO_TRIANGLE ? -hothouseTriangleSum(i, 1) / hothouseTriangleSum(0, 1)  // Peak 1
+         : waveform == LFO_SQUARE   ? 1.2732395447351628 * hothouseSquareSum(i, 1)     // 4/pi
+         : waveform == LFO_SAW      ? -0.6366197723675814 * hothouseSawSum(i, 1)       // 2/pi
+                                    : hothouseSineEntry(i);
+}
+
+template <int Waveform, typename IndexList>
+struct HothouseLfoTable;
+
+template <int Waveform, int... Indices>
+struct HothouseLfoTable<Waveform, HothouseIndexList<Indices...> > {
+    static constexpr float values[sizeof...(Indices)] = {(float)hothouseLfoEntry(Waveform, Indices)...};
+};
+
+template <int Waveform, int... Indices>
+constexpr float HothouseLfoTable<Waveform, HothouseIndexList<Indices...> >::values[sizeof...(Indices)];
+
+inline const float* lfoTable(LfoWaveform waveform) {
+    typedef HothouseMakeIndices<SINE_TABLE_SIZE + 1>::type Indices;
+    static const float* const tables[LFO_WAVEFORM_COUNT] = {
+        SineTable::values,
+        HothouseLfoTable<LFO_TRIANGLE, Indices>::values,
+        HothouseLfoTable<LFO_SQUARE, Indices>::values,
+        HothouseLfoTable<LFO_SAW, Indices>::values
+    };
+    return tables[waveform];
+}
+
+/**
+ * Wavetable LFO with a 32-bit phase accumulator
+ * The phase wraps implicitly on overflow, so there is no per-sample wrap
+ * branch and no drift over long runs. The top LFO_TABLE_BITS select the
+ * table entry, the rest interpolate between entries.
+ */
+class WavetableLfo {
+private:
+    unsigned int phase;
+    unsigned int increment;
+    float sampleRate;
+    const float* table;
+
+    static float lookup(const float* waveTable, unsigned int phase) {
+        unsigned int index = phase >> (32 - LFO_TABLE_BITS);
+        float frac = (float)(phase & ((1u << (32 - LFO_TABLE_BITS)) - 1)) *
+                     (1.0f / (float)(1u << (32 - LFO_TABLE_BITS)));
+        float a = waveTable[index];
+        float b = waveTable[index + 1];
+        return a + (b - a) * frac;
+    }
+
+public:
+    WavetableLfo(float sr = 48000.0f)
+        : phase(0), increment(0), sampleRate(sr), table(lfoTable(LFO_SINE)) {}
+
+    void setSampleRate(float sr) {
+        sampleRate = sr;
+    }
+
+    // Frequency in Hz, up to half the sample rate
+    void setFrequency(float hz) {
+        increment = (unsigned int)((double)hz / sampleRate * 4294967296.0 + 0.5);
+    }
+
+    void setWaveform(LfoWaveform waveform) {
+        table = lfoTable(waveform);
+    }
+
+    // Phase in cycles, [0, 1)
+    void setPhase(float cycles) {
+        phase = (unsigned int)((double)cycles * 4294967296.0);
+    }
+
+    float getPhase() const {
+        return (float)phase * (1.0f / 4294967296.0f);
+    }
+
+    // Current output, without advancing (e.g. for LEDs)
+    float getValue() const {
+        return lookup(table, phase);
+    }
+
+    // Output at the current phase, then advance one sample
+    float process() {
+        float value = lookup(table, phase);
+        phase += increment;
+        return value;
+    }
+
+    // Fill a modulation buffer, one value per sample
+    void renderBlock(float* output, int numSamples) {
+        unsigned int p = phase;
+        const float* waveTable = table;
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = lookup(waveTable, p);
+            p += increment;
+        }
+        phase = p;
+    }
+
+    // Fill a modulation buffer with a crossfade between two waveforms
+    void renderMorph(float* output, int numSamples, LfoWaveform from, LfoWaveform to, float amount) {
+        unsigned int p = phase;
+        const float* fromTable = lfoTable(from);
+        const float* toTable = lfoTable(to);
+        for (int i = 0; i < numSamples; i++) {
+            float a = lookup(fromTable, p);
+            float b = lookup(toTable, p);
+            output[i] = a + (b - a) * amount;
+            p += increment;
+        }
+        phase = p;
+    }
+};
+
+/**
+ * Fast log2/exp2 approximations
+ * Both split the float into exponent and mantissa and fit the mantissa
+ * part with a polynomial, constrained to be exact at the octave ends so
+ * the result stays continuous. Worst-case error (log2 absolute, exp2
+ * relative) and the matching level error in dB:
+ *   FAST_MATH_COARSE  2nd order   log2 7.6e-3 (0.046 dB)   exp2 3.8e-3 (0.033 dB)
+ *   FAST_MATH_MEDIUM  3rd order   log2 8.8e-4 (0.0053 dB)  exp2 1.5e-4 (0.0013 dB)
+ *   FAST_MATH_FINE    5th order   log2 1.7e-5 (0.0001 dB)  exp2 2e-7
+ * fastLog2() expects a positive normal input; fastExp2() clamps its
+ * input to [-126, 127]. bench/bench_fastmath measures the errors.
+ */
+enum FastMathPrecision {
+    FAST_MATH_COARSE,
+    FAST_MATH_MEDIUM,
+    FAST_MATH_FINE
+};
+
+#define HOTHOUSE_DB_PER_LOG2 6.0205999f  // 20 * log10(2)
+
+template <FastMathPrecision Precision>
+inline float fastLog2(float x) {
+    unsigned int bits = hothouseFloatBits(x);
+    float exponent = (float)((int)((bits >> 23) & 0xFF) - 127);
+    float t = hothouseBitsFloat((bits & 0x007FFFFF) | 0x3F800000) - 1.0f;  // [0, 1)
+    float p;
+    switch (Precision) {
+        case FAST_MATH_COARSE:
+            p = t * (1.34655508f - 0.34655508f * t);
+            break;
+        case FAST_MATH_MEDIUM:
+            p = t * (1.42286524f + t * (-0.582085231f + t * 0.159219989f));
+            break;
+        default:
+            p = t * (1.44191703f + t * (-0.709096377f + t * (0.41560588f +
+                t * (-0.193575516f + t * 0.0451489816f))));
+            break;
+    }
+    return exponent + p;
+}
+
+template <FastMathPrecision Precision>
+inline float fastExp2(float x) {
+    if (x < -126.0f) x = -126.0f;
+    if (x > 127.0f) x = 127.0f;
+    int whole = (int)(x + 127.0f) - 127;  // floor, since x + 127 >= 1
+    float f = x - (float)whole;           // [0, 1)
+    float q;
+    switch (Precision) {
+        case FAST_MATH_COARSE:
+            q = 1.0f + f * (0.655713376f + f * 0.344286624f);
+            break;
+        case FAST_MATH_MEDIUM:
+            q = 1.0f + f * (0.695890123f + f * (0.224864956f + f * 0.0792449217f));
+            break;
+        default:
+            q = 1.0f + f * (0.69315298f + f * (0.240147123f + f * (0.0558552966f +
+                f * (0.00894775039f + f * 0.00189684993f))));
+            break;
+    }
+    return hothouseBitsFloat(hothouseFloatBits(q) + ((unsigned int)whole << 23));
+}
+
+/**
+ * Table-driven waveshaper
+ * bake() samples any transfer curve at WAVESHAPER_SEGMENTS + 1 points over
+ * [-inputRange, inputRange] and stores each segment as (value, slope), so
+ * evaluation is one multiply-add to find the segment and one to
+ * interpolate, with no branches and the same cost for every curve.
+ * Inputs beyond the range extend the end segments linearly: pick a range
+ * past the curve's last knee and flat or linear tails stay exact.
+ * processBlock() works four samples at a time on SSE2/NEON (the table
+ * reads are scalar; neither has a gather) and may run in place. A
+ * fixed-point Sample stores the table in that format and looks it up one
+ * sample at a time. Full scale cannot hold the whole table range there,
+ * so callers multiply the shaper input by getInputGain() and its output
+ * by getOutputGain(); both are 1 for float.
+ */
+#define WAVESHAPER_SEGMENTS 512
+
+template <typename Sample>
+class WaveshaperT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    Sample* table;  // WAVESHAPER_SEGMENTS (value, slope) pairs
+    float inputScale;
+    float inputOffset;
+    float inputGain;
+    float outputGain;
+
+public:
+    WaveshaperT()
+        : table(nullptr), inputScale(0.0f), inputOffset(0.0f), inputGain(1.0f), outputGain(1.0f) {}
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        table = arena.allocate<Sample>(region, WAVESHAPER_SEGMENTS * 2);
+    }
+
+    static constexpr size_t arenaBytes() {
+        return hothouseArenaBytes(WAVESHAPER_SEGMENTS * 2 * sizeof(Sample));
+    }
+
+    /**
+     * Sample a transfer curve into the table
+     * Not real-time cheap (WAVESHAPER_SEGMENTS + 1 curve calls): call at
+     * init, or on a mode change rather than per block.
+     * @param curve Any callable float(float)
+     * @param inputRange Table covers [-inputRange, inputRange]
+     * @param headroom Fixed point only: full scale in and out is headroom
+     *                 times inputRange and headroom times 1.0, for curves
+     *                 with linear tails that leave [-1, 1]
+     */
+    template <typename Curve>
+    void bake(Curve curve, float inputRange, float headroom = 1.0f) {
+        outputGain = Traits::IS_FLOAT ? 1.0f : headroom;
+        inputGain = Traits::IS_FLOAT ? 1.0f : 1.0f / (inputRange * headroom);
+        float step = 2.0f * inputRange / WAVESHAPER_SEGMENTS;
+        float previous = curve(-inputRange) / outputGain;
+        for (int i = 0; i < WAVESHAPER_SEGMENTS; i++) {
+            float next = curve(-inputRange + (float)(i + 1) * step) / outputGain;
+            table[2 * i] = Traits::fromFloat(previous);
+            table[2 * i + 1] = Traits::fromFloat(next - previous);
+            previous = next;
+        }
+        inputScale = 1.0f / (step * inputGain);
+        inputOffset = 0.5f * WAVESHAPER_SEGMENTS;
+    }
+
+    // Factor to apply to the input before process()/processBlock()
+    float getInputGain() const {
+        return inputGain;
+    }
+
+    // Factor to apply to the output after process()/processBlock()
+    float getOutputGain() const {
+        return outputGain;
+    }
+
+    Sample process(Sample x) const {
+        const float last = (float)(WAVESHAPER_SEGMENTS - 1);
+        float position = Traits::toFloat(x) * inputScale + inputOffset;
+        float clamped = position < 0.0f ? 0.0f : position;
+        clamped = clamped > last ? last : clamped;
+        int index = (int)clamped;
+        float frac = position - (float)index;
+        return table[2 * index] + Traits::scale(table[2 * index + 1], frac);
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) const {
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = process(input[i]);
+        }
+    }
+};
+
+// Float tables: index and interpolation four samples at a time
+template <>
+inline void WaveshaperT<float>::processBlock(const float* input, float* output,
+                                             int numSamples) const {
+    int i = 0;
+#if defined(HOTHOUSE_SIMD_SSE2)
+    const __m128 scale = _mm_set1_ps(inputScale);
+    const __m128 offset = _mm_set1_ps(inputOffset);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 last = _mm_set1_ps((float)(WAVESHAPER_SEGMENTS - 1));
+    alignas(16) int index[4];
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 position = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), offset);
+        __m128i whole = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(position, zero), last));
+        __m128 frac = _mm_sub_ps(position, _mm_cvtepi32_ps(whole));
+        _mm_store_si128((__m128i*)index, whole);
+        __m128 low = _mm_loadh_pi(_mm_loadl_pi(zero, (const __m64*)(table + 2 * index[0])),
+                                  (const __m64*)(table + 2 * index[1]));
+        __m128 high = _mm_loadh_pi(_mm_loadl_pi(zero, (const __m64*)(table + 2 * index[2])),
+                                   (const __m64*)(table + 2 * index[3]));
+        __m128 value = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 slope = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(output + i, _mm_add_ps(value, _mm_mul_ps(slope, frac)));
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    const float32x4_t scale = vdupq_n_f32(inputScale);
+    const float32x4_t offset = vdupq_n_f32(inputOffset);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t last = vdupq_n_f32((float)(WAVESHAPER_SEGMENTS - 1));
+    int index[4];
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t position = vmlaq_f32(offset, vld1q_f32(input + i), scale);
+        int32x4_t whole = vcvtq_s32_f32(vminq_f32(vmaxq_f32(position, zero), last));
+        float32x4_t frac = vsubq_f32(position, vcvtq_f32_s32(whole));
+        vst1q_s32(index, whole);
+        float32x4_t low = vcombine_f32(vld1_f32(table + 2 * index[0]),
+                                       vld1_f32(table + 2 * index[1]));
+        float32x4_t high = vcombine_f32(vld1_f32(table + 2 * index[2]),
+                                        vld1_f32(table + 2 * index[3]));
+        float32x4x2_t pairs = vuzpq_f32(low, high);
+        vst1q_f32(output + i, vmlaq_f32(pairs.val[0], pairs.val[1], frac));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        output[i] = process(input[i]);
+    }
+}
+
+typedef WaveshaperT<float> Waveshaper;
+
+// Sum of a[i] * b[i]
+template <typename Sample>
+inline Sample hothouseDotProduct(const Sample* a, const Sample* b, int n) {
+    Sample sum = Sample();
+    for (int i = 0; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+template <>
+inline float hothouseDotProduct(const float* a, const float* b, int n) {
+    int i = 0;
+    float sum = 0.0f;
+#if defined(HOTHOUSE_SIMD_SSE)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+#elif defined(HOTHOUSE_SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+    for (; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+// Modified Bessel function of the first kind, order zero (Kaiser windows)
+inline double hothouseBesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > 1e-12 * sum; k++) {
+        term *= (x * x) / (4.0 * k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Half-band interpolation/decimation stage
+ * A linear-phase half-band FIR (Kaiser-windowed sinc, 4 * HalfTaps - 1
+ * taps) in polyphase form: every other tap is zero and the centre tap is
+ * 1/2, so one phase is a pure delay and the other a 2 * HalfTaps dot
+ * product at the lower rate. up() doubles the rate of a block and down()
+ * halves it; each adds 2 * HalfTaps - 1 samples of latency at the higher
+ * rate, and both may run in place. maxBlock bounds the lower-rate length.
+ */
+template <typename Sample, int HalfTaps>
+class HalfbandStage {
+private:
+    typedef SampleTraits<Sample> Traits;
+    enum { BRANCH = 2 * HalfTaps };
+
+    Sample upTaps[BRANCH];    // 2h, reversed
+    Sample downTaps[BRANCH];  // h, reversed
+    Sample* upWork;           // BRANCH - 1 history + block
+    Sample* evenWork;         // BRANCH - 1 history + block
+    Sample* oddWork;          // HalfTaps history + block
+
+public:
+    HalfbandStage() : upWork(nullptr), evenWork(nullptr), oddWork(nullptr) {}
+
+    // What init() takes from the arena for a given maxBlock
+    static constexpr size_t arenaBytes(int maxBlock) {
+        return 2 * hothouseArenaBytes((BRANCH - 1 + maxBlock) * sizeof(Sample)) +
+               hothouseArenaBytes((HalfTaps + maxBlock) * sizeof(Sample));
+    }
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region, int maxBlock, float beta) {
+        upWork = arena.allocate<Sample>(region, BRANCH - 1 + maxBlock);
+        evenWork = arena.allocate<Sample>(region, BRANCH - 1 + maxBlock);
+        oddWork = arena.allocate<Sample>(region, HalfTaps + maxBlock);
+
+        // Odd taps n = -(BRANCH - 1) .. BRANCH - 1, normalized to sum to 1/2
+        // so DC passes exactly
+        const int span = BRANCH - 1;
+        double taps[BRANCH];
+        double sum = 0.0;
+        for (int i = 0; i < BRANCH; i++) {
+            int n = 2 * i - span;
+            double ratio = (double)n / span;
+            double window = hothouseBesselI0(beta * sqrt(1.0 - ratio * ratio)) / hothouseBesselI0(beta);
+            taps[i] = sin(1.5707963267948966 * n) / (3.141592653589793 * n) * window;
+            sum += taps[i];
+        }
+        for (int i = 0; i < BRANCH; i++) {
+            double tap = taps[BRANCH - 1 - i] * 0.5 / sum;
+            upTaps[i] = Traits::fromFloat((float)(2.0 * tap));
+            downTaps[i] = Traits::fromFloat((float)tap);
+        }
+    }
+
+    void reset(int maxBlock) {
+        for (int i = 0; i < BRANCH - 1 + maxBlock; i++) upWork[i] = evenWork[i] = Sample();
+        for (int i = 0; i < HalfTaps + maxBlock; i++) oddWork[i] = Sample();
+    }
+
+    // numSamples in, 2 * numSamples out
+    void up(const Sample* input, Sample* output, int numSamples) {
+        Sample* x = upWork + BRANCH - 1;
+        for (int i = 0; i < numSamples; i++) x[i] = input[i];
+        for (int i = 0; i < numSamples; i++) {
+            output[2 * i] = hothouseDotProduct(upTaps, upWork + i, BRANCH);
+            output[2 * i + 1] = upWork[i + HalfTaps];
+        }
+        memmove(upWork, upWork + numSamples, sizeof(Sample) * (BRANCH - 1));
+    }
+
+    // 2 * numSamples in, numSamples out
+    void down(const Sample* input, Sample* output, int numSamples) {
+        const Sample half = Traits::fromFloat(0.5f);
+        Sample* even = evenWork + BRANCH - 1;
+        Sample* odd = oddWork + HalfTaps;
+        for (int i = 0; i < numSamples; i++) {
+            even[i] = input[2 * i];
+            odd[i] = input[2 * i + 1];
+        }
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = hothouseDotProduct(downTaps, evenWork + i, BRANCH) + oddWork[i] * half;
+        }
+        memmove(evenWork, evenWork + numSamples, sizeof(Sample) * (BRANCH - 1));
+        memmove(oddWork, oddWork + numSamples, sizeof(Sample) * HalfTaps);
+    }
+};
+
+/**
+ * Oversampler for nonlinear stages
+ * Runs a block at Factor (1, 2, 4 or 8) times the base rate through a
+ * cascade of half-band stages, each with about 80 dB of stopband:
+ *   fs <-> 2fs   63 taps   2fs <-> 4fs   23 taps   4fs <-> 8fs   15 taps
+ * Wrapping a stage is one line:
+ *   oversampler.process(block, n, [&](Sample* x, int m) { shaper.processBlock(x, x, m); });
+ * or use upsample()/downsample() around code that needs both rates.
+ * The filters are linear phase and a short pad rounds the round trip up
+ * to LATENCY whole base-rate samples (31, 37 and 39 for 2x, 4x and 8x);
+ * alignDry() delays a dry path by the same amount. Factor 1 passes
+ * straight through at no cost. Blocks hold up to
+ * HOTHOUSE_MAX_CONTROL_BLOCK base-rate samples.
+ */
+#define OVERSAMPLER_STAGE1_HALF_TAPS 16
+#define OVERSAMPLER_STAGE2_HALF_TAPS 6
+#define OVERSAMPLER_STAGE3_HALF_TAPS 4
+
+template <int Factor, typename Sample = float>
+class Oversampler {
+    static_assert(Factor == 1 || Factor == 2 || Factor == 4 || Factor == 8,
+                  "Oversampler factor must be 1, 2, 4 or 8");
+
+public:
+    // Round-trip delay, in samples at the oversampled rate and then the base rate
+    enum {
+        FILTER_LATENCY = (Factor >= 2 ? (4 * OVERSAMPLER_STAGE1_HALF_TAPS - 2) * (Factor / 2) : 0)
+                       + (Factor >= 4 ? (4 * OVERSAMPLER_STAGE2_HALF_TAPS - 2) * (Factor / 4) : 0)
+                       + (Factor >= 8 ? (4 * OVERSAMPLER_STAGE3_HALF_TAPS - 2) : 0),
+        PAD = (Factor - FILTER_LATENCY % Factor) % Factor,
+        LATENCY = (FILTER_LATENCY + PAD) / Factor
+    };
+
+private:
+    enum { MAX_BLOCK = HOTHOUSE_MAX_CONTROL_BLOCK };
+
+    typedef HalfbandStage<Sample, OVERSAMPLER_STAGE1_HALF_TAPS> Stage1;
+    typedef HalfbandStage<Sample, OVERSAMPLER_STAGE2_HALF_TAPS> Stage2;
+    typedef HalfbandStage<Sample, OVERSAMPLER_STAGE3_HALF_TAPS> Stage3;
+    typedef DelayLine<Sample, 256> DryLine;
+
+    Stage1 stage1;                // fs <-> 2fs
+    Stage2 stage2;                // 2fs <-> 4fs
+    Stage3 stage3;                // 4fs <-> 8fs
+    Sample* buffer;               // Factor * MAX_BLOCK, at the oversampled rate
+    Sample pad[PAD > 0 ? PAD : 1];
+    DryLine dryLine;
+
+    // Only reads input; non-const so GCC does not flag a caller's partly
+    // written block as possibly uninitialized at 8x, where this is not inlined
+    Sample* interpolate(Sample* input, int numSamples) {
+        if (Factor == 1) {
+            hothouseConvertBlock(input, buffer, numSamples);
+            return buffer;
+        }
+        stage1.up(input, buffer, numSamples);
+        if (Factor >= 4) stage2.up(buffer, buffer, 2 * numSamples);
+        if (Factor >= 8) stage3.up(buffer, buffer, 4 * numSamples);
+        return buffer;
+    }
+
+public:
+    Oversampler() : buffer(nullptr) {
+        for (int i = 0; i < (PAD > 0 ? PAD : 1); i++) pad[i] = Sample();
+    }
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        buffer = arena.allocate<Sample>(region, Factor * MAX_BLOCK);
+        if (Factor == 1) return;
+        stage1.init(arena, region, MAX_BLOCK, 8.0f);
+        if (Factor >= 4) stage2.init(arena, region, 2 * MAX_BLOCK, 8.0f);
+        if (Factor >= 8) stage3.init(arena, region, 4 * MAX_BLOCK, 7.0f);
+        dryLine.init(arena, region);
+    }
+
+    static constexpr size_t arenaBytes() {
+        return hothouseArenaBytes(Factor * MAX_BLOCK * sizeof(Sample))
+             + (Factor >= 2 ? Stage1::arenaBytes(MAX_BLOCK) + DryLine::arenaBytes() : 0)
+             + (Factor >= 4 ? Stage2::arenaBytes(2 * MAX_BLOCK) : 0)
+             + (Factor >= 8 ? Stage3::arenaBytes(4 * MAX_BLOCK) : 0);
+    }
+
+    static int factor() { return Factor; }
+    static int latency() { return LATENCY; }
+
+    void reset() {
+        if (Factor == 1) return;
+        stage1.reset(MAX_BLOCK);
+        if (Factor >= 4) stage2.reset(2 * MAX_BLOCK);
+        if (Factor >= 8) stage3.reset(4 * MAX_BLOCK);
+        for (int i = 0; i < PAD; i++) pad[i] = Sample();
+        dryLine.clear();
+    }
+
+    /**
+     * Interpolate numSamples base-rate samples
+     * @return Factor * numSamples samples, valid until the next call
+     */
+    Sample* upsample(const Sample* input, int numSamples) {
+        return interpolate(const_cast<Sample*>(input), numSamples);
+    }
+
+    // Decimate the buffer returned by upsample() back to numSamples
+    void downsample(Sample* output, int numSamples) {
+        if (Factor == 1) {
+            hothouseConvertBlock(buffer, output, numSamples);
+            return;
+        }
+        if (PAD > 0) {
+            int length = Factor * numSamples;
+            Sample tail[PAD > 0 ? PAD : 1];
+            for (int i = 0; i < PAD; i++) tail[i] = buffer[length - PAD + i];
+            memmove(buffer + PAD, buffer, sizeof(Sample) * (length - PAD));
+            for (int i = 0; i < PAD; i++) {
+                buffer[i] = pad[i];
+                pad[i] = tail[i];
+            }
+        }
+        if (Factor >= 8) stage3.down(buffer, buffer, 4 * numSamples);
+        if (Factor >= 4) stage2.down(buffer, buffer, 2 * numSamples);
+        stage1.down(buffer, output, numSamples);
+    }
+
+    // Run stage(samples, count) on samples at Factor times the rate, in place
+    template <typename Stage>
+    void process(Sample* samples, int numSamples, Stage stage) {
+        if (Factor == 1) {
+            stage(samples, numSamples);
+            return;
+        }
+        stage(interpolate(samples, numSamples), Factor * numSamples);
+        downsample(samples, numSamples);
+    }
+
+    /**
+     * Delay a base-rate block by LATENCY, so a dry path lines up with the
+     * processed one
+     * @return input itself when there is no latency, otherwise scratch
+     */
+    const Sample* alignDry(const Sample* input, Sample* scratch, int numSamples) {
+        if (LATENCY == 0) return input;
+        dryLine.writeBlock(input, numSamples);
+        dryLine.readBlock(scratch, LATENCY + numSamples, numSamples);
+        return scratch;
+    }
+};
+
+/**
+ * Clipping curve with closed-form antiderivatives
+ * Linear tails beyond lowerKnee and upperKnee and, between the knees,
+ * either the identity or tanhApprox(scale * x). That covers the drive
+ * pedals' hard, soft and asymmetric clippers. It is callable, so it can
+ * bake a Waveshaper, and antiderivative1()/antiderivative2() (the first
+ * and second integrals from zero) drive AdaaClipperT.
+ */
+class ClipCurve {
+public:
+    enum Region { REGION_LOWER, REGION_MIDDLE, REGION_UPPER };
+
+private:
+    // Per region: x - knee[r] = d gives value[r] + slope[r] * d, and the
+    // integrals at the knee seed the antiderivatives. The middle region
+    // is the identity (knee 0, slope 1) unless it is rational.
+    double knee[3];
+    double value[3];
+    double slope[3];
+    double integral1[3];
+    double integral2[3];
+    float lowerKnee;
+    float upperKnee;
+    float scale;
+    bool rational;
+
+    // Antiderivatives of tanhApprox(u) = u/9 + (8/3) u/(u^2 + 3)
+    template <typename Real>
+    static Real rationalIntegral1(Real u) {
+        return u * u / (Real)18 + (Real)(4.0 / 3.0) * log1p(u * u / (Real)3);
+    }
+
+    template <typename Real>
+    static Real rationalIntegral2(Real u) {
+        const Real root3 = (Real)1.7320508075688772;
+        return u * u * u / (Real)54
+               + (Real)(4.0 / 3.0) * (u * log1p(u * u / (Real)3) - (Real)2 * u
+                                      + (Real)2 * root3 * atan(u / root3));
+    }
+
+    void setTail(int r, double kneeX, double kneeValue, double tailSlope) {
+        knee[r] = kneeX;
+        value[r] = kneeValue;
+        slope[r] = tailSlope;
+        integral1[r] = antiderivative1(kneeX);
+        integral2[r] = antiderivative2(kneeX);
+    }
+
+    ClipCurve(float lower, float upper, float middleScale, bool middleRational)
+        : lowerKnee(lower), upperKnee(upper), scale(middleScale), rational(middleRational) {
+        for (int r = 0; r < 3; r++) {
+            knee[r] = value[r] = integral1[r] = integral2[r] = 0.0;
+            slope[r] = r == REGION_MIDDLE ? 1.0 : 0.0;
+        }
+    }
+
+public:
+    ClipCurve() : ClipCurve(-1.0f, 1.0f, 1.0f, false) {
+        setTail(REGION_LOWER, -1.0, -1.0, 0.0);
+        setTail(REGION_UPPER, 1.0, 1.0, 0.0);
+    }
+
+    // Rational tanh approximation, exact at 0 and close to tanh up to |u| = 1
+    template <typename Real>
+    static Real tanhApprox(Real u) {
+        Real u2 = u * u;
+        return u * ((Real)27 + u2) / ((Real)27 + (Real)9 * u2);
+    }
+
+    // Clip to [-threshold, threshold]
+    static ClipCurve hard(float threshold) {
+        return asymmetric(threshold, 0.0f, -threshold, 0.0f);
+    }
+
+    // Identity between the knees, then the given slopes beyond them
+    static ClipCurve asymmetric(float upperKnee, float upperSlope, float lowerKnee, float lowerSlope) {
+        ClipCurve curve(lowerKnee, upperKnee, 1.0f, false);
+        curve.setTail(REGION_LOWER, lowerKnee, lowerKnee, lowerSlope);
+        curve.setTail(REGION_UPPER, upperKnee, upperKnee, upperSlope);
+        return curve;
+    }
+
+    // tanhApprox(scale * x) within [-knee, knee], +/-tail beyond
+    static ClipCurve soft(float scale, float knee, float tail) {
+        ClipCurve curve(-knee, knee, scale, true);
+        curve.setTail(REGION_LOWER, -knee, -tail, 0.0);
+        curve.setTail(REGION_UPPER, knee, tail, 0.0);
+        return curve;
+    }
+
+    int region(double x) const {
+        return x > upperKnee ? REGION_UPPER : (x < lowerKnee ? REGION_LOWER : REGION_MIDDLE);
+    }
+
+    bool isLinear(int r) const {
+        return r != REGION_MIDDLE || !rational;
+    }
+
+    float operator()(float x) const {
+        return evaluate(x);
+    }
+
+    template <typename Real>
+    Real evaluate(Real x) const {
+        int r = region(x);
+        if (r == REGION_MIDDLE && rational) return tanhApprox((Real)scale * x);
+        return (Real)value[r] + (Real)slope[r] * (x - (Real)knee[r]);
+    }
+
+    template <typename Real>
+    Real antiderivative1(Real x) const {
+        int r = region(x);
+        if (r == REGION_MIDDLE && rational) return rationalIntegral1((Real)scale * x) / (Real)scale;
+        Real d = x - (Real)knee[r];
+        return (Real)integral1[r] + d * ((Real)value[r] + d * (Real)slope[r] * (Real)0.5);
+    }
+
+    template <typename Real>
+    Real antiderivative2(Real x) const {
+        int r = region(x);
+        if (r == REGION_MIDDLE && rational) {
+            return rationalIntegral2((Real)scale * x) / ((Real)scale * (Real)scale);
+        }
+        Real d = x - (Real)knee[r];
+        return (Real)integral2[r]
+               + d * ((Real)integral1[r] + d * ((Real)value[r] * (Real)0.5 + d * (Real)slope[r] / (Real)6));
+    }
+
+    /**
+     * (antiderivative2(x) - antiderivative2(previous)) / (x - previous)
+     * for two points in the same linear region r, without cancellation
+     */
+    template <typename Real>
+    Real linearDifference(int r, Real x, Real previous) const {
+        Real d = x - (Real)knee[r];
+        Real p = previous - (Real)knee[r];
+        return (Real)integral1[r] + (Real)value[r] * (d + p) * (Real)0.5
+               + (Real)slope[r] * (d * d + d * p + p * p) / (Real)6;
+    }
+};
+
+// Divided differences closer than this fall back to a direct evaluation
+inline float hothouseAdaaEpsilon(float) {
+    return 1.0e-3f;
+}
+
+inline double hothouseAdaaEpsilon(double) {
+    return 1.0e-6;
+}
+
+/**
+ * Antiderivative antialiasing (ADAA) for a ClipCurve, at the base rate
+ * Order 1 outputs the mean of the curve between consecutive inputs,
+ * (F1(x) - F1(x1)) / (x - x1); order 2 does the same one level up with
+ * F2 and suppresses aliasing further. Order 0 is the plain curve.
+ * Ill-conditioning fallbacks:
+ *   - consecutive inputs in one linear region use the exact mean of the
+ *     line, so long tails never subtract large antiderivatives
+ *   - inputs closer than hothouseAdaaEpsilon() evaluate the curve (or F1)
+ *     at their midpoint
+ * Second order cancels too badly in float, so it works in double.
+ * Delay is half a sample for order 1 and one sample for order 2;
+ * LATENCY is the whole-sample part, for alignDry().
+ */
+template <typename Sample, int Order>
+class AdaaClipperT {
+    static_assert(Order >= 0 && Order <= 2, "ADAA order must be 0, 1 or 2");
+
+public:
+    enum { LATENCY = Order / 2 };
+
+private:
+    typedef SampleTraits<Sample> Traits;
+    typedef typename std::conditional<Order == 2, double, float>::type Real;
+
+    Real x1;          // Previous input
+    Real x2;          // Input before that (order 2)
+    Real difference;  // Previous divided difference of F2 (order 2)
+    Sample dryZ;      // alignDry() state
+
+    Real firstOrder(const ClipCurve& curve, Real x) const {
+        int r = curve.region(x);
+        Real dx = x - x1;
+        if ((r == curve.region(x1) && curve.isLinear(r)) || fabs(dx) < hothouseAdaaEpsilon(dx)) {
+            return curve.evaluate((x + x1) * (Real)0.5);
+        }
+        return (curve.antiderivative1(x) - curve.antiderivative1(x1)) / dx;
+    }
+
+    // (F2(x) - F2(previous)) / (x - previous)
+    Real divideF2(const ClipCurve& curve, Real x, Real previous) const {
+        int r = curve.region(x);
+        if (r == curve.region(previous) && curve.isLinear(r)) {
+            return curve.linearDifference(r, x, previous);
+        }
+        Real dx = x - previous;
+        if (fabs(dx) < hothouseAdaaEpsilon(dx)) return curve.antiderivative1((x + previous) * (Real)0.5);
+        return (curve.antiderivative2(x) - curve.antiderivative2(previous)) / dx;
+    }
+
+    Real secondOrder(const ClipCurve& curve, Real x) {
+        const Real epsilon = hothouseAdaaEpsilon(x);
+        Real d = divideF2(curve, x, x1);
+        Real span = x - x2;
+        int r = curve.region(x);
+        Real y;
+        if (r == curve.region(x1) && r == curve.region(x2) && curve.isLinear(r)) {
+            y = curve.evaluate((x + x1 + x2) / (Real)3);
+        } else if (fabs(span) >= epsilon) {
+            y = (Real)2 * (d - difference) / span;
+        } else {
+            // x and x2 coincide: expand around their mean
+            Real mean = (x + x2) * (Real)0.5;
+            Real delta = mean - x1;
+            if (fabs(delta) < epsilon) {
+                y = curve.evaluate((mean + x1) * (Real)0.5);
+            } else {
+                y = (Real)2 / delta
+                    * (curve.antiderivative1(mean)
+                       + (curve.antiderivative2(x1) - curve.antiderivative2(mean)) / delta);
+            }
+        }
+        difference = d;
+        x2 = x1;
+        return y;
+    }
+
+public:
+    AdaaClipperT() {
+        reset();
+    }
+
+    void reset() {
+        x1 = x2 = difference = (Real)0;
+        dryZ = Sample();
+    }
+
+    /**
+     * Clip a block, in place or not
+     * @param inputScale Multiplies each input sample before the curve
+     * @param outputScale Multiplies each curve output
+     */
+    void processBlock(const ClipCurve& curve, const Sample* input, Sample* output, int numSamples,
+                      float inputScale = 1.0f, float outputScale = 1.0f) {
+        for (int i = 0; i < numSamples; i++) {
+            Real x = (Real)Traits::toFloat(input[i]) * (Real)inputScale;
+            Real y;
+            if (Order == 0) {
+                y = curve.evaluate(x);
+            } else if (Order == 1) {
+                y = firstOrder(curve, x);
+            } else {
+                y = secondOrder(curve, x);
+            }
+            x1 = x;
+            output[i] = Traits::fromFloat((float)y * outputScale);
+        }
+    }
+
+    // Delay a dry block by LATENCY (see Oversampler::alignDry())
+    const Sample* alignDry(const Sample* input, Sample* scratch, int numSamples) {
+        if (LATENCY == 0 || numSamples <= 0) return input;
+        scratch[0] = dryZ;
+        for (int i = 1; i < numSamples; i++) scratch[i] = input[i - 1];
+        dryZ = input[numSamples - 1];
+        return scratch;
+    }
+};
+
+/**
+ * Antialiasing choices for ClipStageT: an oversampling factor (1, 2, 4
+ * or 8) or one of these
+ */
+enum ClipAntialiasing {
+    ADAA_FIRST_ORDER = -1,
+    ADAA_SECOND_ORDER = -2
+};
+
+/**
+ * Antialiased clipping stage
+ * Holds Voices ClipCurves and runs one of them over a block:
+ *   - Antialiasing 1, 2, 4 or 8: a baked Waveshaper table, oversampled by
+ *     that factor (1 is the plain table)
+ *   - ADAA_FIRST_ORDER or ADAA_SECOND_ORDER: the closed-form curve at the
+ *     base rate through AdaaClipperT, with no tables or buffers
+ * Fixed-point gains follow WaveshaperT::bake() either way.
+ */
+template <typename Sample, int Antialiasing, int Voices = 1>
+class ClipStageT {
+public:
+    enum {
+        ADAA_ORDER = Antialiasing < 0 ? -Antialiasing : 0,
+        FACTOR = Antialiasing > 0 ? Antialiasing : 1
+    };
+
+private:
+    typedef SampleTraits<Sample> Traits;
+    typedef Oversampler<FACTOR, Sample> OversamplerType;
+    typedef AdaaClipperT<Sample, ADAA_ORDER> AdaaType;
+
+public:
+    enum { LATENCY = ADAA_ORDER > 0 ? (int)AdaaType::LATENCY : (int)OversamplerType::LATENCY };
+
+private:
+    ClipCurve curves[Voices];
+    WaveshaperT<Sample> shapers[Voices];  // Oversampled only
+    float inputGains[Voices];             // ADAA only
+    float outputGains[Voices];
+    OversamplerType oversampler;
+    AdaaType adaa;
+
+public:
+    ClipStageT() {
+        for (int v = 0; v < Voices; v++) inputGains[v] = outputGains[v] = 1.0f;
+    }
+
+    void init(HothouseMemoryArena& arena, MemoryRegion region) {
+        if (ADAA_ORDER > 0) return;
+        for (int v = 0; v < Voices; v++) shapers[v].init(arena, region);
+        oversampler.init(arena, region);
+    }
+
+    static constexpr size_t arenaBytes() {
+        return ADAA_ORDER > 0 ? 0
+                              : Voices * WaveshaperT<Sample>::arenaBytes() + OversamplerType::arenaBytes();
+    }
+
+    /**
+     * Set a voice's curve
+     * Not real-time cheap when oversampling (bakes a table).
+     * @param inputRange, headroom As for WaveshaperT::bake()
+     */
+    void setVoice(int voice, const ClipCurve& curve, float inputRange, float headroom = 1.0f) {
+        curves[voice] = curve;
+        if (ADAA_ORDER > 0) {
+            inputGains[voice] = Traits::IS_FLOAT ? 1.0f : 1.0f / (inputRange * headroom);
+            outputGains[voice] = Traits::IS_FLOAT ? 1.0f : headroom;
+        } else {
+            shapers[voice].bake(curve, inputRange, headroom);
+        }
+    }
+
+    // Factor to apply to the input before process()
+    float getInputGain(int voice) const {
+        return ADAA_ORDER > 0 ? inputGains[voice] : shapers[voice].getInputGain();
+    }
+
+    // Factor to apply to the output after process()
+    float getOutputGain(int voice) const {
+        return ADAA_ORDER > 0 ? outputGains[voice] : shapers[voice].getOutputGain();
+    }
+
+    // Clip a base-rate block in place through the given voice
+    void process(int voice, Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        if (ADAA_ORDER > 0) {
+            adaa.processBlock(curves[voice], samples, samples, numSamples, 1.0f / inputGains[voice],
+                              1.0f / outputGains[voice]);
+            return;
+        }
+        const WaveshaperT<Sample>& shaper = shapers[voice];
+        oversampler.process(samples, numSamples, [&shaper](Sample* x, int n) { shaper.processBlock(x, x, n); });
+    }
+
+    // Delay a dry block by LATENCY, so it lines up with process()
+    const Sample* alignDry(const Sample* input, Sample* scratch, int numSamples) {
+        if (ADAA_ORDER > 0) return adaa.alignDry(input, scratch, numSamples);
+        return oversampler.alignDry(input, scratch, numSamples);
+    }
+
+    void reset() {
+        oversampler.reset();
+        adaa.reset();
+    }
+};
+
+/**
+ * Four float lanes for the filter banks: one SSE or NEON register, or a
+ * plain array on other targets
+ */
+struct HothouseFloat4 {
+#if defined(HOTHOUSE_SIMD_SSE)
+    __m128 v;
+
+    static HothouseFloat4 load(const float* p) { HothouseFloat4 r; r.v = _mm_loadu_ps(p); return r; }
+    static HothouseFloat4 set1(float x) { HothouseFloat4 r; r.v = _mm_set1_ps(x); return r; }
+    static HothouseFloat4 lanes(float a, float b, float c, float d) {
+        HothouseFloat4 r;
+        r.v = _mm_setr_ps(a, b, c, d);
+        return r;
+    }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    HothouseFloat4 operator+(HothouseFloat4 o) const { HothouseFloat4 r; r.v = _mm_add_ps(v, o.v); return r; }
+    HothouseFloat4 operator-(HothouseFloat4 o) const { HothouseFloat4 r; r.v = _mm_sub_ps(v, o.v); return r; }
+    HothouseFloat4 operator*(HothouseFloat4 o) const { HothouseFloat4 r; r.v = _mm_mul_ps(v, o.v); return r; }
+
+    static void transpose(HothouseFloat4& a, HothouseFloat4& b, HothouseFloat4& c, HothouseFloat4& d) {
+        _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+    }
+#elif defined(HOTHOUSE_SIMD_NEON)
+    float32x4_t v;
+
+    static HothouseFloat4 load(const float* p) { HothouseFloat4 r; r.v = vld1q_f32(p); return r; }
+    static HothouseFloat4 set1(float x) { HothouseFloat4 r; r.v = vdupq_n_f32(x); return r; }
+    static HothouseFloat4 lanes(float a, float b, float c, float d) {
+        float p[4] = {a, b, c, d};
+        return load(p);
+    }
+    void store(float* p) const { vst1q_f32(p, v); }
+    HothouseFloat4 operator+(HothouseFloat4 o) const { HothouseFloat4 r; r.v = vaddq_f32(v, o.v); return r; }
+    HothouseFloat4 operator-(HothouseFloat4 o) const { HothouseFloat4 r; r.v = vsubq_f32(v, o.v); return r; }
+    HothouseFloat4 operator*(HothouseFloat4 o) const { HothouseFloat4 r; r.v = vmulq_f32(v, o.v); return r; }
+
+    static void transpose(HothouseFloat4& a, HothouseFloat4& b, HothouseFloat4& c, HothouseFloat4& d) {
+        float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+        float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+        a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+        b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+        c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+        d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+    }
+#else
+    float v[4];
+
+    static HothouseFloat4 load(const float* p) { return lanes(p[0], p[1], p[2], p[3]); }
+    static HothouseFloat4 set1(float x) { return lanes(x, x, x, x); }
+    static HothouseFloat4 lanes(float a, float b, float c, float d) {
+        HothouseFloat4 r;
+        r.v[0] = a; r.v[1] = b; r.v[2] = c; r.v[3] = d;
+        return r;
+    }
+    void store(float* p) const { for (int l = 0; l < 4; l++) p[l] = v[l]; }
+    HothouseFloat4 operator+(HothouseFloat4 o) const { HothouseFloat4 r; for (int l = 0; l < 4; l++) r.v[l] = v[l] + o.v[l]; return r; }
+    HothouseFloat4 operator-(HothouseFloat4 o) const { HothouseFloat4 r; for (int l = 0; l < 4; l++) r.v[l] = v[l] - o.v[l]; return r; }
+    HothouseFloat4 operator*(HothouseFloat4 o) const { HothouseFloat4 r; for (int l = 0; l < 4; l++) r.v[l] = v[l] * o.v[l]; return r; }
+
+    static void transpose(HothouseFloat4& a, HothouseFloat4& b, HothouseFloat4& c, HothouseFloat4& d) {
+        HothouseFloat4 rows[4] = {a, b, c, d};
+        a = lanes(rows[0].v[0], rows[1].v[0], rows[2].v[0], rows[3].v[0]);
+        b = lanes(rows[0].v[1], rows[1].v[1], rows[2].v[1], rows[3].v[1]);
+        c = lanes(rows[0].v[2], rows[1].v[2], rows[2].v[2], rows[3].v[2]);
+        d = lanes(rows[0].v[3], rows[1].v[3], rows[2].v[3], rows[3].v[3]);
+    }
+#endif
+};
+
+/**
+ * Filters
+ * Recursive filters keep their coefficients as members and recompute
+ * them only when a setter sees a new value, so pedals can call the
+ * setters every control block. One-pole, shelf and one-zero filters run
+ * in the Sample type; biquads and the SVF keep float state and
+ * coefficients (their coefficients exceed the fixed-point range) and
+ * convert at their edges.
+ */
+
+// 1 - exp(-2 pi hz / sampleRate): one-pole coefficient for a -3 dB cutoff
+inline float hothouseOnePoleCoefficient(float hz, float sampleRate) {
+    return 1.0f - expf(-6.28318530718f * hz / sampleRate);
+}
+
+/**
+ * Coefficient as a function of a 0-1 control, tabulated at init
+ * The pedals tune a coefficient as a linear function of a knob at the
+ * reference rate; the table holds that function moved to the running
+ * rate, so control-rate code interpolates instead of calling powf().
+ */
+template <int Segments = 64>
+class CoefficientTable {
+private:
+    float values[Segments + 1];
+
+public:
+    CoefficientTable() {
+        for (int i = 0; i <= Segments; i++) values[i] = 0.0f;
+    }
+
+    // One-pole coefficients base + x * span at the reference rate
+    void buildOnePole(float base, float span, float sampleRate) {
+        for (int i = 0; i <= Segments; i++) {
+            values[i] = hothouseRescaleOnePole(base + span * i / Segments, sampleRate);
+        }
+    }
+
+    // Poles base + x * span at the reference rate
+    void buildPole(float base, float span, float sampleRate) {
+        for (int i = 0; i <= Segments; i++) {
+            values[i] = hothouseRescalePole(base + span * i / Segments, sampleRate);
+        }
+    }
+
+    float operator()(float x) const {
+        float position = x * Segments;
+        if (position <= 0.0f) return values[0];
+        if (position >= Segments) return values[Segments];
+        int index = (int)position;
+        float frac = position - (float)index;
+        return values[index] + (values[index + 1] - values[index]) * frac;
+    }
+};
+
+/**
+ * One-pole low-pass: y = coefficient * x + (1 - coefficient) * y
+ * DenormalDc adds HOTHOUSE_DENORMAL_DC to the state, for filters inside
+ * feedback loops.
+ */
+template <typename Sample, bool DenormalDc = false>
+class OnePoleT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    Sample coefficient;
+    Sample keep;  // 1 - coefficient
+    Sample state;
+    float currentCoefficient;
+    float currentPole;
+
+public:
+    OnePoleT()
+        : coefficient(Traits::fromFloat(1.0f)), keep(), state(), currentCoefficient(1.0f), currentPole(0.0f) {}
+
+    void setCoefficient(float c) {
+        if (c == currentCoefficient) return;
+        currentCoefficient = c;
+        currentPole = -1.0f;
+        coefficient = Traits::fromFloat(c);
+        keep = Traits::fromFloat(1.0f - c);
+    }
+
+    // Set by the pole instead: y = (1 - pole) * x + pole * y
+    void setPole(float pole) {
+        if (pole == currentPole) return;
+        currentPole = pole;
+        currentCoefficient = -1.0f;
+        coefficient = Traits::fromFloat(1.0f - pole);
+        keep = Traits::fromFloat(pole);
+    }
+
+    void setCutoff(float hz, float sampleRate) {
+        setCoefficient(hothouseOnePoleCoefficient(hz, sampleRate));
+    }
+
+    Sample process(Sample x) {
+        state = coefficient * x + keep * state;
+        if (DenormalDc) state = state + Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        return state;
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        const Sample denormalDc = Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        Sample z = state;
+        for (int i = 0; i < numSamples; i++) {
+            z = DenormalDc ? coefficient * input[i] + keep * z + denormalDc
+                           : coefficient * input[i] + keep * z;
+            output[i] = z;
+        }
+        state = z;
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    Sample getState() const { return state; }
+    void reset() { state = Sample(); }
+};
+
+/**
+ * Low shelf from a one-pole: y = x + gain * lowpass(x)
+ * Gain -1 removes the band below the cutoff, positive gains boost it.
+ */
+template <typename Sample>
+class OnePoleShelfT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    OnePoleT<Sample> lowpass;
+    Sample gain;
+    float currentGain;
+
+public:
+    OnePoleShelfT() : gain(), currentGain(0.0f) {}
+
+    void setCoefficient(float c) { lowpass.setCoefficient(c); }
+    void setCutoff(float hz, float sampleRate) { lowpass.setCutoff(hz, sampleRate); }
+
+    void setGain(float g) {
+        if (g == currentGain) return;
+        currentGain = g;
+        gain = Traits::fromFloat(g);
+    }
+
+    Sample process(Sample x) {
+        return x + lowpass.process(x) * gain;
+    }
+
+    // Any length: the low band goes through a stack buffer a chunk at a time
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        Sample low[HOTHOUSE_MAX_CONTROL_BLOCK];
+        for (int offset = 0; offset < numSamples; offset += HOTHOUSE_MAX_CONTROL_BLOCK) {
+            int n = numSamples - offset;
+            if (n > HOTHOUSE_MAX_CONTROL_BLOCK) n = HOTHOUSE_MAX_CONTROL_BLOCK;
+            lowpass.processBlock(input + offset, low, n);
+            for (int i = 0; i < n; i++) output[offset + i] = input[offset + i] + low[i] * gain;
+        }
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    void reset() { lowpass.reset(); }
+};
+
+/**
+ * One-zero high-pass: y = x - coefficient * x[n-1]
+ * With a coefficient near 1 this rejects DC but rises 6 dB/octave up to
+ * Nyquist, so it brightens as well; DcBlockerT is flat above its corner.
+ */
+template <typename Sample>
+class OneZeroT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    Sample coefficient;
+    Sample previous;
+    float current;
+
+public:
+    OneZeroT() : coefficient(), previous(), current(0.0f) {}
+
+    void setCoefficient(float c) {
+        if (c == current) return;
+        current = c;
+        coefficient = Traits::fromFloat(c);
+    }
+
+    Sample process(Sample x) {
+        Sample y = x - previous * coefficient;
+        previous = x;
+        return y;
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        Sample z = previous;
+        for (int i = 0; i < numSamples; i++) {
+            Sample x = input[i];
+            output[i] = x - z * coefficient;
+            z = x;
+        }
+        previous = z;
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    void reset() { previous = Sample(); }
+};
+
+/**
+ * DC blocker: y = x - x[n-1] + pole * y[n-1]
+ * Flat above a corner of about (1 - pole) * sampleRate / (2 pi).
+ */
+template <typename Sample>
+class DcBlockerT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    Sample pole;
+    Sample previousInput;
+    Sample previousOutput;
+    float current;
+
+public:
+    DcBlockerT() : pole(Traits::fromFloat(0.995f)), previousInput(), previousOutput(), current(0.995f) {}
+
+    void setPole(float p) {
+        if (p == current) return;
+        current = p;
+        pole = Traits::fromFloat(p);
+    }
+
+    void setCutoff(float hz, float sampleRate) {
+        setPole(1.0f - hothouseOnePoleCoefficient(hz, sampleRate));
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        const Sample denormalDc = Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        Sample x1 = previousInput;
+        Sample y1 = previousOutput;
+        for (int i = 0; i < numSamples; i++) {
+            Sample x = input[i];
+            y1 = x - x1 + pole * y1 + denormalDc;
+            x1 = x;
+            output[i] = y1;
+        }
+        previousInput = x1;
+        previousOutput = y1;
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    Sample process(Sample x) {
+        processBlock(&x, &x, 1);
+        return x;
+    }
+
+    void reset() {
+        previousInput = Sample();
+        previousOutput = Sample();
+    }
+};
+
+/**
+ * Parallel one-poles, one per lane, over planar blocks (input[lane][i])
+ * Lanes share nothing but the loop: on float with 4 lanes each step runs
+ * all four in one vector, with blocks transposed 4 samples at a time.
+ */
+template <typename Sample, int Lanes, bool DenormalDc = false>
+class OnePoleLanesT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    Sample coefficient[Lanes];
+    Sample keep[Lanes];
+    Sample state[Lanes];
+
+public:
+    OnePoleLanesT() {
+        for (int l = 0; l < Lanes; l++) {
+            coefficient[l] = Traits::fromFloat(1.0f);
+            keep[l] = state[l] = Sample();
+        }
+    }
+
+    void setPole(int lane, float pole) {
+        coefficient[lane] = Traits::fromFloat(1.0f - pole);
+        keep[lane] = Traits::fromFloat(pole);
+    }
+
+    void processBlock(const Sample* const* input, Sample* const* output, int numSamples) {
+        const Sample denormalDc = Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        for (int l = 0; l < Lanes; l++) {
+            Sample z = state[l];
+            for (int i = 0; i < numSamples; i++) {
+                z = DenormalDc ? coefficient[l] * input[l][i] + keep[l] * z + denormalDc
+                               : coefficient[l] * input[l][i] + keep[l] * z;
+                output[l][i] = z;
+            }
+            state[l] = z;
+        }
+    }
+
+    void reset() {
+        for (int l = 0; l < Lanes; l++) state[l] = Sample();
+    }
+};
+
+template <bool DenormalDc>
+class OnePoleLanesT<float, 4, DenormalDc> {
+private:
+    float coefficient[4];
+    float keep[4];
+    float state[4];
+
+public:
+    OnePoleLanesT() {
+        for (int l = 0; l < 4; l++) {
+            coefficient[l] = 1.0f;
+            keep[l] = state[l] = 0.0f;
+        }
+    }
+
+    void setPole(int lane, float pole) {
+        coefficient[lane] = 1.0f - pole;
+        keep[lane] = pole;
+    }
+
+    void processBlock(const float* const* input, float* const* output, int numSamples) {
+        typedef HothouseFloat4 V;
+        const V c = V::load(coefficient);
+        const V k = V::load(keep);
+        const V dc = V::set1(HOTHOUSE_DENORMAL_DC);
+        V z = V::load(state);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            V s[4] = {V::load(input[0] + i), V::load(input[1] + i), V::load(input[2] + i),
+                      V::load(input[3] + i)};
+            V::transpose(s[0], s[1], s[2], s[3]);
+            for (int j = 0; j < 4; j++) {
+                z = DenormalDc ? c * s[j] + k * z + dc : c * s[j] + k * z;
+                s[j] = z;
+            }
+            V::transpose(s[0], s[1], s[2], s[3]);
+            for (int l = 0; l < 4; l++) s[l].store(output[l] + i);
+        }
+        for (; i < numSamples; i++) {
+            V x = V::lanes(input[0][i], input[1][i], input[2][i], input[3][i]);
+            z = DenormalDc ? c * x + k * z + dc : c * x + k * z;
+            float y[4];
+            z.store(y);
+            for (int l = 0; l < 4; l++) output[l][i] = y[l];
+        }
+        z.store(state);
+    }
+
+    void reset() {
+        for (int l = 0; l < 4; l++) state[l] = 0.0f;
+    }
+};
+
+// RBJ cookbook responses
+enum BiquadType {
+    BIQUAD_LOWPASS,
+    BIQUAD_HIGHPASS,
+    BIQUAD_BANDPASS,   // 0 dB peak
+    BIQUAD_NOTCH,
+    BIQUAD_PEAK,
+    BIQUAD_LOW_SHELF,
+    BIQUAD_HIGH_SHELF,
+    BIQUAD_ALLPASS
+};
+
+/**
+ * Normalized biquad coefficients (a0 = 1), from the RBJ Audio EQ Cookbook
+ * gainDb applies to PEAK and the shelves; shelves take q as their slope
+ * parameter (0.707 is the steepest without overshoot).
+ */
+struct BiquadCoefficients {
+    float b0, b1, b2, a1, a2;
+
+    static BiquadCoefficients design(BiquadType type, float hz, float sampleRate, float q,
+                                     float gainDb = 0.0f) {
+        double w0 = 6.283185307179586 * hz / sampleRate;
+        double cosW = cos(w0);
+        double alpha = sin(w0) / (2.0 * q);
+        double A = pow(10.0, gainDb / 40.0);
+        double b0, b1, b2, a0, a1, a2;
+        switch (type) {
+            case BIQUAD_HIGHPASS:
+                b0 = (1.0 + cosW) / 2.0; b1 = -(1.0 + cosW); b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+            case BIQUAD_BANDPASS:
+                b0 = alpha; b1 = 0.0; b2 = -alpha;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+            case BIQUAD_NOTCH:
+                b0 = 1.0; b1 = -2.0 * cosW; b2 = 1.0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+            case BIQUAD_PEAK:
+                b0 = 1.0 + alpha * A; b1 = -2.0 * cosW; b2 = 1.0 - alpha * A;
+                a0 = 1.0 + alpha / A; a1 = -2.0 * cosW; a2 = 1.0 - alpha / A;
+                break;
+            case BIQUAD_LOW_SHELF:
+            case BIQUAD_HIGH_SHELF: {
+                double s = type == BIQUAD_LOW_SHELF ? 1.0 : -1.0;
+                double root = 2.0 * sqrt(A) * alpha;
+                b0 = A * ((A + 1.0) - s * (A - 1.0) * cosW + root);
+                b1 = s * 2.0 * A * ((A - 1.0) - s * (A + 1.0) * cosW);
+                b2 = A * ((A + 1.0) - s * (A - 1.0) * cosW - root);
+                a0 = (A + 1.0) + s * (A - 1.0) * cosW + root;
+                a1 = -s * 2.0 * ((A - 1.0) + s * (A + 1.0) * cosW);
+                a2 = (A + 1.0) + s * (A - 1.0) * cosW - root;
+                break;
+            }
+            case BIQUAD_ALLPASS:
+                b0 = 1.0 - alpha; b1 = -2.0 * cosW; b2 = 1.0 + alpha;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+            default:  // BIQUAD_LOWPASS
+                b0 = (1.0 - cosW) / 2.0; b1 = 1.0 - cosW; b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+        }
+        BiquadCoefficients c = {(float)(b0 / a0), (float)(b1 / a0), (float)(b2 / a0),
+                                (float)(a1 / a0), (float)(a2 / a0)};
+        return c;
+    }
+};
+
+/**
+ * Biquad, transposed direct form II
+ * setResponse() redesigns only when one of its arguments changed.
+ */
+template <typename Sample>
+class BiquadT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    BiquadCoefficients c;
+    float s1;
+    float s2;
+    BiquadType type;
+    float hz;
+    float sampleRate;
+    float q;
+    float gainDb;
+
+public:
+    BiquadT() : s1(0.0f), s2(0.0f), type(BIQUAD_ALLPASS), hz(0.0f), sampleRate(0.0f), q(0.0f), gainDb(0.0f) {
+        BiquadCoefficients identity = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        c = identity;
+    }
+
+    void setResponse(BiquadType t, float cutoff, float rate, float quality, float gain = 0.0f) {
+        if (t == type && cutoff == hz && rate == sampleRate && quality == q && gain == gainDb) return;
+        type = t;
+        hz = cutoff;
+        sampleRate = rate;
+        q = quality;
+        gainDb = gain;
+        c = BiquadCoefficients::design(t, cutoff, rate, quality, gain);
+    }
+
+    void setCoefficients(const BiquadCoefficients& coefficients) {
+        c = coefficients;
+        sampleRate = 0.0f;  // Next setResponse() redesigns
+    }
+
+    const BiquadCoefficients& getCoefficients() const { return c; }
+
+    Sample process(Sample input) {
+        float x = Traits::toFloat(input);
+        float y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        return Traits::fromFloat(y);
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        float z1 = s1;
+        float z2 = s2;
+        for (int i = 0; i < numSamples; i++) {
+            float x = Traits::toFloat(input[i]);
+            float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            output[i] = Traits::fromFloat(y);
+        }
+        s1 = z1 + HOTHOUSE_DENORMAL_DC;
+        s2 = z2;
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    void reset() { s1 = s2 = 0.0f; }
+};
+
+// Stages biquads in series, each run over the whole block in turn
+template <typename Sample, int Stages>
+class BiquadCascadeT {
+private:
+    BiquadT<Sample> stages[Stages];
+
+public:
+    BiquadT<Sample>& stage(int index) { return stages[index]; }
+
+    // The same response on every stage (e.g. 2 Butterworth stages for LR4)
+    void setResponse(BiquadType type, float hz, float sampleRate, float q, float gainDb = 0.0f) {
+        for (int s = 0; s < Stages; s++) stages[s].setResponse(type, hz, sampleRate, q, gainDb);
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        stages[0].processBlock(input, output, numSamples);
+        for (int s = 1; s < Stages; s++) stages[s].processBlock(output, output, numSamples);
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    void reset() {
+        for (int s = 0; s < Stages; s++) stages[s].reset();
+    }
+};
+
+/**
+ * Four biquad cascades side by side, one per SIMD lane: multiband
+ * splits, filter banks, or four channels
+ * Planar float blocks (input[lane][i]); point several lanes at one input
+ * to split it. Each setResponse() redesigns only on change.
+ */
+template <int Stages>
+class MultibandBiquad {
+private:
+    typedef HothouseFloat4 V;
+
+    BiquadT<float> designs[4][Stages];  // Coefficient cache per lane and stage
+    float b0[Stages][4], b1[Stages][4], b2[Stages][4], a1[Stages][4], a2[Stages][4];
+    float s1[Stages][4], s2[Stages][4];
+
+    struct StageVectors {
+        V b0, b1, b2, a1, a2, s1, s2;
+    };
+
+public:
+    enum { LANES = 4 };
+
+    MultibandBiquad() {
+        for (int lane = 0; lane < 4; lane++) {
+            for (int s = 0; s < Stages; s++) setCoefficients(lane, s, designs[lane][s].getCoefficients());
+        }
+        reset();
+    }
+
+    void setResponse(int lane, int stage, BiquadType type, float hz, float sampleRate, float q,
+                     float gainDb = 0.0f) {
+        designs[lane][stage].setResponse(type, hz, sampleRate, q, gainDb);
+        setCoefficients(lane, stage, designs[lane][stage].getCoefficients());
+    }
+
+    void setCoefficients(int lane, int stage, const BiquadCoefficients& c) {
+        b0[stage][lane] = c.b0;
+        b1[stage][lane] = c.b1;
+        b2[stage][lane] = c.b2;
+        a1[stage][lane] = c.a1;
+        a2[stage][lane] = c.a2;
+    }
+
+    void processBlock(const float* const* input, float* const* output, int numSamples) {
+        StageVectors v[Stages];
+        for (int s = 0; s < Stages; s++) {
+            v[s].b0 = V::load(b0[s]);
+            v[s].b1 = V::load(b1[s]);
+            v[s].b2 = V::load(b2[s]);
+            v[s].a1 = V::load(a1[s]);
+            v[s].a2 = V::load(a2[s]);
+            v[s].s1 = V::load(s1[s]);
+            v[s].s2 = V::load(s2[s]);
+        }
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            V x[4] = {V::load(input[0] + i), V::load(input[1] + i), V::load(input[2] + i),
+                      V::load(input[3] + i)};
+            V::transpose(x[0], x[1], x[2], x[3]);
+            for (int j = 0; j < 4; j++) x[j] = step(v, x[j]);
+            V::transpose(x[0], x[1], x[2], x[3]);
+            for (int lane = 0; lane < 4; lane++) x[lane].store(output[lane] + i);
+        }
+        for (; i < numSamples; i++) {
+            float y[4];
+            step(v, V::lanes(input[0][i], input[1][i], input[2][i], input[3][i])).store(y);
+            for (int lane = 0; lane < 4; lane++) output[lane][i] = y[lane];
+        }
+        const V dc = V::set1(HOTHOUSE_DENORMAL_DC);
+        for (int s = 0; s < Stages; s++) {
+            (v[s].s1 + dc).store(s1[s]);
+            v[s].s2.store(s2[s]);
+        }
+    }
+
+    void reset() {
+        for (int s = 0; s < Stages; s++) {
+            for (int lane = 0; lane < 4; lane++) s1[s][lane] = s2[s][lane] = 0.0f;
+        }
+    }
+
+private:
+    static V step(StageVectors* v, V x) {
+        for (int s = 0; s < Stages; s++) {
+            V y = v[s].b0 * x + v[s].s1;
+            v[s].s1 = v[s].b1 * x - v[s].a1 * y + v[s].s2;
+            v[s].s2 = v[s].b2 * x - v[s].a2 * y;
+            x = y;
+        }
+        return x;
+    }
+};
+
+enum SvfMode {
+    SVF_LOWPASS,
+    SVF_BANDPASS,
+    SVF_HIGHPASS,
+    SVF_NOTCH,
+    SVF_PEAK,
+    SVF_ALLPASS
+};
+
+/**
+ * Topology-preserving (trapezoidal) state-variable filter
+ * Stays stable and keeps its state meaningful under fast cutoff
+ * modulation, where a biquad would glitch. setResponse() redesigns
+ * (one tanf) only on change.
+ */
+template <typename Sample>
+class SvfT {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    float a1, a2, a3;  // Integrator gains
+    float m0, m1, m2;  // Output mix of input, band and low
+    float ic1, ic2;    // Integrator states
+    SvfMode mode;
+    float hz;
+    float sampleRate;
+    float q;
+
+public:
+    SvfT() : ic1(0.0f), ic2(0.0f), mode(SVF_LOWPASS), hz(0.0f), sampleRate(0.0f), q(0.0f) {
+        setResponse(SVF_LOWPASS, 1000.0f, 48000.0f, 0.707f);
+    }
+
+    void setResponse(SvfMode m, float cutoff, float rate, float quality) {
+        if (m == mode && cutoff == hz && rate == sampleRate && quality == q) return;
+        mode = m;
+        hz = cutoff;
+        sampleRate = rate;
+        q = quality;
+        float g = tanf(3.14159265359f * cutoff / rate);
+        float k = 1.0f / quality;
+        a1 = 1.0f / (1.0f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+        m0 = 1.0f;
+        switch (m) {
+            case SVF_BANDPASS: m0 = 0.0f; m1 = 1.0f; m2 = 0.0f; break;
+            case SVF_HIGHPASS: m1 = -k; m2 = -1.0f; break;
+            case SVF_NOTCH: m1 = -k; m2 = 0.0f; break;
+            case SVF_PEAK: m1 = -k; m2 = -2.0f; break;
+            case SVF_ALLPASS: m1 = -2.0f * k; m2 = 0.0f; break;
+            default: m0 = 0.0f; m1 = 0.0f; m2 = 1.0f; break;  // SVF_LOWPASS
+        }
+    }
+
+    void processBlock(const Sample* input, Sample* output, int numSamples) {
+        float z1 = ic1;
+        float z2 = ic2;
+        for (int i = 0; i < numSamples; i++) {
+            float x = Traits::toFloat(input[i]);
+            float v3 = x - z2;
+            float v1 = a1 * z1 + a2 * v3;
+            float v2 = z2 + a2 * z1 + a3 * v3;
+            z1 = 2.0f * v1 - z1;
+            z2 = 2.0f * v2 - z2;
+            output[i] = Traits::fromFloat(m0 * x + m1 * v1 + m2 * v2);
+        }
+        ic1 = z1 + HOTHOUSE_DENORMAL_DC;
+        ic2 = z2;
+    }
+
+    void processBlock(Sample* samples, int numSamples) {
+        if (numSamples <= 0) return;
+        processBlock(samples, samples, numSamples);
+    }
+
+    Sample process(Sample x) {
+        processBlock(&x, &x, 1);
+        return x;
+    }
+
+    void reset() { ic1 = ic2 = 0.0f; }
+};
+
+/**
+ * Toggle switch position enum (ON-OFF-ON switches)
+ * Matches the official Hothouse API
+ */
+enum ToggleswitchPosition {
+    TOGGLESWITCH_UP,      // Switch pushed up (position 1)
+    TOGGLESWITCH_MIDDLE,  // Switch in center/OFF position
+    TOGGLESWITCH_DOWN,    // Switch pushed down (position 2)
+    TOGGLESWITCH_UNKNOWN  // For ON-ON switches (no middle position)
+};
+
+/**
+ * Knob identifiers
+ */
+enum Knob {
+    KNOB_1 = 0,
+    KNOB_2,
+    KNOB_3,
+    KNOB_4,
+    KNOB_5,
+    KNOB_6,
+    KNOB_COUNT
+};
+
+/**
+ * Toggle switch identifiers
+ */
+enum Toggleswitch {
+    TOGGLESWITCH_1 = 0,
+    TOGGLESWITCH_2,
+    TOGGLESWITCH_3,
+    TOGGLESWITCH_COUNT
+};
+
+/**
+ * Footswitch identifiers
+ */
+enum Footswitch {
+    FOOTSWITCH_1 = 0,
+    FOOTSWITCH_2,
+    FOOTSWITCH_COUNT
+};
+
+/**
+ * LED identifiers
+ */
+enum Led {
+    LED_1 = 0,
+    LED_2,
+    LED_COUNT
+};
+
+/**
+ * Hardware control inputs from the Hothouse pedal
+ */
+struct HothouseControls {
+    // Potentiometers (0.0 to 1.0)
+    float knobs[KNOB_COUNT];
+
+    // Toggle switches (enum positions)
+    ToggleswitchPosition toggles[TOGGLESWITCH_COUNT];
+
+    // Footswitch rising edge detection (true on press)
+    bool footswitchRisingEdge[FOOTSWITCH_COUNT];
+
+    // Footswitch current state (for level reading if needed)
+    bool footswitchPressed[FOOTSWITCH_COUNT];
+
+    HothouseControls() {
+        for (int i = 0; i < KNOB_COUNT; i++) {
+            knobs[i] = 0.5f;
+        }
+        for (int i = 0; i < TOGGLESWITCH_COUNT; i++) {
+            toggles[i] = TOGGLESWITCH_MIDDLE;
+        }
+        for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+            footswitchRisingEdge[i] = false;
+            footswitchPressed[i] = false;
+        }
+    }
+};
+
+/**
+ * Wait-free single-producer/single-consumer triple buffer
+ * The producer always has a private back slot to write, the consumer a
+ * private front slot to read, and the third slot is exchanged through
+ * one atomic word. Both sides finish in a fixed number of steps; the
+ * consumer sees the most recent complete value and never a torn one.
+ * Intermediate values published between two reads are dropped.
+ */
+template <typename T>
+class TripleBuffer {
+private:
+    enum { INDEX_MASK = 3, FRESH = 4 };
+
+    T slots[3];
+    std::atomic<unsigned int> middle;  // Shared slot index | FRESH
+    unsigned int back;                 // Producer-owned slot
+    unsigned int front;                // Consumer-owned slot
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // Producer: slot to fill before calling publish()
+    T& writeBuffer() {
+        return slots[back];
+    }
+
+    // Producer: make the filled slot the latest value
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * Consumer: take the latest value if one arrived since the last call
+     * @return true if readBuffer() now holds a new value
+     */
+    bool consume() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer: latest consumed value (owned by the consumer until next consume())
+    T& readBuffer() {
+        return slots[front];
+    }
+};
+
+#define HOTHOUSE_CACHE_LINE 64  // Keeps the producer's and consumer's indices apart
+
+/**
+ * Wait-free single-producer/single-consumer ring of fixed-size records
+ * Storage is inline (Capacity a power of two), so the ring never
+ * allocates. The producer owns head, the consumer tail, each on its own
+ * cache line; indices run freely and wrap by mask. push() and pop() finish
+ * in a fixed number of steps. When the consumer falls behind and the
+ * ring fills, push() drops the new record and counts it, so the producer
+ * never waits and nothing it reads is ever overwritten under it.
+ */
+template <typename T, int Capacity>
+class SpscRing {
+private:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+    alignas(HOTHOUSE_CACHE_LINE) std::atomic<uint32_t> head;  // Next slot to write
+    alignas(HOTHOUSE_CACHE_LINE) std::atomic<uint32_t> tail;  // Next slot to read
+    alignas(HOTHOUSE_CACHE_LINE) std::atomic<uint32_t> dropped;  // Written by the producer only
+    T slots[Capacity];
+
+public:
+    SpscRing() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * Producer: append a record
+     * @return false if the ring was full and the record was dropped
+     */
+    bool push(const T& record) {
+        uint32_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) >= (uint32_t)Capacity) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[position & (Capacity - 1)] = record;
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: take the oldest record
+     * @return false if the ring was empty
+     */
+    bool pop(T& record) {
+        uint32_t position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = slots[position & (Capacity - 1)];
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Records waiting; exact on the consumer side, a lower bound elsewhere
+    int size() const {
+        return (int)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+    }
+
+    // Records dropped because the ring was full, since construction
+    uint32_t getDropped() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Control snapshot handoff from the main loop to the audio callback
+ * The main loop reads the hardware and publish()es; the audio callback
+ * calls consume(), which costs one atomic load and, when a new snapshot
+ * is waiting, one atomic exchange. Footswitch presses travel as counters,
+ * so a rising edge is reported exactly once even if the snapshot that
+ * first carried it was overwritten before the audio side read it.
+ */
+class HothouseControlMailbox {
+private:
+    struct Snapshot {
+        HothouseControls controls;
+        unsigned int pressCount[FOOTSWITCH_COUNT];
+    };
+
+    TripleBuffer<Snapshot> buffer;
+
+    unsigned int publishedPresses[FOOTSWITCH_COUNT];  // Main loop side
+    unsigned int consumedPresses[FOOTSWITCH_COUNT];   // Audio side
+
+public:
+    HothouseControlMailbox() {
+        for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+            publishedPresses[i] = 0;
+            consumedPresses[i] = 0;
+        }
+    }
+
+    /**
+     * Main loop: publish freshly read controls
+     * footswitchRisingEdge is accumulated into press counters
+     */
+    void publish(const HothouseControls& controls) {
+        Snapshot& snapshot = buffer.writeBuffer();
+        snapshot.controls = controls;
+        for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+            if (controls.footswitchRisingEdge[i]) publishedPresses[i]++;
+            snapshot.pressCount[i] = publishedPresses[i];
+        }
+        buffer.publish();
+    }
+
+    /**
+     * Audio callback: fetch the latest controls, if any arrived
+     * @param controls Set to the snapshot (valid until the next consume())
+     * @return true if a new snapshot is available
+     */
+    bool consume(const HothouseControls*& controls) {
+        if (!buffer.consume()) {
+            return false;
+        }
+        Snapshot& snapshot = buffer.readBuffer();
+        for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
+            snapshot.controls.footswitchRisingEdge[i] = snapshot.pressCount[i] != consumedPresses[i];
+            consumedPresses[i] = snapshot.pressCount[i];
+        }
+        controls = &snapshot.controls;
+        return true;
+    }
+};
+
+/**
+ * Linear per-block parameter ramp
+ * Sample i of the block uses start + increment * (i + 1), so the ramp
+ * lands exactly on the block's end value
+ */
+struct ParameterRamp {
+    float start;
+    float increment;
+
+    static ParameterRamp constant(float value) {
+        ParameterRamp ramp;
+        ramp.start = value;
+        ramp.increment = 0.0f;
+        return ramp;
+    }
+
+    static ParameterRamp between(float from, float to, int numSamples) {
+        ParameterRamp ramp;
+        ramp.start = from;
+        ramp.increment = numSamples > 0 ? (to - from) / (float)numSamples : 0.0f;
+        return ramp;
+    }
+};
+
+// Relative distance from target at which a smoother snaps and settles
+#define SMOOTHER_SETTLE_EPSILON 1e-5f
+
+/**
+ * Parameter smoother to prevent zipper noise when knobs are turned
+ * Uses one-pole lowpass filter for smooth parameter transitions
+ *
+ * Once the value converges it snaps to the target and reports
+ * isSettled(); a settled smoother costs a single branch per call, and
+ * effects can skip recomputing coefficients derived from it.
+ */
+class ParameterSmoother {
+private:
+    float currentValue;
+    float targetValue;
+    float coefficient;
+    bool settled;
+
+    // coefficient^blockSize, cached for processBlock()
+    float blockCoefficient;
+    int blockSize;
+
+    // Snap to the target once converged (or no longer moving in float)
+    void settleIfConverged(float previous) {
+        float threshold = SMOOTHER_SETTLE_EPSILON * (1.0f + fabsf(targetValue));
+        if (currentValue == previous || fabsf(targetValue - currentValue) <= threshold) {
+            currentValue = targetValue;
+            settled = true;
+        }
+    }
+
+public:
+    /**
+     * @param smoothingMs Smoothing time in milliseconds
+     * @param sampleRate Audio sample rate
+     * @param initialValue Starting value
+     */
+    ParameterSmoother(float smoothingMs = 20.0f, float sampleRate = 48000.0f, float initialValue = 0.5f) {
+        currentValue = initialValue;
+        targetValue = initialValue;
+        settled = true;
+        setSmoothing(smoothingMs, sampleRate);
+    }
+
+    void setSmoothing(float smoothingMs, float sampleRate) {
+        float samples = (smoothingMs / 1000.0f) * sampleRate;
+        if (samples < 1.0f) samples = 1.0f;
+        coefficient = 1.0f - (1.0f / samples);
+        blockCoefficient = coefficient;
+        blockSize = 1;
+    }
+
+    void setTarget(float value) {
+        if (value != targetValue) {
+            targetValue = value;
+            settled = (value == currentValue);
+        }
+    }
+
+    void setImmediate(float value) {
+        currentValue = value;
+        targetValue = value;
+        settled = true;
+    }
+
+    float process() {
+        if (settled) return currentValue;
+        float previous = currentValue;
+        currentValue = currentValue * coefficient + targetValue * (1.0f - coefficient);
+        settleIfConverged(previous);
+        return currentValue;
+    }
+
+    /**
+     * Advance the smoother over a whole block in one step
+     * Equivalent to calling process() numSamples times
+     * @param numSamples Number of samples in the block
+     * @return Smoothed value at the end of the block
+     */
+    float processBlock(int numSamples) {
+        if (settled) return currentValue;
+        if (numSamples != blockSize) {
+            blockSize = numSamples;
+            blockCoefficient = powf(coefficient, (float)numSamples);
+        }
+        float previous = currentValue;
+        currentValue = targetValue + (currentValue - targetValue) * blockCoefficient;
+        settleIfConverged(previous);
+        return currentValue;
+    }
+
+    /**
+     * Block mode: advance over the block and return a linear ramp from the
+     * previous value to the new one, instead of a per-sample exponential
+     * @param numSamples Number of samples in the block
+     */
+    ParameterRamp rampBlock(int numSamples) {
+        float from = currentValue;
+        return ParameterRamp::between(from, processBlock(numSamples), numSamples);
+    }
+
+    /**
+     * True when the value has reached its target and will not change until
+     * the next setTarget()
+     */
+    bool isSettled() const {
+        return settled;
+    }
+
+    float getValue() const {
+        return currentValue;
+    }
+
+    float getTarget() const {
+        return targetValue;
+    }
+};
+
+/**
+ * Bank of N parameter smoothers sharing one smoothing time
+ * Values are stored structure-of-arrays, padded to a multiple of four
+ * lanes, so one SSE/NEON operation advances four smoothers at once
+ * (scalar loop on targets without either, e.g. Cortex-M7). Effects
+ * address parameters by index:
+ *
+ *   enum Param { PARAM_GAIN, PARAM_MIX, PARAM_COUNT };
+ *   ParameterSmootherBank<PARAM_COUNT> params;
+ *   params.processBlock(n);
+ *   float gain = params.get(PARAM_GAIN);
+ *
+ * Same settling behaviour as ParameterSmoother: lanes snap to their
+ * target once converged, and a fully settled bank returns immediately.
+ */
+template <int N>
+class ParameterSmootherBank {
+private:
+    enum { LANES = (N + 3) & ~3 };
+
+    alignas(16) float current[LANES];
+    alignas(16) float target[LANES];
+    float coefficient;
+    bool settled;
+
+    // coefficient^blockSize, cached for processBlock()
+    float blockCoefficient;
+    int blockSize;
+
+    // current = target + (current - target) * k, snapping converged lanes
+    void advance(float k) {
+        bool allSettled = true;
+#if defined(HOTHOUSE_SIMD_SSE)
+        const __m128 vk = _mm_set1_ps(k);
+        const __m128 eps = _mm_set1_ps(SMOOTHER_SETTLE_EPSILON);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        for (int i = 0; i < LANES; i += 4) {
+            __m128 c = _mm_load_ps(current + i);
+            __m128 t = _mm_load_ps(target + i);
+            __m128 next = _mm_add_ps(t, _mm_mul_ps(_mm_sub_ps(c, t), vk));
+            __m128 threshold = _mm_mul_ps(eps, _mm_add_ps(one, _mm_andnot_ps(signBit, t)));
+            __m128 distance = _mm_andnot_ps(signBit, _mm_sub_ps(t, next));
+            __m128 snap = _mm_or_ps(_mm_cmple_ps(distance, threshold), _mm_cmpeq_ps(next, c));
+            next = _mm_or_ps(_mm_and_ps(snap, t), _mm_andnot_ps(snap, next));
+            _mm_store_ps(current + i, next);
+            allSettled = allSettled && _mm_movemask_ps(snap) == 0xF;
+        }
+#elif defined(HOTHOUSE_SIMD_NEON)
+        const float32x4_t vk = vdupq_n_f32(k);
+        const float32x4_t eps = vdupq_n_f32(SMOOTHER_SETTLE_EPSILON);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        for (int i = 0; i < LANES; i += 4) {
+            float32x4_t c = vld1q_f32(current + i);
+            float32x4_t t = vld1q_f32(target + i);
+            float32x4_t next = vmlaq_f32(t, vsubq_f32(c, t), vk);
+            float32x4_t threshold = vmulq_f32(eps, vaddq_f32(one, vabsq_f32(t)));
+            uint32x4_t snap = vorrq_u32(vcleq_f32(vabsq_f32(vsubq_f32(t, next)), threshold),
+                                        vceqq_f32(next, c));
+            vst1q_f32(current + i, vbslq_f32(snap, t, next));
+            uint32x2_t half = vand_u32(vget_low_u32(snap), vget_high_u32(snap));
+            allSettled = allSettled && (vget_lane_u32(half, 0) & vget_lane_u32(half, 1)) != 0;
+        }
+#else
+        for (int i = 0; i < LANES; i++) {
+            float c = current[i];
+            float t = target[i];
+            float next = t + (c - t) * k;
+            if (next == c || fabsf(t - next) <= SMOOTHER_SETTLE_EPSILON * (1.0f + fabsf(t))) {
+                next = t;
+            } else {
+                allSettled = false;
+            }
+            current[i] = next;
+        }
+#endif
+        settled = allSettled;
+    }
+
+public:
+    /**
+     * @param smoothingMs Smoothing time in milliseconds (all lanes)
+     * @param sampleRate Audio sample rate
+     */
+    ParameterSmootherBank(float smoothingMs = 20.0f, float sampleRate = 48000.0f) {
+        for (int i = 0; i < LANES; i++) {
+            current[i] = 0.0f;
+            target[i] = 0.0f;
+        }
+        settled = true;
+        setSmoothing(smoothingMs, sampleRate);
+    }
+
+    void setSmoothing(float smoothingMs, float sampleRate) {
+        float samples = (smoothingMs / 1000.0f) * sampleRate;
+        if (samples < 1.0f) samples = 1.0f;
+        coefficient = 1.0f - (1.0f / samples);
+        blockCoefficient = coefficient;
+        blockSize = 1;
+    }
+
+    void setTarget(int index, float value) {
+        if (value != target[index]) {
+            target[index] = value;
+            if (value != current[index]) settled = false;
+        }
+    }
+
+    void setImmediate(int index, float value) {
+        current[index] = value;
+        target[index] = value;
+    }
+
+    // Advance every lane by one sample
+    void process() {
+        if (!settled) advance(coefficient);
+    }
+
+    /**
+     * Advance every lane over a whole block in one step
+     * Equivalent to calling process() numSamples times
+     */
+    void processBlock(int numSamples) {
+        if (settled) return;
+        if (numSamples != blockSize) {
+            blockSize = numSamples;
+            blockCoefficient = powf(coefficient, (float)numSamples);
+        }
+        advance(blockCoefficient);
+    }
+
+    float get(int index) const {
+        return current[index];
+    }
+
+    float getTarget(int index) const {
+        return target[index];
+    }
+
+    // True when every lane has reached its target
+    bool isSettled() const {
+        return settled;
+    }
+
+    bool isSettled(int index) const {
+        return current[index] == target[index];
+    }
+};
+
+/**
+ * CPU load metering
+ * A HothouseCycleCounter is a free-running tick source: a function that
+ * returns the low 32 bits of the count, and the count's rate. Block
+ * timings are differences of two reads, so they stay correct across
+ * wrap-around as long as one block takes fewer than 2^32 ticks (8.9 s at
+ * 480 MHz). Built-in sources:
+ *   - clock(): clock_gettime(CLOCK_MONOTONIC) in ns, on POSIX hosts
+ *   - tsc():   the x86 time-stamp counter, rate calibrated against clock()
+ *   - dwt():   the Cortex-M DWT cycle counter, enabled on creation
+ * Any other timer plugs in as HothouseCycleCounter(read, ticksPerSecond).
+ */
+typedef uint32_t (*HothouseTickReader)();
+
+struct HothouseCycleCounter {
+    HothouseTickReader read;  // nullptr disables metering
+    double ticksPerSecond;
+
+    HothouseCycleCounter() : read(nullptr), ticksPerSecond(0.0) {}
+    HothouseCycleCounter(HothouseTickReader reader, double rate) : read(reader), ticksPerSecond(rate) {}
+
+#if defined(HOTHOUSE_COUNTER_CLOCK)
+    static uint32_t readClock() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint32_t)((uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec);
+    }
+
+    static HothouseCycleCounter clock() {
+        return HothouseCycleCounter(readClock, 1.0e9);
+    }
+#endif
+
+#if defined(HOTHOUSE_COUNTER_TSC)
+    static uint32_t readTsc() {
+        return (uint32_t)__rdtsc();
+    }
+
+    // Spins for about 20 ms to measure the TSC rate; call during setup
+    static HothouseCycleCounter tsc() {
+        uint32_t clockStart = readClock();
+        uint32_t tscStart = readTsc();
+        uint32_t clockElapsed;
+        do {
+            clockElapsed = readClock() - clockStart;
+        } while (clockElapsed < 20000000u);
+        uint32_t tscElapsed = readTsc() - tscStart;
+        return HothouseCycleCounter(readTsc, 1.0e9 * tscElapsed / clockElapsed);
+    }
+#endif
+
+#if defined(HOTHOUSE_COUNTER_DWT)
+    static uint32_t readDwt() {
+        return *(volatile uint32_t*)0xE0001004;  // DWT_CYCCNT
+    }
+
+    // @param coreClockHz CPU clock (Daisy Seed: 480 MHz)
+    static HothouseCycleCounter dwt(double coreClockHz) {
+        *(volatile uint32_t*)0xE000EDFC |= 1u << 24;  // DEMCR.TRCENA
+        *(volatile uint32_t*)0xE0001004 = 0;          // DWT_CYCCNT
+        *(volatile uint32_t*)0xE0001000 |= 1u;        // DWT_CTRL.CYCCNTENA
+        return HothouseCycleCounter(readDwt, coreClockHz);
+    }
+#endif
+};
+
+#define HOTHOUSE_LOAD_MAX_STAGES 8  // Stages timed individually (MAX_CHAIN_EFFECTS)
+
+#ifndef HOTHOUSE_LOAD_AVERAGE_MS
+#define HOTHOUSE_LOAD_AVERAGE_MS 100.0f  // Time constant of the rolling average
+#endif
+#ifndef HOTHOUSE_LOAD_PUBLISH_MS
+#define HOTHOUSE_LOAD_PUBLISH_MS 10.0f  // Interval between reports to the main loop
+#endif
+
+/**
+ * Load of one stage or of the whole block, as a fraction of the block's
+ * period (numSamples / sampleRate); 1.0 is the deadline
+ */
+struct HothouseLoadStats {
+    float average;      // Exponential average over HOTHOUSE_LOAD_AVERAGE_MS
+    float peak;         // Highest single block since resetPeaks()
+    uint32_t overruns;  // Blocks over 1.0 since the meter was configured
+
+    HothouseLoadStats() : average(0.0f), peak(0.0f), overruns(0) {}
+};
+
+struct HothouseLoadReport {
+    HothouseLoadStats total;                             // The whole processBuffer() call
+    HothouseLoadStats stages[HOTHOUSE_LOAD_MAX_STAGES];  // Per EffectChain stage, by index
+    int numStages;
+    uint32_t blocks;  // Blocks metered since configure()
+    float meterLoad;  // Average cost of the meter's own counter reads
+
+    HothouseLoadReport() : numStages(0), blocks(0), meterLoad(0.0f) {}
+};
+
+/**
+ * Per-block CPU load meter
+ * The audio side reads the counter at the start of a block, once after
+ * each stage and once at the end, and folds the differences into
+ * average, peak and overrun counts: a few multiply-adds per stage and no
+ * division beyond one per block. Every HOTHOUSE_LOAD_PUBLISH_MS the
+ * statistics are handed to the main loop through a TripleBuffer, so
+ * reading them never blocks the audio thread. The meter reports the cost
+ * of its own reads (meterLoad), from a read cost measured in configure().
+ */
+class HothouseLoadMeter {
+private:
+    HothouseCycleCounter counter;
+    float samplesPerTick;   // Period of one tick in samples
+    float averageRate;      // Average coefficient per sample
+    float readLoad;         // One counter read, in samples
+    int publishSamples;
+    int publishCountdown;
+    int readCount;          // Counter reads this block
+    uint32_t lastTicks;     // Length of the last block
+
+    uint32_t stageTicks[HOTHOUSE_LOAD_MAX_STAGES];
+    HothouseLoadReport state;  // Audio side
+    TripleBuffer<HothouseLoadReport> reports;
+
+    std::atomic<unsigned int> resetRequests;  // Bumped by the main loop
+    unsigned int resetsSeen;                  // Audio side
+
+    static void accumulate(HothouseLoadStats& stats, float load, float alpha) {
+        stats.average += alpha * (load - stats.average);
+        if (load > stats.peak) stats.peak = load;
+        if (load > 1.0f) stats.overruns++;
+    }
+
+public:
+    HothouseLoadMeter() : resetRequests(0), resetsSeen(0) {
+        configure(HothouseCycleCounter(), 48000);
+    }
+
+    /**
+     * Select the tick source and clear the statistics (nullptr read
+     * disables metering). Call during setup, not while audio is running.
+     */
+    void configure(const HothouseCycleCounter& source, int sampleRate) {
+        counter = source;
+        samplesPerTick = 0.0f;
+        readLoad = 0.0f;
+        if (counter.read != nullptr && counter.ticksPerSecond > 0.0) {
+            samplesPerTick = (float)(sampleRate / counter.ticksPerSecond);
+            // Cheapest of several back-to-back reads
+            uint32_t best = 0xFFFFFFFFu;
+            for (int i = 0; i < 64; i++) {
+                uint32_t start = counter.read();
+                uint32_t elapsed = counter.read() - start;
+                if (elapsed < best) best = elapsed;
+            }
+            readLoad = best * samplesPerTick;
+        }
+        averageRate = 1000.0f / (HOTHOUSE_LOAD_AVERAGE_MS * sampleRate);
+        publishSamples = (int)(HOTHOUSE_LOAD_PUBLISH_MS * sampleRate / 1000.0f);
+        if (publishSamples < 1) publishSamples = 1;
+        publishCountdown = publishSamples;
+        readCount = 0;
+        lastTicks = 0;
+        for (int i = 0; i < HOTHOUSE_LOAD_MAX_STAGES; i++) stageTicks[i] = 0;
+        state = HothouseLoadReport();
+        state.numStages = 1;
+    }
+
+    bool isEnabled() const {
+        return counter.read != nullptr;
+    }
+
+    // Stages reported in HothouseLoadReport::stages (at most HOTHOUSE_LOAD_MAX_STAGES)
+    void setStageCount(int count) {
+        state.numStages = count < HOTHOUSE_LOAD_MAX_STAGES ? count : HOTHOUSE_LOAD_MAX_STAGES;
+    }
+
+    /**
+     * Audio side: read the counter, as the mark for the first stage or
+     * the start of the block
+     */
+    uint32_t now() {
+        readCount++;
+        return counter.read();
+    }
+
+    /**
+     * Audio side: charge the ticks since mark to a stage
+     * @return The new mark for the next stage
+     */
+    uint32_t recordStage(int stage, uint32_t mark) {
+        uint32_t time = now();
+        if (stage < HOTHOUSE_LOAD_MAX_STAGES) stageTicks[stage] += time - mark;
+        return time;
+    }
+
+    /**
+     * Audio side: close a block begun with now()
+     * @param start The mark from now() at the start of the block
+     */
+    void endBlock(uint32_t start, int numSamples) {
+        uint32_t elapsed = now() - start;
+        lastTicks = elapsed;
+        if (numSamples <= 0) return;
+        if (resetRequests.load(std::memory_order_relaxed) != resetsSeen) {
+            resetsSeen = resetRequests.load(std::memory_order_relaxed);
+            state.total.peak = 0.0f;
+            for (int i = 0; i < HOTHOUSE_LOAD_MAX_STAGES; i++) state.stages[i].peak = 0.0f;
+        }
+
+        float scale = samplesPerTick / (float)numSamples;
+        float alpha = averageRate * (float)numSamples;
+        if (alpha > 1.0f) alpha = 1.0f;
+        accumulate(state.total, elapsed * scale, alpha);
+        for (int i = 0; i < state.numStages; i++) {
+            accumulate(state.stages[i], stageTicks[i] * scale, alpha);
+            stageTicks[i] = 0;
+        }
+        state.meterLoad += alpha * (readCount * readLoad / (float)numSamples - state.meterLoad);
+        state.blocks++;
+        readCount = 0;
+
+        publishCountdown -= numSamples;
+        if (publishCountdown <= 0) {
+            publishCountdown += publishSamples;
+            reports.writeBuffer() = state;
+            reports.publish();
+        }
+    }
+
+    /**
+     * Main loop: the most recent report (at most HOTHOUSE_LOAD_PUBLISH_MS
+     * old), valid until the next call
+     */
+    const HothouseLoadReport& getReport() {
+        reports.consume();
+        return reports.readBuffer();
+    }
+
+    // Main loop: start new peaks from the next block
+    void resetPeaks() {
+        resetRequests.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Audio side: ticks taken by the block closed by the last endBlock()
+    uint32_t getLastTicks() const {
+        return lastTicks;
+    }
+};
+
+#ifndef HOTHOUSE_TELEMETRY_RECORDS
+#define HOTHOUSE_TELEMETRY_RECORDS 256  // Records queued for the main loop (21 ms of 4-sample buffers)
+#endif
+
+/**
+ * Telemetry for one audio block, from HothousePedal::processBuffer() to
+ * the main loop (see HothousePedal::enableTelemetry())
+ */
+struct HothouseTelemetry {
+    uint32_t block;         // Sequence number; gaps mean records were dropped
+    int numSamples;
+    float inputPeak;        // Largest |sample|, 1.0 = full scale
+    float outputPeak;
+    uint32_t clips;         // Samples the effect clamped (Delay feedback, Compressor output)
+    float gainReductionDb;  // Deepest gain reduction of any stage (Compressor), >= 0
+    uint32_t cycles;        // Load meter ticks for the block; 0 with the meter off
+
+    HothouseTelemetry()
+        : block(0), numSamples(0), inputPeak(0.0f), outputPeak(0.0f), clips(0),
+          gainReductionDb(0.0f), cycles(0) {}
+};
+
+// Largest |sample| in a block
+inline float hothouseBlockPeak(const float* samples, int numSamples) {
+    float peak = 0.0f;
+    for (int i = 0; i < numSamples; i++) {
+        float magnitude = fabsf(samples[i]);
+        peak = magnitude > peak ? magnitude : peak;
+    }
+    return peak;
+}
+
+/**
+ * Base class for all effect pedal implementations
+ * All effects must inherit from this class and implement the required methods.
+ * Sample is the audio format the effect processes: float, or Q31 for the
+ * fixed-point path (see SampleTraits). HothouseEffect is the float one.
+ */
+template <typename Sample>
+class HothouseEffectT {
+private:
+    int controlRate;       // Samples between updateControlRate() calls
+    int controlCountdown;  // Samples left before the next call
+
+protected:
+    HothouseMemoryUsage memoryUsage;  // Recorded by the constructor, see getMemoryUsage()
+
+    /**
+     * Control-rate hook: advance smoothers by numSamples and derive the
+     * coefficients the next numSamples of audio will use. Runs once every
+     * getControlRate() samples regardless of the audio buffer size.
+     * @param numSamples Samples until the next call (the control rate)
+     */
+    virtual void updateControlRate(int numSamples) { (void)numSamples; }
+
+    /**
+     * Audio-rate render using the coefficients from updateControlRate()
+     * numSamples never crosses a control-rate boundary. Default calls
+     * process() per sample, so an effect whose process() is implemented
+     * on top of processBlock() must override this.
+     */
+    virtual void renderAudioRate(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) {
+        for (int i = 0; i < numSamples; i++) {
+            outputBuffer[i] = process(inputBuffer[i]);
+        }
+    }
+
+public:
+    typedef Sample SampleType;
+
+    HothouseEffectT() : controlRate(HOTHOUSE_CONTROL_BLOCK), controlCountdown(0) {}
+
+    virtual ~HothouseEffectT() {}
+
+    /**
+     * Process a single audio sample through the effect
+     * @param inputSample Input audio sample (typically -1.0 to 1.0)
+     * @return Processed output sample
+     */
+    virtual Sample process(Sample inputSample) = 0;
+
+    /**
+     * Process a block of audio samples through the effect
+     * Interleaves updateControlRate() every getControlRate() samples with
+     * renderAudioRate() for the samples in between. inputBuffer and
+     * outputBuffer may alias unless canProcessInPlace() returns false.
+     * @param inputBuffer Input samples
+     * @param outputBuffer Output samples
+     * @param numSamples Number of samples in the block
+     */
+    virtual void processBlock(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) {
+        int offset = 0;
+        while (offset < numSamples) {
+            if (controlCountdown <= 0) {
+                updateControlRate(controlRate);
+                controlCountdown = controlRate;
+            }
+            int n = numSamples - offset;
+            if (n > controlCountdown) n = controlCountdown;
+            renderAudioRate(inputBuffer + offset, outputBuffer + offset, n);
+            controlCountdown -= n;
+            offset += n;
+        }
+    }
+
+    /**
+     * Set the number of samples between control-rate updates
+     * @param samples 1 to HOTHOUSE_MAX_CONTROL_BLOCK (e.g. 16 or 32)
+     */
+    virtual void setControlRate(int samples) {
+        if (samples < 1) samples = 1;
+        if (samples > HOTHOUSE_MAX_CONTROL_BLOCK) samples = HOTHOUSE_MAX_CONTROL_BLOCK;
+        controlRate = samples;
+        controlCountdown = 0;
+    }
+
+    int getControlRate() const {
+        return controlRate;
+    }
+
+    /**
+     * Reset the effect state (clear buffers, reset phase, etc.)
+     */
+    virtual void reset() = 0;
+
+    /**
+     * Update effect parameters from hardware controls
+     * Called before processing each audio buffer
+     * @param controls Current state of all hardware controls
+     */
+    virtual void updateFromControls(const HothouseControls& controls) = 0;
+
+    /**
+     * Get the current LED state for visual feedback
+     * Note: LEDs should be updated in the main loop, not audio callback
+     * @return LED brightness (0.0 = off, 1.0 = full brightness)
+     */
+    virtual float getLedState() { return 1.0f; }
+
+    /**
+     * Whether processBlock() accepts the same buffer for input and output
+     * Effects that read ahead in the input must override this to return false
+     */
+    virtual bool canProcessInPlace() const { return true; }
+
+    /**
+     * Hand the effect a load meter to time its own stages (nullptr to stop)
+     * @return true if it does; HothousePedal otherwise times it as one stage
+     */
+    virtual bool setLoadMeter(HothouseLoadMeter* meter) {
+        (void)meter;
+        return false;
+    }
+
+    /**
+     * Add what the effect saw since the last call to a telemetry record
+     * (clips, gain reduction) and restart its counters. Audio thread only.
+     */
+    virtual void collectTelemetry(HothouseTelemetry& record) { (void)record; }
+
+    /**
+     * Arena bytes the effect requests from a region, known at compile
+     * time (see HothouseMemoryFootprint). Effects with buffers hide this.
+     */
+    static constexpr size_t arenaBytes(MemoryRegion) { return 0; }
+
+    /**
+     * Memory the effect actually occupies, as its constructor recorded it
+     * Unlike arenaBytes() this shows FAST requests that spilled into BULK.
+     * Zero for effects that do not record it.
+     */
+    virtual HothouseMemoryUsage getMemoryUsage() const { return memoryUsage; }
 };
 
+typedef HothouseEffectT<float> HothouseEffect;
+
+#define MAX_CHAIN_EFFECTS 8        // Maximum stages in an EffectChain
+#define EFFECT_CHAIN_BLOCK_SIZE 128  // Samples per ping-pong scratch buffer
+
+static_assert(MAX_CHAIN_EFFECTS <= HOTHOUSE_LOAD_MAX_STAGES, "every chain stage needs a load slot");
+
 /**
- * Toggle switch identifiers
+ * Serial chain of effects processed one whole block per stage
+ * Each stage renders the full block before the next one runs, so each
+ * effect's state and code stay hot in cache. In-place stages work directly
+ * on the output buffer; stages that cannot alias ping-pong between two
+ * preallocated scratch buffers. Disabled stages are removed from the
+ * active list, so a bypassed stage costs nothing per block.
+ *
+ * An EffectChain is itself a HothouseEffect and can be passed to
+ * HothousePedal::setEffect(). EffectChainT chains effects of any one
+ * sample type. With a load meter attached it times every stage.
  */
-enum Toggleswitch {
-    TOGGLESWITCH_1 = 0,
-    TOGGLESWITCH_2,
-    TOGGLESWITCH_3,
-    TOGGLESWITCH_COUNT
+template <typename Sample>
+class EffectChainT : public HothouseEffectT<Sample> {
+private:
+    typedef HothouseEffectT<Sample> Effect;
+
+    Effect* effects[MAX_CHAIN_EFFECTS];
+    bool enabled[MAX_CHAIN_EFFECTS];
+    int numEffects;
+
+    // Enabled stages, in order, and their indices in effects[]
+    Effect* activeEffects[MAX_CHAIN_EFFECTS];
+    int activeIndices[MAX_CHAIN_EFFECTS];
+    int numActive;
+
+    HothouseLoadMeter* loadMeter;  // Times each stage when set
+
+    // Ping-pong scratch buffers for stages that cannot process in place
+    Sample scratch[2][EFFECT_CHAIN_BLOCK_SIZE];
+
+    void rebuildActiveList() {
+        numActive = 0;
+        for (int i = 0; i < numEffects; i++) {
+            if (enabled[i]) {
+                activeIndices[numActive] = i;
+                activeEffects[numActive++] = effects[i];
+            }
+        }
+    }
+
+    // Run all active stages over one chunk of at most EFFECT_CHAIN_BLOCK_SIZE
+    void renderChunk(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) {
+        const Sample* src = inputBuffer;
+        uint32_t mark = loadMeter != nullptr ? loadMeter->now() : 0;
+
+        for (int s = 0; s < numActive; s++) {
+            Effect* effect = activeEffects[s];
+            bool last = (s == numActive - 1);
+            bool inPlace = effect->canProcessInPlace();
+            Sample* dst;
+
+            if (src == inputBuffer) {
+                // First stage reads the caller's buffer
+                dst = (inPlace || inputBuffer != outputBuffer) ? outputBuffer : scratch[0];
+            } else if (inPlace) {
+                dst = (Sample*)src;
+            } else if (last && src != outputBuffer) {
+                dst = outputBuffer;
+            } else {
+                dst = (src == scratch[0]) ? scratch[1] : scratch[0];
+            }
+
+            effect->processBlock(src, dst, numSamples);
+            if (loadMeter != nullptr) {
+                mark = loadMeter->recordStage(activeIndices[s], mark);
+            }
+            src = dst;
+        }
+
+        // Only reached with no active stages or a final in-place scratch stage
+        if (src != outputBuffer) {
+            for (int i = 0; i < numSamples; i++) {
+                outputBuffer[i] = src[i];
+            }
+        }
+    }
+
+public:
+    EffectChainT() : numEffects(0), numActive(0), loadMeter(nullptr) {}
+
+    /**
+     * @param chain Array of effects in processing order
+     * @param count Number of effects (at most MAX_CHAIN_EFFECTS)
+     */
+    EffectChainT(Effect** chain, int count) : numEffects(0), numActive(0), loadMeter(nullptr) {
+        for (int i = 0; i < count; i++) {
+            addEffect(chain[i]);
+        }
+    }
+
+    /**
+     * Append an effect to the end of the chain
+     * @return Stage index, or -1 if the chain is full
+     */
+    int addEffect(Effect* effect) {
+        if (effect == nullptr || numEffects >= MAX_CHAIN_EFFECTS) {
+            return -1;
+        }
+        effects[numEffects] = effect;
+        enabled[numEffects] = true;
+        numEffects++;
+        rebuildActiveList();
+        if (loadMeter != nullptr) {
+            loadMeter->setStageCount(numEffects);
+        }
+        return numEffects - 1;
+    }
+
+    /**
+     * Enable or bypass a stage; bypassed stages are skipped entirely
+     */
+    void setEnabled(int index, bool enable) {
+        if (index >= 0 && index < numEffects && enabled[index] != enable) {
+            enabled[index] = enable;
+            rebuildActiveList();
+        }
+    }
+
+    bool isEnabled(int index) const {
+        return index >= 0 && index < numEffects && enabled[index];
+    }
+
+    int getNumEffects() const {
+        return numEffects;
+    }
+
+    Effect* getEffect(int index) const {
+        return (index >= 0 && index < numEffects) ? effects[index] : nullptr;
+    }
+
+    Sample process(Sample inputSample) override {
+        Sample sample = inputSample;
+        for (int s = 0; s < numActive; s++) {
+            sample = activeEffects[s]->process(sample);
+        }
+        return sample;
+    }
+
+    void processBlock(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) override {
+        for (int offset = 0; offset < numSamples; offset += EFFECT_CHAIN_BLOCK_SIZE) {
+            int n = numSamples - offset;
+            if (n > EFFECT_CHAIN_BLOCK_SIZE) n = EFFECT_CHAIN_BLOCK_SIZE;
+            renderChunk(inputBuffer + offset, outputBuffer + offset, n);
+        }
+    }
+
+    void reset() override {
+        for (int i = 0; i < numEffects; i++) {
+            effects[i]->reset();
+        }
+    }
+
+    void setControlRate(int samples) override {
+        Effect::setControlRate(samples);
+        for (int i = 0; i < numEffects; i++) {
+            effects[i]->setControlRate(samples);
+        }
+    }
+
+    void updateFromControls(const HothouseControls& controls) override {
+        for (int i = 0; i < numEffects; i++) {
+            effects[i]->updateFromControls(controls);
+        }
+    }
+
+    float getLedState() override {
+        // Show the last active stage
+        return numActive > 0 ? activeEffects[numActive - 1]->getLedState() : 1.0f;
+    }
+
+    void collectTelemetry(HothouseTelemetry& record) override {
+        for (int i = 0; i < numEffects; i++) {
+            effects[i]->collectTelemetry(record);
+        }
+    }
+
+    // The chain object plus every stage, bypassed ones included
+    HothouseMemoryUsage getMemoryUsage() const override {
+        HothouseMemoryUsage usage(sizeof(*this));
+        for (int i = 0; i < numEffects; i++) {
+            usage.add(effects[i]->getMemoryUsage());
+        }
+        return usage;
+    }
+
+    // Stage i of the load report is effects[i]
+    bool setLoadMeter(HothouseLoadMeter* meter) override {
+        loadMeter = meter;
+        if (loadMeter != nullptr) {
+            loadMeter->setStageCount(numEffects);
+        }
+        return true;
+    }
 };
 
+typedef EffectChainT<float> EffectChain;
+
 /**
- * Footswitch identifiers
+ * An effect as a StaticChain stage
+ * Opens the effect's control-rate and audio-rate hooks to the chain, which
+ * calls them qualified (Stage::renderAudioRate) so they bind statically
+ * and can be inlined into the chain's render.
  */
-enum Footswitch {
-    FOOTSWITCH_1 = 0,
-    FOOTSWITCH_2,
-    FOOTSWITCH_COUNT
+template <typename Effect>
+class StaticChainStage : public Effect {
+public:
+    explicit StaticChainStage(int sampleRate) : Effect(sampleRate) {}
+
+    using Effect::updateControlRate;
+    using Effect::renderAudioRate;
 };
 
 /**
- * LED identifiers
+ * Recursive storage for StaticChain: one effect by value plus the rest
  */
-enum Led {
-    LED_1 = 0,
-    LED_2,
-    LED_COUNT
+template <typename... Effects>
+struct StaticChainNode;
+
+template <>
+struct StaticChainNode<> {
+    typedef float Sample;  // Only used by an empty StaticChain
+
+    StaticChainNode(int) {}
+    void updateControlRate(int) {}
+    template <typename T>
+    void renderAudioRate(const T* inputBuffer, T* outputBuffer, int numSamples) {
+        if (inputBuffer != outputBuffer) {
+            for (int i = 0; i < numSamples; i++) {
+                outputBuffer[i] = inputBuffer[i];
+            }
+        }
+    }
+    template <typename T>
+    void renderInPlace(T*, int) {}
+    void setControlRate(int) {}
+    void reset() {}
+    void updateFromControls(const HothouseControls&) {}
+    void collectTelemetry(HothouseTelemetry&) {}
+    void addMemoryUsage(HothouseMemoryUsage&) const {}
+    float getLedState(float led) { return led; }
 };
 
-/**
- * Hardware control inputs from the Hothouse pedal
- */
-struct HothouseControls {
-    // Potentiometers (0.0 to 1.0)
-    float knobs[KNOB_COUNT];
+template <typename First, typename... Rest>
+struct StaticChainNode<First, Rest...> {
+    typedef First Effect;
+    typedef StaticChainStage<First> Stage;
+    typedef StaticChainNode<Rest...> Next;
+    typedef typename First::SampleType Sample;
 
-    // Toggle switches (enum positions)
-    ToggleswitchPosition toggles[TOGGLESWITCH_COUNT];
+    Stage effect;
+    Next next;
 
-    // Footswitch rising edge detection (true on press)
-    bool footswitchRisingEdge[FOOTSWITCH_COUNT];
+    StaticChainNode(int sampleRate) : effect(sampleRate), next(sampleRate) {}
 
-    // Footswitch current state (for level reading if needed)
-    bool footswitchPressed[FOOTSWITCH_COUNT];
+    void updateControlRate(int numSamples) {
+        effect.Stage::updateControlRate(numSamples);
+        next.updateControlRate(numSamples);
+    }
 
-    HothouseControls() {
-        for (int i = 0; i < KNOB_COUNT; i++) {
-            knobs[i] = 0.5f;
-        }
-        for (int i = 0; i < TOGGLESWITCH_COUNT; i++) {
-            toggles[i] = TOGGLESWITCH_MIDDLE;
-        }
-        for (int i = 0; i < FOOTSWITCH_COUNT; i++) {
-            footswitchRisingEdge[i] = false;
-            footswitchPressed[i] = false;
-        }
+    // First stage writes the output buffer, later stages work in place
+    void renderAudioRate(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) {
+        effect.Stage::renderAudioRate(inputBuffer, outputBuffer, numSamples);
+        next.renderInPlace(outputBuffer, numSamples);
     }
-};
 
-/**
- * Parameter smoother to prevent zipper noise when knobs are turned
- * Uses one-pole lowpass filter for smooth parameter transitions
- */
-class ParameterSmoother {
-private:
-    float currentValue;
-    float targetValue;
-    float coefficient;
+    void renderInPlace(Sample* buffer, int numSamples) {
+        effect.Stage::renderAudioRate(buffer, buffer, numSamples);
+        next.renderInPlace(buffer, numSamples);
+    }
 
-public:
-    /**
-     * @param smoothingMs Smoothing time in milliseconds
-     * @param sampleRate Audio sample rate
-     * @param initialValue Starting value
-     */
-    ParameterSmoother(float smoothingMs = 20.0f, float sampleRate = 48000.0f, float initialValue = 0.5f) {
-        currentValue = initialValue;
-        targetValue = initialValue;
-        setSmoothing(smoothingMs, sampleRate);
+    void setControlRate(int samples) {
+        effect.First::setControlRate(samples);
+        next.setControlRate(samples);
     }
 
-    void setSmoothing(float smoothingMs, float sampleRate) {
-        float samples = (smoothingMs / 1000.0f) * sampleRate;
-        if (samples < 1.0f) samples = 1.0f;
-        coefficient = 1.0f - (1.0f / samples);
+    void reset() {
+        effect.First::reset();
+        next.reset();
     }
 
-    void setTarget(float value) {
-        targetValue = value;
+    void updateFromControls(const HothouseControls& controls) {
+        effect.First::updateFromControls(controls);
+        next.updateFromControls(controls);
     }
 
-    void setImmediate(float value) {
-        currentValue = value;
-        targetValue = value;
+    void collectTelemetry(HothouseTelemetry& record) {
+        effect.First::collectTelemetry(record);
+        next.collectTelemetry(record);
     }
 
-    float process() {
-        currentValue = currentValue * coefficient + targetValue * (1.0f - coefficient);
-        return currentValue;
+    // Arena use only: the objects are inside the chain's own
+    void addMemoryUsage(HothouseMemoryUsage& usage) const {
+        HothouseMemoryUsage own = effect.First::getMemoryUsage();
+        usage.fastBytes += own.fastBytes;
+        usage.bulkBytes += own.bulkBytes;
+        next.addMemoryUsage(usage);
     }
 
-    float getValue() const {
-        return currentValue;
+    // LED of the last stage in the chain
+    float getLedState(float) {
+        return next.getLedState(effect.First::getLedState());
     }
 };
 
+// Compile-time lookup of the Index-th node in a StaticChainNode list
+template <int Index, typename Node>
+struct StaticChainAccess {
+    typedef StaticChainAccess<Index - 1, typename Node::Next> Inner;
+    typedef typename Inner::Type Type;
+    static Type& get(Node& node) { return Inner::get(node.next); }
+};
+
+template <typename Node>
+struct StaticChainAccess<0, Node> {
+    typedef typename Node::Effect Type;
+    static Type& get(Node& node) { return node.effect; }
+};
+
 /**
- * Base class for all effect pedal implementations
- * All effects must inherit from this class and implement the required methods
+ * Effect chain fixed at compile time
+ * Stores each effect by value and calls it without virtual dispatch:
+ *
+ *   StaticChain<Compressor, Overdrive, Delay> rig(48000);
+ *   rig.get<1>().updateFromControls(controls);
+ *   pedal.setEffect(&rig);
+ *
+ * The chain keeps one control-rate schedule for all stages. At each
+ * control boundary it runs every stage's updateControlRate(), then every
+ * stage's renderAudioRate() back to back over the same control block of
+ * the output buffer, so the block stays in L1 between stages. Both are
+ * qualified calls the compiler can inline; nothing is virtual per sample.
+ * Stages must render through those two hooks (an override of
+ * processBlock() itself is bypassed), support in-place processing (all
+ * pedals in pedals/ do) and share one sample type, which the chain takes
+ * from the first. The effects take their buffers from the default arena,
+ * so a chain that could not fit it even with FAST spilling into BULK
+ * fails to compile.
  */
-class HothouseEffect {
+template <typename... Effects>
+class StaticChain : public HothouseEffectT<typename StaticChainNode<Effects...>::Sample> {
+private:
+    typedef StaticChainNode<Effects...> Nodes;
+    typedef typename Nodes::Sample Sample;
+    typedef HothouseEffectT<Sample> Base;
+    typedef HothouseMemoryFootprint<Effects...> Footprint;
+    Nodes nodes;
+
+    static_assert(Footprint::bulkBytes() <= HOTHOUSE_BULK_MEMORY_BYTES &&
+                      Footprint::fastBytes() + Footprint::bulkBytes() <=
+                          (size_t)HOTHOUSE_FAST_MEMORY_BYTES + HOTHOUSE_BULK_MEMORY_BYTES,
+                  "StaticChain effects do not fit in the default arena");
+
+protected:
+    void updateControlRate(int numSamples) override {
+        nodes.updateControlRate(numSamples);
+    }
+
+    void renderAudioRate(const Sample* inputBuffer, Sample* outputBuffer, int numSamples) override {
+        nodes.renderAudioRate(inputBuffer, outputBuffer, numSamples);
+    }
+
 public:
-    virtual ~HothouseEffect() {}
+    StaticChain(int sampleRate = 48000) : nodes(sampleRate) {}
 
-    /**
-     * Process a single audio sample through the effect
-     * @param inputSample Input audio sample (typically -1.0 to 1.0)
-     * @return Processed output sample
-     */
-    virtual float process(float inputSample) = 0;
+    static constexpr size_t arenaBytes(MemoryRegion region) { return Footprint::arenaBytes(region); }
 
-    /**
-     * Reset the effect state (clear buffers, reset phase, etc.)
-     */
-    virtual void reset() = 0;
+    template <int Index>
+    typename StaticChainAccess<Index, Nodes>::Type& get() {
+        return StaticChainAccess<Index, Nodes>::get(nodes);
+    }
 
-    /**
-     * Update effect parameters from hardware controls
-     * Called before processing each audio buffer
-     * @param controls Current state of all hardware controls
-     */
-    virtual void updateFromControls(const HothouseControls& controls) = 0;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        Base::processBlock(&inputSample, &output, 1);
+        return output;
+    }
 
-    /**
-     * Get the current LED state for visual feedback
-     * Note: LEDs should be updated in the main loop, not audio callback
-     * @return LED brightness (0.0 = off, 1.0 = full brightness)
-     */
-    virtual float getLedState() { return 1.0f; }
+    void setControlRate(int samples) override {
+        Base::setControlRate(samples);
+        nodes.setControlRate(samples);
+    }
+
+    void reset() override {
+        nodes.reset();
+    }
+
+    void updateFromControls(const HothouseControls& controls) override {
+        nodes.updateFromControls(controls);
+    }
+
+    void collectTelemetry(HothouseTelemetry& record) override {
+        nodes.collectTelemetry(record);
+    }
+
+    HothouseMemoryUsage getMemoryUsage() const override {
+        HothouseMemoryUsage usage(sizeof(*this));
+        nodes.addMemoryUsage(usage);
+        return usage;
+    }
+
+    float getLedState() override {
+        return nodes.getLedState(1.0f);
+    }
 };
 
 /**
@@ -193,12 +4387,14 @@ struct HothouseConfig {
     int bufferSize;          // Audio buffer size (default: 4 samples for low latency)
     int adcResolution;       // ADC resolution in bits (default: 24)
     int dacResolution;       // DAC resolution in bits (default: 24)
+    int controlRate;         // Samples between effect control-rate updates (default: 32)
 
     HothouseConfig() {
         sampleRate = 48000;
         bufferSize = 4;      // Hothouse uses 4-sample blocks
         adcResolution = 24;
         dacResolution = 24;
+        controlRate = HOTHOUSE_CONTROL_BLOCK;
     }
 };
 
@@ -232,21 +4428,152 @@ struct HothouseLeds {
 /**
  * Cleveland Sound Hothouse Pedal Controller
  * Manages effect processing and hardware interface
+ *
+ * The codec side is always float. HothousePedalT<Q31> runs a fixed-point
+ * effect and converts each buffer once on the way in and once on the way
+ * out; HothousePedal is the float one. enableLoadMeter() times every
+ * buffer for getLoad() (see HothouseLoadMeter), and enableTelemetry()
+ * queues a HothouseTelemetry record per buffer for popTelemetry().
  */
-class HothousePedal {
+template <typename Sample>
+class HothousePedalT {
 private:
-    HothouseEffect* currentEffect;
+    typedef SampleTraits<Sample> Traits;
+
+    HothouseEffectT<Sample>* currentEffect;
     HothouseConfig config;
     HothouseControls controls;
     HothouseLeds leds;
     bool bypassed;
 
+    HothouseLoadMeter loadMeter;
+    bool meterWholeEffect;  // The effect does not time its own stages
+
+    SpscRing<HothouseTelemetry, HOTHOUSE_TELEMETRY_RECORDS> telemetry;
+    bool telemetryEnabled;
+    uint32_t telemetryBlock;
+
+    static void renderEffect(HothouseEffectT<float>* effect, const float* inputBuffer,
+                             float* outputBuffer, int numSamples) {
+        effect->processBlock(inputBuffer, outputBuffer, numSamples);
+    }
+
+    // Convert at the codec boundary, in chunks of the largest control block
+    template <typename T>
+    static void renderEffect(HothouseEffectT<T>* effect, const float* inputBuffer,
+                             float* outputBuffer, int numSamples) {
+        T input[HOTHOUSE_MAX_CONTROL_BLOCK];
+        T output[HOTHOUSE_MAX_CONTROL_BLOCK];
+        for (int offset = 0; offset < numSamples; offset += HOTHOUSE_MAX_CONTROL_BLOCK) {
+            int n = numSamples - offset;
+            if (n > HOTHOUSE_MAX_CONTROL_BLOCK) n = HOTHOUSE_MAX_CONTROL_BLOCK;
+            hothouseConvertBlock(inputBuffer + offset, input, n);
+            effect->processBlock(input, output, n);
+            hothouseConvertBlock(output, outputBuffer + offset, n);
+        }
+    }
+
+    // Hand the meter to the current effect, or time the effect as one stage
+    void attachLoadMeter() {
+        if (currentEffect == nullptr) return;
+        if (!loadMeter.isEnabled()) {
+            currentEffect->setLoadMeter(nullptr);
+            return;
+        }
+        meterWholeEffect = !currentEffect->setLoadMeter(&loadMeter);
+        if (meterWholeEffect) {
+            loadMeter.setStageCount(1);
+        }
+    }
+
+    void render(const float* inputBuffer, float* outputBuffer, int numSamples) {
+        if (bypassed || currentEffect == nullptr) {
+            for (int i = 0; i < numSamples; i++) {
+                outputBuffer[i] = inputBuffer[i];  // Pass through
+            }
+            return;
+        }
+        HothouseDenormalGuard denormalGuard;
+        if (meterWholeEffect && loadMeter.isEnabled()) {
+            uint32_t mark = loadMeter.now();
+            renderEffect(currentEffect, inputBuffer, outputBuffer, numSamples);
+            loadMeter.recordStage(0, mark);
+        } else {
+            renderEffect(currentEffect, inputBuffer, outputBuffer, numSamples);
+        }
+    }
+
 public:
-    HothousePedal(HothouseConfig cfg = HothouseConfig())
-        : currentEffect(nullptr), config(cfg), bypassed(false) {}
+    HothousePedalT(HothouseConfig cfg = HothouseConfig())
+        : currentEffect(nullptr), config(cfg), bypassed(false), meterWholeEffect(false),
+          telemetryEnabled(false), telemetryBlock(0) {}
 
-    void setEffect(HothouseEffect* effect) {
+    /**
+     * Select the effect to run; pass an EffectChain to run several
+     * effects as one block-based pass
+     */
+    void setEffect(HothouseEffectT<Sample>* effect) {
+        if (currentEffect != nullptr) {
+            currentEffect->setLoadMeter(nullptr);
+        }
         currentEffect = effect;
+        if (currentEffect != nullptr) {
+            currentEffect->setControlRate(config.controlRate);
+        }
+        attachLoadMeter();
+    }
+
+    /**
+     * Time every processBuffer() call with a cycle counter
+     * Stage loads are per EffectChain stage, or the single effect as
+     * stage 0. Call during setup, not while audio is running.
+     */
+    void enableLoadMeter(const HothouseCycleCounter& counter) {
+        loadMeter.configure(counter, config.sampleRate);
+        attachLoadMeter();
+    }
+
+    void disableLoadMeter() {
+        loadMeter.configure(HothouseCycleCounter(), config.sampleRate);
+        attachLoadMeter();
+    }
+
+    /**
+     * Latest load statistics; call from the main loop
+     */
+    const HothouseLoadReport& getLoad() {
+        return loadMeter.getReport();
+    }
+
+    // Main loop: restart peak tracking
+    void resetLoadPeaks() {
+        loadMeter.resetPeaks();
+    }
+
+    /**
+     * Push a HothouseTelemetry record for every processBuffer() call
+     * Costs two peak scans and one ring push per buffer. Call during
+     * setup, not while audio is running.
+     */
+    void enableTelemetry(bool enable) {
+        if (enable && !telemetryEnabled && currentEffect != nullptr) {
+            HothouseTelemetry stale;
+            currentEffect->collectTelemetry(stale);  // Drop counts from before
+        }
+        telemetryEnabled = enable;
+    }
+
+    /**
+     * Main loop: take the oldest telemetry record
+     * @return false once the ring is drained
+     */
+    bool popTelemetry(HothouseTelemetry& record) {
+        return telemetry.pop(record);
+    }
+
+    // Records lost because the main loop fell HOTHOUSE_TELEMETRY_RECORDS behind
+    uint32_t getTelemetryDropped() const {
+        return telemetry.getDropped();
     }
 
     /**
@@ -297,12 +4624,32 @@ public:
         if (bypassed || currentEffect == nullptr) {
             return inputSample;  // Pass through
         }
-        return currentEffect->process(inputSample);
+        return Traits::toFloat(currentEffect->process(Traits::fromFloat(inputSample)));
     }
 
-    void processBuffer(float* inputBuffer, float* outputBuffer, int numSamples) {
-        for (int i = 0; i < numSamples; i++) {
-            outputBuffer[i] = process(inputBuffer[i]);
+    void processBuffer(const float* inputBuffer, float* outputBuffer, int numSamples) {
+        if (!loadMeter.isEnabled() && !telemetryEnabled) {
+            render(inputBuffer, outputBuffer, numSamples);
+            return;
+        }
+        HothouseTelemetry record;
+        if (telemetryEnabled) {
+            record.inputPeak = hothouseBlockPeak(inputBuffer, numSamples);  // Before an in-place render
+        }
+        uint32_t start = loadMeter.isEnabled() ? loadMeter.now() : 0;
+        render(inputBuffer, outputBuffer, numSamples);
+        if (loadMeter.isEnabled()) {
+            loadMeter.endBlock(start, numSamples);
+            record.cycles = loadMeter.getLastTicks();
+        }
+        if (telemetryEnabled) {
+            record.block = telemetryBlock++;
+            record.numSamples = numSamples;
+            record.outputPeak = hothouseBlockPeak(outputBuffer, numSamples);
+            if (currentEffect != nullptr) {
+                currentEffect->collectTelemetry(record);
+            }
+            telemetry.push(record);
         }
     }
 
@@ -315,4 +4662,6 @@ public:
     }
 };
 
+typedef HothousePedalT<float> HothousePedal;
+
 #endif // HOTHOUSE_H
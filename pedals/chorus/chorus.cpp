@@ -17,75 +17,116 @@
 #include "hothouse.h"
 #include <math.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846f
-#endif
+#define MAX_CHORUS_DELAY 4800  // 100ms at the reference rate
+#define CHORUS_LINE_CAPACITY hothouseNextPowerOfTwo(hothouseMaxRateSamples(MAX_CHORUS_DELAY))
 
-#define MAX_CHORUS_DELAY 4800  // 100ms at 48kHz
-
-class Chorus : public HothouseEffect {
+template <typename Sample>
+class ChorusT : public HothouseEffectT<Sample> {
 private:
-    float delayBuffer[MAX_CHORUS_DELAY];
-    int writeIndex;
-    float lfoPhase;
+    typedef SampleTraits<Sample> Traits;
+
+    typedef DelayLine<Sample, CHORUS_LINE_CAPACITY> Line;
+    Line delayLine;  // Fast memory
+    WavetableLfo lfo;
     float sampleRate;
+    float maxDelay;  // Longest modulated delay at this rate, in samples
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_RATE,
+        PARAM_DEPTH,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    // Control-rate coefficients
+    float baseDelay;  // samples
+    float modDepth;   // samples
+    ParameterRamp mixGain;
+
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        float rate = params.get(PARAM_RATE);
+        float depth = params.get(PARAM_DEPTH);
+        float mix = params.get(PARAM_MIX);
+
+        // LFO rate and modulated delay range (10-25ms +/- 5ms depth)
+        float samplesPerMs = sampleRate / 1000.0f;
+        lfo.setFrequency(rate);
+        baseDelay = (10.0f + depth * 15.0f) * samplesPerMs;
+        modDepth = depth * 5.0f * samplesPerMs;
+
+        mixGain = ParameterRamp::between(mixGain.start, mix, numSamples);
+    }
 
-    // Smoothed parameters
-    ParameterSmoother smoothRate;
-    ParameterSmoother smoothDepth;
-    ParameterSmoother smoothMix;
-
-    // Waveform selection (0=sine, 1=triangle, 2=square)
-    int waveform;
-
-    // Generate LFO based on current waveform selection
-    float getLFO() {
-        switch (waveform) {
-            case 1:  // Triangle
-                return 2.0f * fabsf(2.0f * (lfoPhase - floorf(lfoPhase + 0.5f))) - 1.0f;
-            case 2:  // Square
-                return lfoPhase < 0.5f ? 1.0f : -1.0f;
-            default: // Sine
-                return sinf(2.0f * M_PI * lfoPhase);
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        float modulation[HOTHOUSE_MAX_CONTROL_BLOCK];
+        lfo.renderBlock(modulation, numSamples);
+
+        const Sample mixStep = Traits::fromFloat(mixGain.increment);
+        Sample mix = Traits::fromFloat(mixGain.start);
+        for (int i = 0; i < numSamples; i++) {
+            // Modulated delay in samples, read between samples
+            float delaySamples = baseDelay + modulation[i] * modDepth;
+            if (delaySamples > maxDelay) delaySamples = maxDelay;
+            if (delaySamples < 1.0f) delaySamples = 1.0f;
+            Sample delayedSample = delayLine.template read<DELAY_INTERP_LINEAR>(delaySamples);
+
+            Sample x = in[i];
+            delayLine.write(x);
+
+            // Mix dry and wet signals
+            mix += mixStep;
+            out[i] = Traits::lerp(x, delayedSample, mix);
         }
+        mixGain.start = Traits::toFloat(mix);
     }
 
 public:
-    Chorus(int sr = 48000)
-        : sampleRate((float)sr),
-          smoothRate(20.0f, (float)sr, 1.0f),
-          smoothDepth(20.0f, (float)sr, 0.5f),
-          smoothMix(20.0f, (float)sr, 0.5f) {
-        writeIndex = 0;
-        lfoPhase = 0.0f;
-        waveform = 0;
-
-        for (int i = 0; i < MAX_CHORUS_DELAY; i++) {
-            delayBuffer[i] = 0.0f;
-        }
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_FAST ? Line::arenaBytes() : 0;
+    }
+
+    ChorusT(int sr = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
+        : lfo((float)sr),
+          sampleRate((float)sr),
+          params(20.0f, (float)sr) {
+        HothouseArenaMark mark(arena);
+        delayLine.init(arena, MEMORY_FAST);
+        this->memoryUsage = mark.since(sizeof(*this));
+        int longest = hothouseSamplesAtRate(MAX_CHORUS_DELAY, sampleRate);
+        if (longest > CHORUS_LINE_CAPACITY - 1) longest = CHORUS_LINE_CAPACITY - 1;
+        maxDelay = (float)(longest - 1);
+        params.setImmediate(PARAM_RATE, 1.0f);
+        params.setImmediate(PARAM_DEPTH, 0.5f);
+        params.setImmediate(PARAM_MIX, 0.5f);
+        mixGain = ParameterRamp::constant(params.get(PARAM_MIX));
     }
 
     void updateFromControls(const HothouseControls& controls) override {
         // KNOB_1: Rate (0.1 to 5 Hz)
         float rate = 0.1f + controls.knobs[KNOB_1] * 4.9f;
-        smoothRate.setTarget(rate);
+        params.setTarget(PARAM_RATE, rate);
 
         // KNOB_2: Depth (0.0 to 1.0)
-        smoothDepth.setTarget(controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_DEPTH, controls.knobs[KNOB_2]);
 
         // KNOB_6: Mix (0.0 to 1.0)
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Waveform select
         switch (controls.toggles[TOGGLESWITCH_1]) {
             case TOGGLESWITCH_UP:
-                waveform = 0;  // Sine
+                lfo.setWaveform(LFO_SINE);
                 break;
             case TOGGLESWITCH_MIDDLE:
-                waveform = 1;  // Triangle
+                lfo.setWaveform(LFO_TRIANGLE);
                 break;
             case TOGGLESWITCH_DOWN:
-                waveform = 2;  // Square
+                lfo.setWaveform(LFO_SQUARE);
                 break;
             default:
                 break;
@@ -94,50 +135,19 @@ public:
 
     float getLedState() override {
         // Pulse LED with LFO rate
-        return (getLFO() + 1.0f) * 0.5f;
+        return (lfo.getValue() + 1.0f) * 0.5f;
     }
 
-    float process(float inputSample) override {
-        // Get smoothed parameter values
-        float rate = smoothRate.process();
-        float depth = smoothDepth.process();
-        float mix = smoothMix.process();
-
-        // Update LFO phase
-        lfoPhase += rate / sampleRate;
-        if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
-
-        // Calculate modulated delay time
-        float lfoValue = getLFO();
-        float delayTime = 10.0f + depth * 15.0f;  // 10-25ms delay range
-        float modulatedDelay = delayTime + lfoValue * depth * 5.0f;
-        int delaySamples = (int)(modulatedDelay * sampleRate / 1000.0f);
-
-        // Constrain to buffer size
-        if (delaySamples >= MAX_CHORUS_DELAY) delaySamples = MAX_CHORUS_DELAY - 1;
-        if (delaySamples < 1) delaySamples = 1;
-
-        // Calculate read position
-        int readIndex = writeIndex - delaySamples;
-        if (readIndex < 0) readIndex += MAX_CHORUS_DELAY;
-
-        // Read delayed sample
-        float delayedSample = delayBuffer[readIndex];
-
-        // Write current sample to buffer
-        delayBuffer[writeIndex] = inputSample;
-        writeIndex++;
-        if (writeIndex >= MAX_CHORUS_DELAY) writeIndex = 0;
-
-        // Mix dry and wet signals
-        return inputSample * (1.0f - mix) + delayedSample * mix;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        writeIndex = 0;
-        lfoPhase = 0.0f;
-        for (int i = 0; i < MAX_CHORUS_DELAY; i++) {
-            delayBuffer[i] = 0.0f;
-        }
+        lfo.setPhase(0.0f);
+        delayLine.clear();
     }
 };
+
+typedef ChorusT<float> Chorus;
@@ -17,101 +17,197 @@
 #include "hothouse.h"
 #include <math.h>
 
-class Compressor : public HothouseEffect {
+// Accuracy of the per-sample log2/exp2 (see FastMathPrecision)
+#ifndef COMPRESSOR_MATH_PRECISION
+#define COMPRESSOR_MATH_PRECISION FAST_MATH_MEDIUM
+#endif
+
+template <typename Sample>
+class CompressorT : public HothouseEffectT<Sample> {
 private:
-    // Smoothed parameters
-    ParameterSmoother smoothThreshold;
-    ParameterSmoother smoothRatio;
-    ParameterSmoother smoothAttack;
-    ParameterSmoother smoothRelease;
-    ParameterSmoother smoothMakeup;
-    ParameterSmoother smoothMix;
-
-    float envelope;
+    typedef SampleTraits<Sample> Traits;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_THRESHOLD,
+        PARAM_RATIO,
+        PARAM_ATTACK,
+        PARAM_RELEASE,
+        PARAM_MAKEUP,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    Sample envelope;
     float gainReductionDb;  // For LED metering
+    uint32_t clipCount;     // Output samples clamped, for telemetry
 
     // Knee mode (0=hard, 1=medium, 2=soft)
     int kneeMode;
-    float kneeWidth;
+    float kneeWidth;  // dB
 
-    float getEnvelope(float sample, float attack, float release) {
-        float rectified = fabsf(sample);
+    // Gain computer coefficients in log2 units (octaves of level),
+    // rederived only while threshold, ratio or knee change
+    float threshLog2;
+    float invRatio;
+    float halfKneeLog2;
+    float kneeScale;
+    bool gainCoeffsDirty;
 
-        if (rectified > envelope) {
-            envelope = attack * envelope + (1.0f - attack) * rectified;
-        } else {
-            envelope = release * envelope + (1.0f - release) * rectified;
-        }
+    // Envelope poles against the attack and release knobs
+    CoefficientTable<> attackTable;
+    CoefficientTable<> releaseTable;
+
+    // Control-rate coefficients
+    float attackCoeff;
+    float releaseCoeff;
+    ParameterRamp makeupGain;
+    ParameterRamp mixGain;
+
+    void updateGainCoefficients(float threshold, float ratio) {
+        float kneeLog2 = kneeWidth / HOTHOUSE_DB_PER_LOG2;
+        threshLog2 = log2f(threshold + 0.0001f);
+        invRatio = 1.0f / ratio;
+        halfKneeLog2 = kneeLog2 * 0.5f;
+        kneeScale = kneeLog2 > 0.0f ? (invRatio - 1.0f) / (2.0f * kneeLog2) : 0.0f;
+        gainCoeffsDirty = false;
+    }
 
-        return envelope;
+    // Gain computer (log2 level in, gain change in log2 out), coefficients
+    // precomputed. Same curve as in dB, scaled by HOTHOUSE_DB_PER_LOG2.
+    template <bool HardKnee>
+    float computeGainLog2(float envLog2, float threshLog2, float invRatio, float halfKnee, float kneeScale) {
+        if (HardKnee) {
+            if (envLog2 > threshLog2) {
+                return (envLog2 - threshLog2) * (invRatio - 1.0f);
+            }
+            return 0.0f;
+        }
+        if (envLog2 < threshLog2 - halfKnee) return 0.0f;
+        if (envLog2 > threshLog2 + halfKnee) return (envLog2 - threshLog2) * (invRatio - 1.0f);
+        float x = envLog2 - threshLog2 + halfKnee;
+        return x * x * kneeScale;
     }
 
-    float computeGain(float envLevel, float threshold, float ratio) {
-        if (envLevel < 0.0001f) return 1.0f;
+    // Inner loop with the knee mode resolved at compile time
+    template <bool HardKnee>
+    void renderBlock(const Sample* in, Sample* out, int n) {
+        float halfKnee = halfKneeLog2;
+        const Sample attack = Traits::fromFloat(attackCoeff);
+        const Sample attackKeep = Traits::fromFloat(1.0f - attackCoeff);
+        const Sample release = Traits::fromFloat(releaseCoeff);
+        const Sample releaseKeep = Traits::fromFloat(1.0f - releaseCoeff);
+        const Sample envelopeFloor = Traits::fromFloat(0.0001f);
+        const Sample denormalDc = Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        const Sample mixStep = Traits::fromFloat(mixGain.increment);
+        float makeup = makeupGain.start;
+        Sample mix = Traits::fromFloat(mixGain.start);
+        Sample env = envelope;
+        float gainLog2 = -gainReductionDb / HOTHOUSE_DB_PER_LOG2;
+        uint32_t clips = 0;
 
-        // Convert to dB
-        float envDb = 20.0f * log10f(envLevel);
-        float threshDb = 20.0f * log10f(threshold + 0.0001f);
+        for (int i = 0; i < n; i++) {
+            Sample x = in[i];
 
-        float gainDb = 0.0f;
+            // Envelope follower
+            Sample rectified = Traits::abs(x);
+            bool rising = rectified > env;
+            Sample coeff = rising ? attack : release;
+            Sample coeffKeep = rising ? attackKeep : releaseKeep;
+            env = coeff * env + coeffKeep * rectified + denormalDc;
 
-        if (kneeMode == 0) {
-            // Hard knee
-            if (envDb > threshDb) {
-                gainDb = threshDb + (envDb - threshDb) / ratio - envDb;
-            }
-        } else {
-            // Soft knee
-            float knee = kneeWidth;
-            if (envDb < threshDb - knee / 2.0f) {
-                gainDb = 0.0f;
-            } else if (envDb > threshDb + knee / 2.0f) {
-                gainDb = threshDb + (envDb - threshDb) / ratio - envDb;
-            } else {
-                // In the knee region
-                float x = envDb - threshDb + knee / 2.0f;
-                gainDb = ((1.0f / ratio - 1.0f) * x * x) / (2.0f * knee);
+            // Gain computer in float, on the log2 of the envelope
+            float gain = 1.0f;
+            if (env >= envelopeFloor) {
+                float envLog2 = fastLog2<COMPRESSOR_MATH_PRECISION>(Traits::toFloat(env));
+                gainLog2 = computeGainLog2<HardKnee>(envLog2, threshLog2, invRatio, halfKnee, kneeScale);
+                gain = fastExp2<COMPRESSOR_MATH_PRECISION>(gainLog2);
             }
+
+            makeup += makeupGain.increment;
+            mix += mixStep;
+            Sample scaled = Traits::scale(x, gain * makeup);
+            clips += Traits::clips(scaled);
+            Sample compressed = Traits::clampUnit(scaled);
+
+            out[i] = Traits::lerp(x, compressed, mix);
         }
 
-        gainReductionDb = -gainDb;  // Store for LED
-        return powf(10.0f, gainDb / 20.0f);
+        envelope = env;
+        gainReductionDb = -gainLog2 * HOTHOUSE_DB_PER_LOG2;  // Store for LED
+        clipCount += clips;
+        makeupGain.start = makeup;
+        mixGain.start = Traits::toFloat(mix);
+    }
+
+protected:
+    void updateControlRate(int numSamples) override {
+        if (!params.isSettled(PARAM_THRESHOLD) || !params.isSettled(PARAM_RATIO)) {
+            gainCoeffsDirty = true;
+        }
+        params.processBlock(numSamples);
+
+        if (gainCoeffsDirty) {
+            updateGainCoefficients(params.get(PARAM_THRESHOLD), params.get(PARAM_RATIO));
+        }
+        attackCoeff = attackTable(params.get(PARAM_ATTACK));
+        releaseCoeff = releaseTable(params.get(PARAM_RELEASE));
+        makeupGain = ParameterRamp::between(makeupGain.start, params.get(PARAM_MAKEUP), numSamples);
+        mixGain = ParameterRamp::between(mixGain.start, params.get(PARAM_MIX), numSamples);
+    }
+
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        if (kneeMode == 0) {
+            renderBlock<true>(in, out, numSamples);
+        } else {
+            renderBlock<false>(in, out, numSamples);
+        }
     }
 
 public:
-    Compressor(int sampleRate = 48000)
-        : smoothThreshold(20.0f, (float)sampleRate, 0.5f),
-          smoothRatio(20.0f, (float)sampleRate, 0.25f),
-          smoothAttack(20.0f, (float)sampleRate, 0.3f),
-          smoothRelease(20.0f, (float)sampleRate, 0.5f),
-          smoothMakeup(20.0f, (float)sampleRate, 0.5f),
-          smoothMix(20.0f, (float)sampleRate, 1.0f) {
-        envelope = 0.0f;
+    CompressorT(int sampleRate = 48000)
+        : params(20.0f, (float)sampleRate) {
+        params.setImmediate(PARAM_THRESHOLD, 0.5f);
+        params.setImmediate(PARAM_RATIO, 0.25f);
+        params.setImmediate(PARAM_ATTACK, 0.0f);
+        params.setImmediate(PARAM_RELEASE, 0.0f);
+        params.setImmediate(PARAM_MAKEUP, 0.5f);
+        params.setImmediate(PARAM_MIX, 1.0f);
+        envelope = Sample();
         gainReductionDb = 0.0f;
+        clipCount = 0;
         kneeMode = 0;
         kneeWidth = 6.0f;
+        attackTable.buildPole(0.5f, 0.49f, (float)sampleRate);
+        releaseTable.buildPole(0.9f, 0.099f, (float)sampleRate);
+        updateGainCoefficients(params.get(PARAM_THRESHOLD), params.get(PARAM_RATIO));
+        makeupGain = ParameterRamp::constant(params.get(PARAM_MAKEUP));
+        mixGain = ParameterRamp::constant(params.get(PARAM_MIX));
+        this->memoryUsage = HothouseMemoryUsage(sizeof(*this));  // No buffers
     }
 
     void updateFromControls(const HothouseControls& controls) override {
         // KNOB_1: Threshold (0.01 to 1.0)
-        smoothThreshold.setTarget(0.01f + controls.knobs[KNOB_1] * 0.99f);
+        params.setTarget(PARAM_THRESHOLD, 0.01f + controls.knobs[KNOB_1] * 0.99f);
 
         // KNOB_2: Ratio (1:1 to 20:1)
-        smoothRatio.setTarget(1.0f + controls.knobs[KNOB_2] * 19.0f);
+        params.setTarget(PARAM_RATIO, 1.0f + controls.knobs[KNOB_2] * 19.0f);
 
         // KNOB_3: Attack (fast to slow)
-        smoothAttack.setTarget(0.5f + controls.knobs[KNOB_3] * 0.49f);
+        params.setTarget(PARAM_ATTACK, controls.knobs[KNOB_3]);
 
         // KNOB_4: Release (fast to slow)
-        smoothRelease.setTarget(0.9f + controls.knobs[KNOB_4] * 0.099f);
+        params.setTarget(PARAM_RELEASE, controls.knobs[KNOB_4]);
 
         // KNOB_5: Makeup gain (1x to 10x)
-        smoothMakeup.setTarget(1.0f + controls.knobs[KNOB_5] * 9.0f);
+        params.setTarget(PARAM_MAKEUP, 1.0f + controls.knobs[KNOB_5] * 9.0f);
 
         // KNOB_6: Mix (parallel compression)
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Knee mode
+        int previousKneeMode = kneeMode;
         switch (controls.toggles[TOGGLESWITCH_1]) {
             case TOGGLESWITCH_UP:
                 kneeMode = 0;
@@ -128,6 +224,7 @@ public:
             default:
                 break;
         }
+        if (kneeMode != previousKneeMode) gainCoeffsDirty = true;
     }
 
     float getLedState() override {
@@ -138,33 +235,22 @@ public:
         return 1.0f - ledValue * 0.8f;  // Dim when compressing hard
     }
 
-    float process(float inputSample) override {
-        float threshold = smoothThreshold.process();
-        float ratio = smoothRatio.process();
-        float attack = smoothAttack.process();
-        float release = smoothRelease.process();
-        float makeup = smoothMakeup.process();
-        float mix = smoothMix.process();
-
-        // Get envelope level
-        float envLevel = getEnvelope(inputSample, attack, release);
-
-        // Compute gain reduction
-        float gain = computeGain(envLevel, threshold, ratio);
-
-        // Apply compression and makeup gain
-        float compressed = inputSample * gain * makeup;
-
-        // Clip output to prevent extreme levels
-        if (compressed > 1.0f) compressed = 1.0f;
-        if (compressed < -1.0f) compressed = -1.0f;
+    void collectTelemetry(HothouseTelemetry& record) override {
+        record.clips += clipCount;
+        if (gainReductionDb > record.gainReductionDb) record.gainReductionDb = gainReductionDb;
+        clipCount = 0;
+    }
 
-        // Mix dry and compressed (parallel compression)
-        return inputSample * (1.0f - mix) + compressed * mix;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        envelope = 0.0f;
+        envelope = Sample();
         gainReductionDb = 0.0f;
     }
 };
+
+typedef CompressorT<float> Compressor;
@@ -16,42 +16,163 @@
 
 #include "hothouse.h"
 
-#define MAX_DELAY_SAMPLES 48000  // 1 second at 48kHz
+#define MAX_DELAY_SAMPLES 48000  // 1 second at the reference rate
+#define DELAY_LINE_CAPACITY hothouseNextPowerOfTwo(hothouseMaxRateSamples(MAX_DELAY_SAMPLES))
 
-class Delay : public HothouseEffect {
+/**
+ * Storage is the delay line's sample format (see DelayStorage). Capacity
+ * scales the time range: every setting lasts Capacity/DELAY_LINE_CAPACITY
+ * times longer than with the default line.
+ */
+template <typename Sample, typename Storage = Sample, int Capacity = DELAY_LINE_CAPACITY>
+class DelayT : public HothouseEffectT<Sample> {
 private:
-    float delayBuffer[MAX_DELAY_SAMPLES];
-    int writeIndex;
-    int sampleRate;
-
-    // Smoothed parameters
-    ParameterSmoother smoothTime;
-    ParameterSmoother smoothFeedback;
-    ParameterSmoother smoothFilter;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
+    typedef SampleTraits<Sample> Traits;
 
-    // Filter state for feedback path
-    float filterState;
+    typedef DelayLine<Sample, Capacity, Storage> Line;
+    Line delayLine;  // Bulk memory
+    int sampleRate;
+    int maxDelay;  // Longest delay at this rate, in samples
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_TIME,
+        PARAM_FEEDBACK,
+        PARAM_FILTER,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    // High-cut filter for the feedback path
+    OnePoleT<Sample, true> feedbackFilter;
+    CoefficientTable<> filterTable;
 
     // Time multiplier based on switch position
     float timeMultiplier;
 
+    // Control-rate coefficients
+    int delaySamples;         // Whole-sample delay, read while Time is settled
+    float delayTarget;        // Where the read tap is at the next control block
+    ParameterRamp delayRamp;  // Read tap glide while Time moves
+    float feedbackGain;
+    ParameterRamp dryGain;
+    ParameterRamp wetGain;
+
+    uint32_t clipCount;  // Feedback samples clamped, for telemetry
+
+    // Delay in samples for a Time setting (50ms to 1000ms, scaled by
+    // capacity). At least one block plus the cubic read's look-behind, so a
+    // whole block can be read before it is written, and two samples short
+    // of the line for the look-ahead.
+    float delayFor(float time) const {
+        const float timeScale = (float)Capacity / DELAY_LINE_CAPACITY;
+        return constrain((0.05f + time * 0.95f) * sampleRate * timeScale,
+                         HOTHOUSE_MAX_CONTROL_BLOCK + 1.0f, maxDelay - 3.0f);
+    }
+
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        float time = params.get(PARAM_TIME);
+        float feedback = params.get(PARAM_FEEDBACK);
+        float filter = params.get(PARAM_FILTER);
+        float level = params.get(PARAM_LEVEL);
+        float mix = params.get(PARAM_MIX);
+
+        // While Time moves the read tap glides to the new delay across the
+        // block; once it settles it lands on a whole sample
+        float delay = delayFor(time);
+        delaySamples = (int)delay;
+        float target = params.isSettled(PARAM_TIME) ? (float)delaySamples : delay;
+        delayRamp = ParameterRamp::between(delayTarget, target, numSamples);
+        delayTarget = target;
+
+        // High-cut filter on the feedback path (one-pole lowpass)
+        feedbackGain = feedback;
+        feedbackFilter.setCoefficient(filterTable(filter));
+
+        // Output gains ramp linearly to the new mix/level
+        dryGain = ParameterRamp::between(dryGain.start, 1.0f - mix, numSamples);
+        wetGain = ParameterRamp::between(wetGain.start, level * mix, numSamples);
+    }
+
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        Sample delayed[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample written[HOTHOUSE_MAX_CONTROL_BLOCK];
+        if (delayRamp.increment == 0.0f && delayRamp.start == (float)delaySamples) {
+            delayLine.readBlock(delayed, delaySamples, numSamples);
+        } else {
+            // Fractional tap, one step along the glide per sample
+            float delay = delayRamp.start;
+            for (int i = 0; i < numSamples; i++) {
+                delay += delayRamp.increment;
+                delayed[i] = delayLine.template read<DELAY_INTERP_CUBIC>(delay - (float)i);
+            }
+            delayRamp.start = delay;
+        }
+
+        // Apply high-cut filter to feedback
+        feedbackFilter.processBlock(delayed, written, numSamples);
+
+        const Sample feedback = Traits::fromFloat(feedbackGain);
+        const Sample dryStep = Traits::fromFloat(dryGain.increment);
+        const Sample wetStep = Traits::fromFloat(wetGain.increment);
+        Sample dry = Traits::fromFloat(dryGain.start);
+        Sample wet = Traits::fromFloat(wetGain.start);
+        uint32_t clips = 0;
+
+        for (int i = 0; i < numSamples; i++) {
+            Sample x = in[i];
+            Sample delayedSample = delayed[i];
+
+            // Write to buffer with feedback, clipped to prevent runaway
+            Sample fed = x + written[i] * feedback;
+            clips += Traits::clips(fed);
+            written[i] = Traits::clampUnit(fed);
+
+            // Mix dry and wet signals with level control
+            dry += dryStep;
+            wet += wetStep;
+            out[i] = x * dry + delayedSample * wet;
+        }
+
+        delayLine.writeBlock(written, numSamples);
+        clipCount += clips;
+
+        dryGain.start = Traits::toFloat(dry);
+        wetGain.start = Traits::toFloat(wet);
+    }
+
 public:
-    Delay(int sr = 48000)
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_BULK ? Line::arenaBytes() : 0;
+    }
+
+    DelayT(int sr = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
         : sampleRate(sr),
-          smoothTime(20.0f, (float)sr, 0.5f),
-          smoothFeedback(20.0f, (float)sr, 0.5f),
-          smoothFilter(20.0f, (float)sr, 0.7f),
-          smoothLevel(20.0f, (float)sr, 1.0f),
-          smoothMix(20.0f, (float)sr, 0.5f) {
-        writeIndex = 0;
-        filterState = 0.0f;
+          params(20.0f, (float)sr) {
+        HothouseArenaMark mark(arena);
+        delayLine.init(arena, MEMORY_BULK);
+        this->memoryUsage = mark.since(sizeof(*this));
+        maxDelay = (int)((long long)hothouseSamplesAtRate(MAX_DELAY_SAMPLES, (float)sr) * Capacity
+                         / DELAY_LINE_CAPACITY);
+        if (maxDelay > Capacity) maxDelay = Capacity;
+        filterTable.buildOnePole(0.1f, 0.89f, (float)sr);
+        params.setImmediate(PARAM_TIME, 0.5f);
+        params.setImmediate(PARAM_FEEDBACK, 0.5f);
+        params.setImmediate(PARAM_FILTER, 0.7f);
+        params.setImmediate(PARAM_LEVEL, 1.0f);
+        params.setImmediate(PARAM_MIX, 0.5f);
         timeMultiplier = 1.0f;
-
-        for (int i = 0; i < MAX_DELAY_SAMPLES; i++) {
-            delayBuffer[i] = 0.0f;
-        }
+        delaySamples = (int)delayFor(params.get(PARAM_TIME));
+        delayTarget = (float)delaySamples;
+        delayRamp = ParameterRamp::constant(delayTarget);
+        dryGain = ParameterRamp::constant(1.0f - params.get(PARAM_MIX));
+        wetGain = ParameterRamp::constant(params.get(PARAM_LEVEL) * params.get(PARAM_MIX));
+        clipCount = 0;
     }
 
     void updateFromControls(const HothouseControls& controls) override {
@@ -72,71 +193,45 @@ public:
 
         // KNOB_1: Time (scaled by mode)
         float time = controls.knobs[KNOB_1] * timeMultiplier;
-        smoothTime.setTarget(time);
+        params.setTarget(PARAM_TIME, time);
 
         // KNOB_2: Feedback (0 to 0.9)
-        smoothFeedback.setTarget(controls.knobs[KNOB_2] * 0.9f);
+        params.setTarget(PARAM_FEEDBACK, controls.knobs[KNOB_2] * 0.9f);
 
         // KNOB_3: Filter (high-cut frequency)
-        smoothFilter.setTarget(controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_FILTER, controls.knobs[KNOB_3]);
 
         // KNOB_4: Level
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
 
         // KNOB_6: Mix
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
     }
 
     float getLedState() override {
         return 1.0f;
     }
 
-    float process(float inputSample) override {
-        // Get smoothed parameter values
-        float time = smoothTime.process();
-        float feedback = smoothFeedback.process();
-        float filter = smoothFilter.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Calculate delay in samples (50ms to 1000ms range)
-        int delaySamples = (int)((0.05f + time * 0.95f) * sampleRate);
-        if (delaySamples < 1) delaySamples = 1;
-        if (delaySamples >= MAX_DELAY_SAMPLES) delaySamples = MAX_DELAY_SAMPLES - 1;
-
-        // Calculate read index
-        int readIndex = writeIndex - delaySamples;
-        if (readIndex < 0) readIndex += MAX_DELAY_SAMPLES;
-
-        // Read delayed sample
-        float delayedSample = delayBuffer[readIndex];
-
-        // Apply high-cut filter to feedback (one-pole lowpass)
-        float filterCoeff = 0.1f + filter * 0.89f;
-        filterState = filterState * (1.0f - filterCoeff) + delayedSample * filterCoeff;
-        float filteredFeedback = filterState;
-
-        // Write to buffer with feedback
-        delayBuffer[writeIndex] = inputSample + (filteredFeedback * feedback);
-
-        // Clip to prevent runaway
-        if (delayBuffer[writeIndex] > 1.0f) delayBuffer[writeIndex] = 1.0f;
-        if (delayBuffer[writeIndex] < -1.0f) delayBuffer[writeIndex] = -1.0f;
-
-        // Increment write index
-        writeIndex++;
-        if (writeIndex >= MAX_DELAY_SAMPLES) writeIndex = 0;
-
-        // Mix dry and wet signals with level control
-        float wetSignal = delayedSample * level;
-        return inputSample * (1.0f - mix) + wetSignal * mix;
+    void collectTelemetry(HothouseTelemetry& record) override {
+        record.clips += clipCount;
+        clipCount = 0;
+    }
+
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        writeIndex = 0;
-        filterState = 0.0f;
-        for (int i = 0; i < MAX_DELAY_SAMPLES; i++) {
-            delayBuffer[i] = 0.0f;
-        }
+        feedbackFilter.reset();
+        delayLine.clear();
     }
 };
+
+typedef DelayT<float> Delay;
+
+// Long-delay presets: 16-bit storage doubles the time in the same 256KB,
+// 12-bit companded quadruples it in 384KB
+typedef DelayT<float, Q15, 2 * DELAY_LINE_CAPACITY> LongDelay;           // 2 s
+typedef DelayT<float, Companded12, 4 * DELAY_LINE_CAPACITY> LongDelay12;  // 4 s
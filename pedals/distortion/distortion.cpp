@@ -18,71 +18,138 @@
 #include <math.h>
 
 #define MAX_DISTORTION_GAIN 100.0f
+#define DISTORTION_HEADROOM 256.0f  // Fixed-point clipper headroom when antialiased
 
-class Distortion : public HothouseEffect {
-private:
-    // Smoothed parameters
-    ParameterSmoother smoothGain;
-    ParameterSmoother smoothTone;
-    ParameterSmoother smoothBass;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
+// Clipping stage antialiasing: oversampling factor 1, 2, 4 or 8, or
+// ADAA_FIRST_ORDER / ADAA_SECOND_ORDER (see ClipStageT)
+#ifndef DISTORTION_ANTIALIASING
+#define DISTORTION_ANTIALIASING 4
+#endif
 
-    float previousSample;
-    float dcBlocker;
-    float bassState;
+template <typename Sample, int Antialiasing = DISTORTION_ANTIALIASING>
+class DistortionT : public HothouseEffectT<Sample> {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_GAIN,
+        PARAM_TONE,
+        PARAM_BASS,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    // Input pre-emphasis: a one-zero at 0.995 that removes DC and tilts
+    // the input bright before the gain stage
+    OneZeroT<Sample> dcBlocker;
+    // Above its corner the one-zero's gain at a given frequency falls as
+    // the rate rises; this restores its gain at the reference rate
+    float emphasisGain;
+    OnePoleShelfT<Sample> bassShelf;
+    OnePoleT<Sample> toneFilter;
+    CoefficientTable<> toneTable;
 
     // Clipping mode (0=hard, 1=medium, 2=soft)
     int clipMode;
 
-    // Hard clipping function
-    float hardClip(float sample, float threshold) {
-        if (sample > threshold) return threshold;
-        if (sample < -threshold) return -threshold;
-        return sample;
+    // Control-rate coefficients
+    float gainFactor;
+    ParameterRamp dryGain;
+    ParameterRamp wetGain;
+
+    // Clipping stage, one voice per mode, antialiased
+    typedef ClipStageT<Sample, Antialiasing, 3> Clipper;
+    Clipper clipper;
+
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        float gain = params.get(PARAM_GAIN);
+        float tone = params.get(PARAM_TONE);
+        float bass = params.get(PARAM_BASS);
+        float level = params.get(PARAM_LEVEL);
+        float mix = params.get(PARAM_MIX);
+
+        bassShelf.setGain((bass - 0.5f) * 2.0f);  // -1 to +1
+        gainFactor = 1.0f + gain * (MAX_DISTORTION_GAIN - 1.0f);
+        toneFilter.setCoefficient(toneTable(tone));
+
+        // Output gains ramp linearly to the new mix/level
+        dryGain = ParameterRamp::between(dryGain.start, (1.0f - mix) * level, numSamples);
+        wetGain = ParameterRamp::between(wetGain.start, mix * level, numSamples);
     }
 
-    // Soft clipping (tanh approximation)
-    float softClip(float sample) {
-        if (sample > 1.0f) return 0.76159f;
-        if (sample < -1.0f) return -0.76159f;
-        float x2 = sample * sample;
-        return sample * (27.0f + x2) / (27.0f + 9.0f * x2);
-    }
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        const float gain = gainFactor * clipper.getInputGain(clipMode) * emphasisGain;
+        const float wetScale = clipper.getOutputGain(clipMode);
+        const Sample dryStep = Traits::fromFloat(dryGain.increment);
+        const Sample wetStep = Traits::fromFloat(wetGain.increment);
+        Sample dry = Traits::fromFloat(dryGain.start);
+        Sample wet = Traits::fromFloat(wetGain.start);
+        Sample amplified[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample alignedDry[HOTHOUSE_MAX_CONTROL_BLOCK];
+        const Sample* dryIn = clipper.alignDry(in, alignedDry, numSamples);
+
+        // Remove DC offset, then bass boost/cut
+        dcBlocker.processBlock(in, amplified, numSamples);
+        bassShelf.processBlock(amplified, numSamples);
+        for (int i = 0; i < numSamples; i++) amplified[i] = Traits::scale(amplified[i], gain);
+
+        clipper.process(clipMode, amplified, numSamples);
+
+        // One-pole low-pass for tone
+        toneFilter.processBlock(amplified, numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            dry += dryStep;
+            wet += wetStep;
+            out[i] = dryIn[i] * dry + Traits::scale(amplified[i], wetScale) * wet;
+        }
 
-    // Simple high-pass filter to remove DC offset
-    float dcBlock(float sample) {
-        float output = sample - dcBlocker;
-        dcBlocker = sample * 0.995f;
-        return output;
+        dryGain.start = Traits::toFloat(dry);
+        wetGain.start = Traits::toFloat(wet);
     }
 
-    // One-pole low-pass filter for tone
-    float lowPass(float sample, float alpha) {
-        float filtered = alpha * sample + (1.0f - alpha) * previousSample;
-        previousSample = filtered;
-        return filtered;
+public:
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_FAST ? Clipper::arenaBytes() : 0;
     }
 
-public:
-    Distortion(int sampleRate = 48000)
-        : smoothGain(20.0f, (float)sampleRate, 0.5f),
-          smoothTone(20.0f, (float)sampleRate, 0.6f),
-          smoothBass(20.0f, (float)sampleRate, 0.5f),
-          smoothLevel(20.0f, (float)sampleRate, 0.7f),
-          smoothMix(20.0f, (float)sampleRate, 1.0f) {
-        previousSample = 0.0f;
-        dcBlocker = 0.0f;
-        bassState = 0.0f;
+    DistortionT(int sampleRate = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
+        : params(20.0f, (float)sampleRate) {
+        // In fixed point the gained signal must stay unclipped until it has
+        // been antialiased, or it clips at the base rate and aliases
+        const float headroom = Antialiasing != 1 ? DISTORTION_HEADROOM : 1.0f;
+        HothouseArenaMark mark(arena);
+        clipper.init(arena, MEMORY_FAST);
+        this->memoryUsage = mark.since(sizeof(*this));
+        clipper.setVoice(0, ClipCurve::hard(0.7f), 1.0f, headroom);  // Hard
+        clipper.setVoice(1, ClipCurve::soft(0.8f, 0.85f, ClipCurve::tanhApprox(0.85f * 0.8f)), 1.0f,
+                         headroom);                                   // Medium
+        clipper.setVoice(2, ClipCurve::soft(0.5f, 2.0f, 0.76159f), 3.0f, headroom);  // Soft
+        params.setImmediate(PARAM_GAIN, 0.5f);
+        params.setImmediate(PARAM_TONE, 0.6f);
+        params.setImmediate(PARAM_BASS, 0.5f);
+        params.setImmediate(PARAM_LEVEL, 0.7f);
+        params.setImmediate(PARAM_MIX, 1.0f);
+        dcBlocker.setCoefficient(hothouseRescalePole(0.995f, (float)sampleRate));
+        emphasisGain = (float)sampleRate / HOTHOUSE_REFERENCE_RATE;
+        bassShelf.setCoefficient(hothouseRescaleOnePole(0.05f, (float)sampleRate));
+        toneTable.buildOnePole(0.3f, 0.69f, (float)sampleRate);
         clipMode = 0;
+        dryGain = ParameterRamp::constant((1.0f - params.get(PARAM_MIX)) * params.get(PARAM_LEVEL));
+        wetGain = ParameterRamp::constant(params.get(PARAM_MIX) * params.get(PARAM_LEVEL));
     }
 
     void updateFromControls(const HothouseControls& controls) override {
-        smoothGain.setTarget(controls.knobs[KNOB_1]);
-        smoothTone.setTarget(controls.knobs[KNOB_2]);
-        smoothBass.setTarget(controls.knobs[KNOB_3]);
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_GAIN, controls.knobs[KNOB_1]);
+        params.setTarget(PARAM_TONE, controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_BASS, controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Clipping mode
         switch (controls.toggles[TOGGLESWITCH_1]) {
@@ -104,52 +171,18 @@ public:
         return 1.0f;
     }
 
-    float process(float inputSample) override {
-        float gain = smoothGain.process();
-        float tone = smoothTone.process();
-        float bass = smoothBass.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Remove DC offset
-        float sample = dcBlock(inputSample);
-
-        // Bass boost/cut (shelf-like behavior)
-        float bassCoeff = 0.05f;
-        bassState = bassState * (1.0f - bassCoeff) + sample * bassCoeff;
-        float bassBoost = (bass - 0.5f) * 2.0f;  // -1 to +1
-        sample = sample + bassState * bassBoost;
-
-        // Apply gain
-        float amplified = sample * (1.0f + gain * (MAX_DISTORTION_GAIN - 1.0f));
-
-        // Apply clipping based on mode
-        float clipped;
-        switch (clipMode) {
-            case 0:  // Hard
-                clipped = hardClip(amplified, 0.7f);
-                break;
-            case 1:  // Medium
-                clipped = hardClip(amplified, 0.85f);
-                clipped = softClip(clipped * 0.8f);
-                break;
-            default: // Soft
-                clipped = softClip(amplified * 0.5f);
-                break;
-        }
-
-        // Apply tone control (low-pass filter)
-        float toneAlpha = 0.3f + tone * 0.69f;
-        float toned = lowPass(clipped, toneAlpha);
-
-        // Mix dry/wet and apply output level
-        float output = inputSample * (1.0f - mix) + toned * mix;
-        return output * level;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        previousSample = 0.0f;
-        dcBlocker = 0.0f;
-        bassState = 0.0f;
+        dcBlocker.reset();
+        bassShelf.reset();
+        toneFilter.reset();
+        clipper.reset();
     }
 };
+
+typedef DistortionT<float> Distortion;
@@ -18,78 +18,140 @@
 #include <math.h>
 
 #define MAX_FUZZ_GAIN 200.0f
+#define FUZZ_HEADROOM 256.0f  // Fixed-point clipper headroom: linear tails, antialiased input
 
-class Fuzz : public HothouseEffect {
-private:
-    // Smoothed parameters
-    ParameterSmoother smoothFuzz;
-    ParameterSmoother smoothTone;
-    ParameterSmoother smoothGate;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
+// Clipping stage antialiasing: oversampling factor 1, 2, 4 or 8, or
+// ADAA_FIRST_ORDER / ADAA_SECOND_ORDER (see ClipStageT)
+#ifndef FUZZ_ANTIALIASING
+#define FUZZ_ANTIALIASING 4
+#endif
 
-    float previousSample;
-    float dcBlocker;
+template <typename Sample, int Antialiasing = FUZZ_ANTIALIASING>
+class FuzzT : public HothouseEffectT<Sample> {
+private:
+    typedef SampleTraits<Sample> Traits;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_FUZZ,
+        PARAM_TONE,
+        PARAM_GATE,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    OneZeroT<Sample> dcBlocker;
+    // Above its corner the one-zero's gain at a given frequency falls as
+    // the rate rises; this restores its gain at the reference rate
+    float emphasisGain;
+    OnePoleT<Sample> toneFilter;
+    CoefficientTable<> toneTable;
 
     // Character mode (0=vintage, 1=modern, 2=octave)
     int character;
 
-    // Asymmetric clipping for vintage fuzz
-    float vintageClip(float sample) {
-        if (sample > 0.5f) {
-            return 0.5f + (sample - 0.5f) * 0.1f;
-        } else if (sample < -0.6f) {
-            return -0.6f + (sample + 0.6f) * 0.15f;
-        }
-        return sample;
+    // Control-rate coefficients
+    float gateThreshold;
+    float gainFactor;
+    ParameterRamp dryGain;
+    ParameterRamp wetGain;
+
+    // Clipping stage, one voice per character, antialiased
+    typedef ClipStageT<Sample, Antialiasing, 3> Clipper;
+    Clipper clipper;
+
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        float fuzz = params.get(PARAM_FUZZ);
+        float tone = params.get(PARAM_TONE);
+        float gate = params.get(PARAM_GATE);
+        float level = params.get(PARAM_LEVEL);
+        float mix = params.get(PARAM_MIX);
+
+        gateThreshold = gate * 0.1f;
+        gainFactor = 1.0f + fuzz * (MAX_FUZZ_GAIN - 1.0f);
+        toneFilter.setCoefficient(toneTable(tone));
+
+        // Output gains ramp linearly to the new mix/level
+        dryGain = ParameterRamp::between(dryGain.start, (1.0f - mix) * level * 0.8f, numSamples);
+        wetGain = ParameterRamp::between(wetGain.start, mix * level * 0.8f, numSamples);
     }
 
-    // Harder clipping for modern fuzz
-    float modernClip(float sample) {
-        if (sample > 0.4f) return 0.4f;
-        if (sample < -0.4f) return -0.4f;
-        return sample;
-    }
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        const Sample gate = Traits::fromFloat(gateThreshold);
+        const float gain = gainFactor * clipper.getInputGain(character);
+        const float wetScale = clipper.getOutputGain(character) * emphasisGain;
+        const Sample dryStep = Traits::fromFloat(dryGain.increment);
+        Sample dry = Traits::fromFloat(dryGain.start);
+        float wet = wetGain.start;
+        Sample gated[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample clipped[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample alignedDry[HOTHOUSE_MAX_CONTROL_BLOCK];
 
-    // Octave fuzz (full-wave rectification + clipping)
-    float octaveClip(float sample) {
-        float rectified = fabsf(sample);
-        if (rectified > 0.5f) rectified = 0.5f;
-        return rectified * (sample > 0 ? 1.0f : -1.0f) * 0.5f + sample * 0.5f;
-    }
+        // Noise gate
+        for (int i = 0; i < numSamples; i++) {
+            Sample x = in[i];
+            gated[i] = Traits::abs(x) < gate ? Sample() : x;
+            clipped[i] = Traits::scale(gated[i], gain);
+        }
 
-    // DC blocker
-    float dcBlock(float sample) {
-        float output = sample - dcBlocker;
-        dcBlocker = sample * 0.995f;
-        return output;
-    }
+        clipper.process(character, clipped, numSamples);
+        const Sample* dryIn = clipper.alignDry(gated, alignedDry, numSamples);
+
+        // Remove DC offset, then one-pole lowpass for tone
+        dcBlocker.processBlock(clipped, numSamples);
+        toneFilter.processBlock(clipped, numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            dry += dryStep;
+            wet += wetGain.increment;
+            out[i] = dryIn[i] * dry + Traits::scale(clipped[i], wet * wetScale);
+        }
 
-    // One-pole lowpass for tone
-    float lowPass(float sample, float alpha) {
-        float filtered = alpha * sample + (1.0f - alpha) * previousSample;
-        previousSample = filtered;
-        return filtered;
+        dryGain.start = Traits::toFloat(dry);
+        wetGain.start = wet;
     }
 
 public:
-    Fuzz(int sampleRate = 48000)
-        : smoothFuzz(20.0f, (float)sampleRate, 0.7f),
-          smoothTone(20.0f, (float)sampleRate, 0.5f),
-          smoothGate(20.0f, (float)sampleRate, 0.0f),
-          smoothLevel(20.0f, (float)sampleRate, 0.7f),
-          smoothMix(20.0f, (float)sampleRate, 1.0f) {
-        previousSample = 0.0f;
-        dcBlocker = 0.0f;
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_FAST ? Clipper::arenaBytes() : 0;
+    }
+
+    FuzzT(int sampleRate = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
+        : params(20.0f, (float)sampleRate) {
+        HothouseArenaMark mark(arena);
+        clipper.init(arena, MEMORY_FAST);
+        this->memoryUsage = mark.since(sizeof(*this));
+        // Vintage: asymmetric knees with gentle linear tails
+        clipper.setVoice(0, ClipCurve::asymmetric(0.5f, 0.1f, -0.6f, 0.15f), 1.0f, FUZZ_HEADROOM);
+        // Modern: hard clip. Antialiased, it also needs its input unclipped
+        // in fixed point until it has been processed
+        clipper.setVoice(1, ClipCurve::hard(0.4f), 0.5f, Antialiasing != 1 ? FUZZ_HEADROOM : 1.0f);
+        // Octave: half of a rectified, clipped copy plus half of the input,
+        // which works out to unity up to 0.5 and half slope beyond
+        clipper.setVoice(2, ClipCurve::asymmetric(0.5f, 0.5f, -0.5f, 0.5f), 1.0f, FUZZ_HEADROOM);
+        params.setImmediate(PARAM_FUZZ, 0.7f);
+        params.setImmediate(PARAM_TONE, 0.5f);
+        params.setImmediate(PARAM_GATE, 0.0f);
+        params.setImmediate(PARAM_LEVEL, 0.7f);
+        params.setImmediate(PARAM_MIX, 1.0f);
+        dcBlocker.setCoefficient(hothouseRescalePole(0.995f, (float)sampleRate));
+        emphasisGain = (float)sampleRate / HOTHOUSE_REFERENCE_RATE;
+        toneTable.buildOnePole(0.2f, 0.79f, (float)sampleRate);
         character = 0;
+        dryGain = ParameterRamp::constant((1.0f - params.get(PARAM_MIX)) * params.get(PARAM_LEVEL) * 0.8f);
+        wetGain = ParameterRamp::constant(params.get(PARAM_MIX) * params.get(PARAM_LEVEL) * 0.8f);
     }
 
     void updateFromControls(const HothouseControls& controls) override {
-        smoothFuzz.setTarget(controls.knobs[KNOB_1]);
-        smoothTone.setTarget(controls.knobs[KNOB_2]);
-        smoothGate.setTarget(controls.knobs[KNOB_3]);
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_FUZZ, controls.knobs[KNOB_1]);
+        params.setTarget(PARAM_TONE, controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_GATE, controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Character mode
         switch (controls.toggles[TOGGLESWITCH_1]) {
@@ -111,50 +173,17 @@ public:
         return 1.0f;
     }
 
-    float process(float inputSample) override {
-        float fuzz = smoothFuzz.process();
-        float tone = smoothTone.process();
-        float gate = smoothGate.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Noise gate
-        float gateThreshold = gate * 0.1f;
-        if (fabsf(inputSample) < gateThreshold) {
-            inputSample = 0.0f;
-        }
-
-        // Heavy pre-gain
-        float amplified = inputSample * (1.0f + fuzz * (MAX_FUZZ_GAIN - 1.0f));
-
-        // Apply clipping based on character
-        float clipped;
-        switch (character) {
-            case 0:  // Vintage
-                clipped = vintageClip(amplified);
-                break;
-            case 1:  // Modern
-                clipped = modernClip(amplified);
-                break;
-            default: // Octave
-                clipped = octaveClip(amplified);
-                break;
-        }
-
-        // Remove DC offset
-        clipped = dcBlock(clipped);
-
-        // Apply tone control
-        float toneAlpha = 0.2f + tone * 0.79f;
-        float toned = lowPass(clipped, toneAlpha);
-
-        // Mix dry/wet and apply level
-        float output = inputSample * (1.0f - mix) + toned * mix;
-        return output * level * 0.8f;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        previousSample = 0.0f;
-        dcBlocker = 0.0f;
+        dcBlocker.reset();
+        toneFilter.reset();
+        clipper.reset();
     }
 };
+
+typedef FuzzT<float> Fuzz;
@@ -16,56 +16,138 @@
 
 #include "hothouse.h"
 
-class Overdrive : public HothouseEffect {
+// Clipping stage antialiasing: oversampling factor 1, 2, 4 or 8, or
+// ADAA_FIRST_ORDER / ADAA_SECOND_ORDER (see ClipStageT)
+#ifndef OVERDRIVE_ANTIALIASING
+#define OVERDRIVE_ANTIALIASING 2
+#endif
+
+template <typename Sample, int Antialiasing = OVERDRIVE_ANTIALIASING>
+class OverdriveT : public HothouseEffectT<Sample> {
 private:
-    // Smoothed parameters
-    ParameterSmoother smoothDrive;
-    ParameterSmoother smoothTone;
-    ParameterSmoother smoothBass;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
-
-    float previousSample;
-    float bassState;
+    typedef SampleTraits<Sample> Traits;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_DRIVE,
+        PARAM_TONE,
+        PARAM_BASS,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
+
+    OnePoleShelfT<Sample> bassShelf;
+    OnePoleT<Sample> toneFilter;
 
     // Voicing mode (0=warm, 1=neutral, 2=bright)
     int voicing;
 
-    // Soft clipping function (tanh approximation)
-    float softClip(float sample, float drive) {
-        float x = sample * (1.0f + drive * 9.0f);
-        // Fast tanh approximation
-        if (x > 1.0f) return 0.76159f;
-        if (x < -1.0f) return -0.76159f;
-        float x2 = x * x;
-        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    // Control-rate coefficients
+    float driveGain;
+    ParameterRamp dryGain;
+    ParameterRamp wetGain;
+
+    // Clipping stage: fast tanh approximation, antialiased
+    typedef ClipStageT<Sample, Antialiasing> Clipper;
+    Clipper clipper;
+
+    // Tone filter coefficient per voicing against the tone knob
+    CoefficientTable<> toneTables[3];
+
+    // Tone filter base coefficient for a voicing, at the reference rate
+    static float getToneBase(int voicing) {
+        switch (voicing) {
+            case 0:  // Warm - more lowpass
+                return 0.3f;
+            case 2:  // Bright - less lowpass
+                return 0.7f;
+            default: // Neutral
+                return 0.5f;
+        }
     }
 
-    // Simple one-pole low-pass filter for tone control
-    float toneLowPass(float sample, float alpha) {
-        float filtered = alpha * sample + (1.0f - alpha) * previousSample;
-        previousSample = filtered;
-        return filtered;
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        float drive = params.get(PARAM_DRIVE);
+        float tone = params.get(PARAM_TONE);
+        float bass = params.get(PARAM_BASS);
+        float level = params.get(PARAM_LEVEL);
+        float mix = params.get(PARAM_MIX);
+
+        // Bass control (low shelf) and drive
+        bassShelf.setGain((bass - 0.5f) * 2.0f);
+        driveGain = 1.0f + drive * 9.0f;
+
+        // Voicing-adjusted tone control
+        toneFilter.setCoefficient(toneTables[voicing](tone));
+
+        // Output gains ramp linearly to the new mix/level
+        dryGain = ParameterRamp::between(dryGain.start, (1.0f - mix) * level, numSamples);
+        wetGain = ParameterRamp::between(wetGain.start, mix * level, numSamples);
+    }
+
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        const float drive = driveGain * clipper.getInputGain(0);
+        const Sample dryStep = Traits::fromFloat(dryGain.increment);
+        const Sample wetStep = Traits::fromFloat(wetGain.increment);
+        Sample dry = Traits::fromFloat(dryGain.start);
+        Sample wet = Traits::fromFloat(wetGain.start);
+        Sample driven[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample alignedDry[HOTHOUSE_MAX_CONTROL_BLOCK];
+        const Sample* dryIn = clipper.alignDry(in, alignedDry, numSamples);
+
+        bassShelf.processBlock(in, driven, numSamples);
+        for (int i = 0; i < numSamples; i++) driven[i] = Traits::scale(driven[i], drive);
+
+        clipper.process(0, driven, numSamples);
+
+        toneFilter.processBlock(driven, numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            dry += dryStep;
+            wet += wetStep;
+            out[i] = dryIn[i] * dry + driven[i] * wet;
+        }
+
+        dryGain.start = Traits::toFloat(dry);
+        wetGain.start = Traits::toFloat(wet);
     }
 
 public:
-    Overdrive(int sampleRate = 48000)
-        : smoothDrive(20.0f, (float)sampleRate, 0.5f),
-          smoothTone(20.0f, (float)sampleRate, 0.7f),
-          smoothBass(20.0f, (float)sampleRate, 0.5f),
-          smoothLevel(20.0f, (float)sampleRate, 0.8f),
-          smoothMix(20.0f, (float)sampleRate, 1.0f) {
-        previousSample = 0.0f;
-        bassState = 0.0f;
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_FAST ? Clipper::arenaBytes() : 0;
+    }
+
+    OverdriveT(int sampleRate = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
+        : params(20.0f, (float)sampleRate) {
+        HothouseArenaMark mark(arena);
+        clipper.init(arena, MEMORY_FAST);
+        this->memoryUsage = mark.since(sizeof(*this));
+        clipper.setVoice(0, ClipCurve::soft(1.0f, 1.0f, 0.76159f), 1.5f);
+        params.setImmediate(PARAM_DRIVE, 0.5f);
+        params.setImmediate(PARAM_TONE, 0.7f);
+        params.setImmediate(PARAM_BASS, 0.5f);
+        params.setImmediate(PARAM_LEVEL, 0.8f);
+        params.setImmediate(PARAM_MIX, 1.0f);
+        bassShelf.setCoefficient(hothouseRescaleOnePole(0.05f, (float)sampleRate));
+        for (int v = 0; v < 3; v++) {
+            float toneBase = getToneBase(v);
+            toneTables[v].buildOnePole(toneBase, (1.0f - toneBase) * 0.98f, (float)sampleRate);
+        }
         voicing = 1;
+        dryGain = ParameterRamp::constant((1.0f - params.get(PARAM_MIX)) * params.get(PARAM_LEVEL));
+        wetGain = ParameterRamp::constant(params.get(PARAM_MIX) * params.get(PARAM_LEVEL));
     }
 
     void updateFromControls(const HothouseControls& controls) override {
-        smoothDrive.setTarget(controls.knobs[KNOB_1]);
-        smoothTone.setTarget(controls.knobs[KNOB_2]);
-        smoothBass.setTarget(controls.knobs[KNOB_3]);
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_DRIVE, controls.knobs[KNOB_1]);
+        params.setTarget(PARAM_TONE, controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_BASS, controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Voicing
         switch (controls.toggles[TOGGLESWITCH_1]) {
@@ -87,45 +169,17 @@ public:
         return 1.0f;
     }
 
-    float process(float inputSample) override {
-        float drive = smoothDrive.process();
-        float tone = smoothTone.process();
-        float bass = smoothBass.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Bass control (low shelf)
-        float bassCoeff = 0.05f;
-        bassState = bassState * (1.0f - bassCoeff) + inputSample * bassCoeff;
-        float bassBoost = (bass - 0.5f) * 2.0f;
-        float sample = inputSample + bassState * bassBoost;
-
-        // Apply overdrive with soft clipping
-        float driven = softClip(sample, drive);
-
-        // Apply voicing-adjusted tone control
-        float toneBase;
-        switch (voicing) {
-            case 0:  // Warm - more lowpass
-                toneBase = 0.3f;
-                break;
-            case 2:  // Bright - less lowpass
-                toneBase = 0.7f;
-                break;
-            default: // Neutral
-                toneBase = 0.5f;
-                break;
-        }
-        float toneAlpha = toneBase + tone * (1.0f - toneBase) * 0.98f;
-        float toned = toneLowPass(driven, toneAlpha);
-
-        // Mix and apply output level
-        float output = inputSample * (1.0f - mix) + toned * mix;
-        return output * level;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        previousSample = 0.0f;
-        bassState = 0.0f;
+        bassShelf.reset();
+        toneFilter.reset();
+        clipper.reset();
     }
 };
+
+typedef OverdriveT<float> Overdrive;
@@ -18,138 +18,294 @@
 
 #define NUM_COMB_FILTERS 4
 #define NUM_ALLPASS_FILTERS 2
-#define MAX_PREDELAY 4800  // 100ms at 48kHz
-
-// Base comb filter delay times (in samples at 48kHz)
+#define MAX_PREDELAY 4800  // 100ms at the reference rate
+
+// Longest comb and allpass delays below, at the reference rate
+#define MAX_COMB_DELAY 1617
+#define MAX_ALLPASS_DELAY 556
+
+// Delay line capacities (powers of two above the longest delay at
+// HOTHOUSE_MAX_SAMPLE_RATE)
+#define COMB_LINE_CAPACITY hothouseNextPowerOfTwo(hothouseMaxRateSamples(MAX_COMB_DELAY))
+#define ALLPASS_LINE_CAPACITY hothouseNextPowerOfTwo(hothouseMaxRateSamples(MAX_ALLPASS_DELAY))
+#define PREDELAY_LINE_CAPACITY \
+    hothouseNextPowerOfTwo(hothouseMaxRateSamples(MAX_PREDELAY) + HOTHOUSE_MAX_CONTROL_BLOCK)
+
+// Base comb filter delay times (in samples at the reference rate), scaled
+// to the running rate at construction. All of them, and the allpass
+// delays, exceed HOTHOUSE_MAX_CONTROL_BLOCK down to 32 kHz, so each filter
+// reads a whole block from its line before writing the block back.
 const int baseCombDelays[NUM_COMB_FILTERS] = {1557, 1617, 1491, 1422};
 const int baseAllpassDelays[NUM_ALLPASS_FILTERS] = {225, 556};
 
+// Feedback comb delay. The damping lowpass in its loop lives in the
+// reverb, which runs all four combs' dampers side by side in one
+// OnePoleLanesT between readBlock() and writeBlock().
+template <typename Sample, typename Storage = Sample>
 class CombFilter {
 private:
-    float* buffer;
-    int bufferSize;
-    int index;
-    float feedback;
-    float damping;
-    float dampState;
+    typedef SampleTraits<Sample> Traits;
+
+    typedef DelayLine<Sample, COMB_LINE_CAPACITY, Storage> Line;
+    Line line;
+    int delay;
+    Sample feedback;
 
 public:
-    CombFilter(int size) : bufferSize(size), index(0), feedback(0.7f), damping(0.5f), dampState(0.0f) {
-        buffer = new float[bufferSize];
-        for (int i = 0; i < bufferSize; i++) buffer[i] = 0.0f;
-    }
+    CombFilter() : delay(1), feedback(Traits::fromFloat(0.7f)) {}
 
-    ~CombFilter() { delete[] buffer; }
+    static constexpr size_t arenaBytes() { return Line::arenaBytes(); }
 
-    void setFeedback(float fb) { feedback = fb; }
-    void setDamping(float d) { damping = d; }
+    void init(HothouseMemoryArena& arena, int size) {
+        delay = size;
+        line.init(arena, MEMORY_FAST);
+    }
 
-    float process(float input) {
-        float output = buffer[index];
+    void setFeedback(float fb) { feedback = Traits::fromFloat(fb); }
 
-        // Apply damping (lowpass in feedback path)
-        dampState = output * (1.0f - damping) + dampState * damping;
+    // Read the comb output for the next block (numSamples <= delay)
+    void readBlock(Sample* delayed, int numSamples) {
+        line.readBlock(delayed, delay, numSamples);
+    }
 
-        buffer[index] = input + dampState * feedback;
-        index = (index + 1) % bufferSize;
-        return output;
+    // Write input plus the damped output, scaled by the feedback
+    void writeBlock(const Sample* input, const Sample* damped, int numSamples) {
+        Sample fed[HOTHOUSE_MAX_CONTROL_BLOCK];
+        for (int i = 0; i < numSamples; i++) fed[i] = input[i] + damped[i] * feedback;
+        line.writeBlock(fed, numSamples);
     }
 
     void clear() {
-        for (int i = 0; i < bufferSize; i++) buffer[i] = 0.0f;
-        index = 0;
-        dampState = 0.0f;
+        line.clear();
     }
 };
 
+template <typename Sample, typename Storage = Sample>
 class AllpassFilter {
 private:
-    float* buffer;
-    int bufferSize;
-    int index;
-    float gain;
+    typedef SampleTraits<Sample> Traits;
+
+    typedef DelayLine<Sample, ALLPASS_LINE_CAPACITY, Storage> Line;
+    Line line;
+    int delay;
+    Sample gain;
 
 public:
-    AllpassFilter(int size) : bufferSize(size), index(0), gain(0.5f) {
-        buffer = new float[bufferSize];
-        for (int i = 0; i < bufferSize; i++) buffer[i] = 0.0f;
-    }
+    AllpassFilter() : delay(1), gain(Traits::fromFloat(0.5f)) {}
 
-    ~AllpassFilter() { delete[] buffer; }
+    static constexpr size_t arenaBytes() { return Line::arenaBytes(); }
 
-    float process(float input) {
-        float bufOut = buffer[index];
-        float output = -input + bufOut;
-        buffer[index] = input + bufOut * gain;
-        index = (index + 1) % bufferSize;
+    void init(HothouseMemoryArena& arena, int size) {
+        delay = size;
+        line.init(arena, MEMORY_FAST);
+    }
+
+    Sample process(Sample input) {
+        Sample bufOut = line.read(delay);
+        Sample output = -input + bufOut;
+        line.write(input + bufOut * gain + Traits::fromFloat(HOTHOUSE_DENORMAL_DC));
         return output;
     }
 
+    // Process a block in place (numSamples <= delay)
+    void processBlock(Sample* samples, int numSamples) {
+        const Sample denormalDc = Traits::fromFloat(HOTHOUSE_DENORMAL_DC);
+        Sample delayed[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample fed[HOTHOUSE_MAX_CONTROL_BLOCK];
+        line.readBlock(delayed, delay, numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            Sample input = samples[i];
+            fed[i] = input + delayed[i] * gain + denormalDc;
+            samples[i] = -input + delayed[i];
+        }
+        line.writeBlock(fed, numSamples);
+    }
+
     void clear() {
-        for (int i = 0; i < bufferSize; i++) buffer[i] = 0.0f;
-        index = 0;
+        line.clear();
     }
 };
 
-class Reverb : public HothouseEffect {
+// Storage is the sample format of every delay buffer (see DelayStorage)
+template <typename Sample, typename Storage = Sample>
+class ReverbT : public HothouseEffectT<Sample> {
 private:
-    CombFilter* combFilters[NUM_COMB_FILTERS];
-    AllpassFilter* allpassFilters[NUM_ALLPASS_FILTERS];
-
-    // Pre-delay buffer
-    float predelayBuffer[MAX_PREDELAY];
-    int predelayWriteIndex;
-
-    // Smoothed parameters
-    ParameterSmoother smoothSize;
-    ParameterSmoother smoothDamping;
-    ParameterSmoother smoothPredelay;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
+    typedef SampleTraits<Sample> Traits;
+
+    CombFilter<Sample, Storage> combFilters[NUM_COMB_FILTERS];
+    OnePoleLanesT<Sample, NUM_COMB_FILTERS, true> combDamping;  // Lowpass in each comb's loop
+    CoefficientTable<> dampingTable;  // Damping knob to comb lowpass pole
+    AllpassFilter<Sample, Storage> allpassFilters[NUM_ALLPASS_FILTERS];
+
+    // Pre-delay (fast memory)
+    typedef DelayLine<Sample, PREDELAY_LINE_CAPACITY, Storage> PredelayLine;
+    PredelayLine predelayLine;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_SIZE,
+        PARAM_DAMPING,
+        PARAM_PREDELAY,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
 
     // Room type (affects feedback and delay scaling)
     int roomType;
     float sizeMultiplier;
 
-public:
-    Reverb(int sampleRate = 48000)
-        : smoothSize(20.0f, (float)sampleRate, 0.5f),
-          smoothDamping(20.0f, (float)sampleRate, 0.5f),
-          smoothPredelay(20.0f, (float)sampleRate, 0.0f),
-          smoothLevel(20.0f, (float)sampleRate, 1.0f),
-          smoothMix(20.0f, (float)sampleRate, 0.3f) {
-        roomType = 1;
-        sizeMultiplier = 1.0f;
-        predelayWriteIndex = 0;
+    // Set when the comb filters need new feedback/damping values
+    bool combParamsDirty;
+
+    // Longest pre-delay at this rate, in samples
+    int maxPredelay;
+
+    // Control-rate coefficients
+    int predelaySamples;
+    ParameterRamp dryGain;
+    ParameterRamp wetGain;
 
-        // Initialize pre-delay buffer
-        for (int i = 0; i < MAX_PREDELAY; i++) {
-            predelayBuffer[i] = 0.0f;
+    // A reference-rate delay at sampleRate, from one block up to limit
+    static int scaledDelay(int referenceSamples, float sampleRate, int limit) {
+        int samples = hothouseSamplesAtRate(referenceSamples, sampleRate);
+        if (samples < HOTHOUSE_MAX_CONTROL_BLOCK) samples = HOTHOUSE_MAX_CONTROL_BLOCK;
+        if (samples > limit) samples = limit;
+        return samples;
+    }
+
+protected:
+    void updateControlRate(int numSamples) override {
+        if (!params.isSettled(PARAM_SIZE) || !params.isSettled(PARAM_DAMPING)) {
+            combParamsDirty = true;
+        }
+        params.processBlock(numSamples);
+        float size = params.get(PARAM_SIZE);
+        float damping = params.get(PARAM_DAMPING);
+        float predelay = params.get(PARAM_PREDELAY);
+        float level = params.get(PARAM_LEVEL);
+        float mix = params.get(PARAM_MIX);
+
+        // Update comb filter parameters only while size/damping move
+        if (combParamsDirty) {
+            float feedback = 0.5f + size * sizeMultiplier * 0.35f;
+            if (feedback > 0.95f) feedback = 0.95f;
+            for (int i = 0; i < NUM_COMB_FILTERS; i++) {
+                combFilters[i].setFeedback(feedback);
+                combDamping.setPole(i, dampingTable(damping));
+            }
+            combParamsDirty = false;
         }
 
-        // Initialize filters
-        for (int i = 0; i < NUM_COMB_FILTERS; i++) {
-            combFilters[i] = new CombFilter(baseCombDelays[i]);
+        predelaySamples = (int)(predelay * maxPredelay);
+        if (predelaySamples < 1) predelaySamples = 1;
+        if (predelaySamples >= maxPredelay) predelaySamples = maxPredelay - 1;
+
+        // Output gains ramp linearly to the new mix/level
+        dryGain = ParameterRamp::between(dryGain.start, 1.0f - mix, numSamples);
+        wetGain = ParameterRamp::between(wetGain.start, level * mix, numSamples);
+    }
+
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        Sample predelayed[HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample wet[HOTHOUSE_MAX_CONTROL_BLOCK];
+
+        // Pre-delay: write the block first so any delay down to one sample works.
+        // The comb input is scaled down before the combs rather than their
+        // sum after, so fixed-point combs keep headroom for resonances.
+        const Sample combScale = Traits::fromFloat(1.0f / NUM_COMB_FILTERS);
+        predelayLine.writeBlock(in, numSamples);
+        predelayLine.readBlock(predelayed, predelaySamples + numSamples, numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            predelayed[i] *= combScale;
+            wet[i] = Sample();
         }
 
+        // Parallel comb filters, one whole block per filter, with their
+        // damping lowpasses run together across the combs
+        Sample delayed[NUM_COMB_FILTERS][HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample damped[NUM_COMB_FILTERS][HOTHOUSE_MAX_CONTROL_BLOCK];
+        Sample* delayedLanes[NUM_COMB_FILTERS];
+        Sample* dampedLanes[NUM_COMB_FILTERS];
+        for (int c = 0; c < NUM_COMB_FILTERS; c++) {
+            combFilters[c].readBlock(delayed[c], numSamples);
+            delayedLanes[c] = delayed[c];
+            dampedLanes[c] = damped[c];
+        }
+        combDamping.processBlock(delayedLanes, dampedLanes, numSamples);
+        for (int c = 0; c < NUM_COMB_FILTERS; c++) {
+            combFilters[c].writeBlock(predelayed, damped[c], numSamples);
+            for (int i = 0; i < numSamples; i++) wet[i] += delayed[c][i];
+        }
+
+        // Series allpass filters
         for (int i = 0; i < NUM_ALLPASS_FILTERS; i++) {
-            allpassFilters[i] = new AllpassFilter(baseAllpassDelays[i]);
+            allpassFilters[i].processBlock(wet, numSamples);
         }
+
+        // Apply level and mix dry/wet
+        const Sample dryStep = Traits::fromFloat(dryGain.increment);
+        const Sample wetStep = Traits::fromFloat(wetGain.increment);
+        Sample dry = Traits::fromFloat(dryGain.start);
+        Sample wetLevel = Traits::fromFloat(wetGain.start);
+        for (int i = 0; i < numSamples; i++) {
+            dry += dryStep;
+            wetLevel += wetStep;
+            out[i] = in[i] * dry + wet[i] * wetLevel;
+        }
+        dryGain.start = Traits::toFloat(dry);
+        wetGain.start = Traits::toFloat(wetLevel);
+    }
+
+public:
+    // Arena bytes per region, see HothouseMemoryFootprint
+    static constexpr size_t arenaBytes(MemoryRegion region) {
+        return region == MEMORY_FAST ? PredelayLine::arenaBytes()
+                                           + NUM_COMB_FILTERS * CombFilter<Sample, Storage>::arenaBytes()
+                                           + NUM_ALLPASS_FILTERS * AllpassFilter<Sample, Storage>::arenaBytes()
+                                     : 0;
     }
 
-    ~Reverb() {
-        for (int i = 0; i < NUM_COMB_FILTERS; i++) delete combFilters[i];
-        for (int i = 0; i < NUM_ALLPASS_FILTERS; i++) delete allpassFilters[i];
+    ReverbT(int sampleRate = 48000, HothouseMemoryArena& arena = hothouseDefaultArena())
+        : params(20.0f, (float)sampleRate) {
+        params.setImmediate(PARAM_SIZE, 0.5f);
+        params.setImmediate(PARAM_DAMPING, 0.5f);
+        params.setImmediate(PARAM_PREDELAY, 0.0f);
+        params.setImmediate(PARAM_LEVEL, 1.0f);
+        params.setImmediate(PARAM_MIX, 0.3f);
+        roomType = 1;
+        sizeMultiplier = 1.0f;
+        combParamsDirty = true;
+        dryGain = ParameterRamp::constant(1.0f - params.get(PARAM_MIX));
+        wetGain = ParameterRamp::constant(params.get(PARAM_LEVEL) * params.get(PARAM_MIX));
+
+        // Delays keep their length in time at any rate
+        const float rate = (float)sampleRate;
+        maxPredelay = scaledDelay(MAX_PREDELAY, rate, PREDELAY_LINE_CAPACITY - HOTHOUSE_MAX_CONTROL_BLOCK);
+        dampingTable.buildPole(0.0f, 1.0f, rate);
+
+        // Buffers come zeroed from the arena
+        HothouseArenaMark mark(arena);
+        predelayLine.init(arena, MEMORY_FAST);
+        for (int i = 0; i < NUM_COMB_FILTERS; i++) {
+            combFilters[i].init(arena, scaledDelay(baseCombDelays[i], rate, COMB_LINE_CAPACITY));
+        }
+        for (int i = 0; i < NUM_ALLPASS_FILTERS; i++) {
+            allpassFilters[i].init(arena, scaledDelay(baseAllpassDelays[i], rate, ALLPASS_LINE_CAPACITY));
+        }
+        this->memoryUsage = mark.since(sizeof(*this));
     }
 
     void updateFromControls(const HothouseControls& controls) override {
-        smoothSize.setTarget(controls.knobs[KNOB_1]);
-        smoothDamping.setTarget(controls.knobs[KNOB_2]);
-        smoothPredelay.setTarget(controls.knobs[KNOB_3]);
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_SIZE, controls.knobs[KNOB_1]);
+        params.setTarget(PARAM_DAMPING, controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_PREDELAY, controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Room type
+        int previousRoomType = roomType;
         switch (controls.toggles[TOGGLESWITCH_1]) {
             case TOGGLESWITCH_UP:
                 roomType = 0;
@@ -166,70 +322,29 @@ public:
             default:
                 break;
         }
+        if (roomType != previousRoomType) combParamsDirty = true;
     }
 
     float getLedState() override {
         return 1.0f;
     }
 
-    float process(float inputSample) override {
-        float size = smoothSize.process();
-        float damping = smoothDamping.process();
-        float predelay = smoothPredelay.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Calculate feedback based on size
-        float feedback = 0.5f + size * sizeMultiplier * 0.35f;
-        if (feedback > 0.95f) feedback = 0.95f;
-
-        // Update comb filter parameters
-        for (int i = 0; i < NUM_COMB_FILTERS; i++) {
-            combFilters[i]->setFeedback(feedback);
-            combFilters[i]->setDamping(damping);
-        }
-
-        // Pre-delay
-        int predelaySamples = (int)(predelay * MAX_PREDELAY);
-        if (predelaySamples < 1) predelaySamples = 1;
-        if (predelaySamples >= MAX_PREDELAY) predelaySamples = MAX_PREDELAY - 1;
-
-        predelayBuffer[predelayWriteIndex] = inputSample;
-        int predelayReadIndex = predelayWriteIndex - predelaySamples;
-        if (predelayReadIndex < 0) predelayReadIndex += MAX_PREDELAY;
-        float predelayedSample = predelayBuffer[predelayReadIndex];
-
-        predelayWriteIndex++;
-        if (predelayWriteIndex >= MAX_PREDELAY) predelayWriteIndex = 0;
-
-        // Parallel comb filters
-        float combOut = 0.0f;
-        for (int i = 0; i < NUM_COMB_FILTERS; i++) {
-            combOut += combFilters[i]->process(predelayedSample);
-        }
-        combOut /= NUM_COMB_FILTERS;
-
-        // Series allpass filters
-        float output = combOut;
-        for (int i = 0; i < NUM_ALLPASS_FILTERS; i++) {
-            output = allpassFilters[i]->process(output);
-        }
-
-        // Apply level and mix dry/wet
-        float wetSignal = output * level;
-        return inputSample * (1.0f - mix) + wetSignal * mix;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
         for (int i = 0; i < NUM_COMB_FILTERS; i++) {
-            combFilters[i]->clear();
+            combFilters[i].clear();
         }
+        combDamping.reset();
         for (int i = 0; i < NUM_ALLPASS_FILTERS; i++) {
-            allpassFilters[i]->clear();
+            allpassFilters[i].clear();
         }
-        for (int i = 0; i < MAX_PREDELAY; i++) {
-            predelayBuffer[i] = 0.0f;
-        }
-        predelayWriteIndex = 0;
+        predelayLine.clear();
     }
 };
+
+typedef ReverbT<float> Reverb;
@@ -17,74 +17,153 @@
 #include "hothouse.h"
 #include <math.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846f
-#endif
-
-class Tremolo : public HothouseEffect {
+template <typename Sample>
+class TremoloT : public HothouseEffectT<Sample> {
 private:
-    // Smoothed parameters
-    ParameterSmoother smoothRate;
-    ParameterSmoother smoothDepth;
-    ParameterSmoother smoothShape;
-    ParameterSmoother smoothLevel;
-    ParameterSmoother smoothMix;
+    typedef SampleTraits<Sample> Traits;
+
+    // Smoothed parameters, indexed into the smoother bank
+    enum Param {
+        PARAM_RATE,
+        PARAM_DEPTH,
+        PARAM_SHAPE,
+        PARAM_LEVEL,
+        PARAM_MIX,
+        PARAM_COUNT
+    };
+    ParameterSmootherBank<PARAM_COUNT> params;
 
-    float phase;
-    float sampleRate;
+    WavetableLfo lfo;
 
     // Mode (0=classic, 1=harmonic, 2=opto)
     int mode;
 
-    // Opto mode smoothing state
+    // Opto mode smoothing state, and its fall and rise poles at this rate
     float optoState;
+    float optoAttack;
+    float optoRelease;
+
+    // Control-rate coefficients
+    float depthAmount;
+    float shapeAmount;
+    ParameterRamp mixGain;
+    ParameterRamp levelGain;
+
+    // Amplitude for a compile-time mode (-1 to 1 LFO in)
+    template <int Mode>
+    float amplitudeFor(float lfo, float depth) {
+        float amplitude;
+        switch (Mode) {
+            case 0:  // Classic - symmetric modulation
+                amplitude = 1.0f - (depth * 0.5f * (1.0f + lfo));
+                break;
+
+            case 1:  // Harmonic - only attenuates, never boosts
+                amplitude = 1.0f - (depth * (lfo + 1.0f) * 0.5f);
+                break;
+
+            default: // Opto - asymmetric response with smoothing
+            {
+                float target = 1.0f - (depth * (lfo + 1.0f) * 0.5f);
+                // Asymmetric smoothing: fast attack, slow release
+                float coeff = target < optoState ? optoAttack : optoRelease;
+                optoState = optoState * coeff + target * (1.0f - coeff) + HOTHOUSE_DENORMAL_DC;
+                amplitude = optoState;
+                break;
+            }
+        }
 
-    // Get LFO value based on shape parameter
-    float getLFO(float shape) {
+        // Constrain amplitude
+        if (amplitude < 0.0f) amplitude = 0.0f;
+        if (amplitude > 1.0f) amplitude = 1.0f;
+        return amplitude;
+    }
+
+    // Inner loop with the mode resolved at compile time
+    template <int Mode>
+    void renderBlock(const Sample* in, Sample* out, int n) {
         // Morph between sine (0), triangle (0.5), and square (1)
-        float sine = sinf(2.0f * M_PI * phase);
-        float triangle = 2.0f * fabsf(2.0f * (phase - floorf(phase + 0.5f))) - 1.0f;
-        float square = phase < 0.5f ? 1.0f : -1.0f;
-
-        if (shape < 0.5f) {
-            // Morph sine to triangle
-            float t = shape * 2.0f;
-            return sine * (1.0f - t) + triangle * t;
+        float modulation[HOTHOUSE_MAX_CONTROL_BLOCK];
+        if (shapeAmount < 0.5f) {
+            lfo.renderMorph(modulation, n, LFO_SINE, LFO_TRIANGLE, shapeAmount * 2.0f);
         } else {
-            // Morph triangle to square
-            float t = (shape - 0.5f) * 2.0f;
-            return triangle * (1.0f - t) + square * t;
+            lfo.renderMorph(modulation, n, LFO_TRIANGLE, LFO_SQUARE, (shapeAmount - 0.5f) * 2.0f);
+        }
+
+        float depth = depthAmount;
+        float mix = mixGain.start;
+        float level = levelGain.start;
+
+        for (int i = 0; i < n; i++) {
+            float amplitude = amplitudeFor<Mode>(modulation[i], depth);
+
+            // (1 - mix + amplitude * mix) * level
+            mix += mixGain.increment;
+            level += levelGain.increment;
+            out[i] = Traits::scale(in[i], (1.0f - mix + amplitude * mix) * level);
+        }
+
+        mixGain.start = mix;
+        levelGain.start = level;
+    }
+
+protected:
+    void updateControlRate(int numSamples) override {
+        params.processBlock(numSamples);
+        lfo.setFrequency(params.get(PARAM_RATE));
+        depthAmount = params.get(PARAM_DEPTH);
+        shapeAmount = params.get(PARAM_SHAPE);
+        mixGain = ParameterRamp::between(mixGain.start, params.get(PARAM_MIX), numSamples);
+        levelGain = ParameterRamp::between(levelGain.start, params.get(PARAM_LEVEL), numSamples);
+    }
+
+    void renderAudioRate(const Sample* in, Sample* out, int numSamples) override {
+        switch (mode) {
+            case 0:
+                renderBlock<0>(in, out, numSamples);
+                break;
+            case 1:
+                renderBlock<1>(in, out, numSamples);
+                break;
+            default:
+                renderBlock<2>(in, out, numSamples);
+                break;
         }
     }
 
 public:
-    Tremolo(int sr = 48000)
-        : sampleRate((float)sr),
-          smoothRate(20.0f, (float)sr, 0.3f),
-          smoothDepth(20.0f, (float)sr, 0.5f),
-          smoothShape(20.0f, (float)sr, 0.0f),
-          smoothLevel(20.0f, (float)sr, 1.0f),
-          smoothMix(20.0f, (float)sr, 1.0f) {
-        phase = 0.0f;
+    TremoloT(int sr = 48000)
+        : params(20.0f, (float)sr),
+          lfo((float)sr) {
+        params.setImmediate(PARAM_RATE, 0.3f);
+        params.setImmediate(PARAM_DEPTH, 0.5f);
+        params.setImmediate(PARAM_SHAPE, 0.0f);
+        params.setImmediate(PARAM_LEVEL, 1.0f);
+        params.setImmediate(PARAM_MIX, 1.0f);
         mode = 0;
         optoState = 1.0f;
+        optoAttack = hothouseRescalePole(0.99f, (float)sr);
+        optoRelease = hothouseRescalePole(0.995f, (float)sr);
+        mixGain = ParameterRamp::constant(params.get(PARAM_MIX));
+        levelGain = ParameterRamp::constant(params.get(PARAM_LEVEL));
+        this->memoryUsage = HothouseMemoryUsage(sizeof(*this));  // No buffers
     }
 
     void updateFromControls(const HothouseControls& controls) override {
         // KNOB_1: Rate (0.5 to 20 Hz)
-        smoothRate.setTarget(0.5f + controls.knobs[KNOB_1] * 19.5f);
+        params.setTarget(PARAM_RATE, 0.5f + controls.knobs[KNOB_1] * 19.5f);
 
         // KNOB_2: Depth
-        smoothDepth.setTarget(controls.knobs[KNOB_2]);
+        params.setTarget(PARAM_DEPTH, controls.knobs[KNOB_2]);
 
         // KNOB_3: Shape
-        smoothShape.setTarget(controls.knobs[KNOB_3]);
+        params.setTarget(PARAM_SHAPE, controls.knobs[KNOB_3]);
 
         // KNOB_4: Level
-        smoothLevel.setTarget(controls.knobs[KNOB_4]);
+        params.setTarget(PARAM_LEVEL, controls.knobs[KNOB_4]);
 
         // KNOB_6: Mix
-        smoothMix.setTarget(controls.knobs[KNOB_6]);
+        params.setTarget(PARAM_MIX, controls.knobs[KNOB_6]);
 
         // TOGGLESWITCH_1: Mode
         switch (controls.toggles[TOGGLESWITCH_1]) {
@@ -104,59 +183,19 @@ public:
 
     float getLedState() override {
         // Pulse LED with tremolo rate
-        float lfo = sinf(2.0f * M_PI * phase);
-        return (lfo + 1.0f) * 0.5f;
+        return (lfo.getValue() + 1.0f) * 0.5f;
     }
 
-    float process(float inputSample) override {
-        float rate = smoothRate.process();
-        float depth = smoothDepth.process();
-        float shape = smoothShape.process();
-        float level = smoothLevel.process();
-        float mix = smoothMix.process();
-
-        // Get LFO value (-1 to 1)
-        float lfo = getLFO(shape);
-
-        // Calculate amplitude modulation based on mode
-        float amplitude;
-
-        switch (mode) {
-            case 0:  // Classic - symmetric modulation
-                amplitude = 1.0f - (depth * 0.5f * (1.0f + lfo));
-                break;
-
-            case 1:  // Harmonic - only attenuates, never boosts
-                amplitude = 1.0f - (depth * (lfo + 1.0f) * 0.5f);
-                break;
-
-            default: // Opto - asymmetric response with smoothing
-            {
-                float target = 1.0f - (depth * (lfo + 1.0f) * 0.5f);
-                // Asymmetric smoothing: fast attack, slow release
-                float coeff = target < optoState ? 0.99f : 0.995f;
-                optoState = optoState * coeff + target * (1.0f - coeff);
-                amplitude = optoState;
-                break;
-            }
-        }
-
-        // Constrain amplitude
-        if (amplitude < 0.0f) amplitude = 0.0f;
-        if (amplitude > 1.0f) amplitude = 1.0f;
-
-        // Update phase
-        phase += rate / sampleRate;
-        if (phase >= 1.0f) phase -= 1.0f;
-
-        // Apply amplitude modulation, mix, and level
-        float modulated = inputSample * amplitude;
-        float output = inputSample * (1.0f - mix) + modulated * mix;
-        return output * level;
+    Sample process(Sample inputSample) override {
+        Sample output;
+        this->processBlock(&inputSample, &output, 1);
+        return output;
     }
 
     void reset() override {
-        phase = 0.0f;
+        lfo.setPhase(0.0f);
         optoState = 1.0f;
     }
 };
+
+typedef TremoloT<float> Tremolo;